@@ -0,0 +1,106 @@
+/*
+ * cAlgorithms.c
+ *
+ * Compiles every C implementation under public/code/<algorithm>/c into one
+ * translation unit. Each file defines its own main(), printArray(), swap()
+ * and so on, so every global name is renamed with a macro before the file
+ * is included and released again afterwards. Sort entry points get the
+ * c_ prefix declared in cAlgorithms.h, helpers get an algorithm prefix.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cAlgorithms.h"
+
+/* bubble */
+#define bubbleSort c_bubbleSort
+#define printArray bubble_printArray
+#define runTests bubble_runTests
+#define main bubble_main
+#include "../../public/code/bubble/c/bubbleSort.c"
+#undef bubbleSort
+#undef printArray
+#undef runTests
+#undef main
+
+/* bucket */
+#define insertionSort bucket_insertionSort
+#define bucketSort c_bucketSort
+#define main bucket_main
+#include "../../public/code/bucket/c/bucketSort.c"
+#undef insertionSort
+#undef bucketSort
+#undef main
+
+/* heap */
+#define swap heap_swap
+#define heapify heap_heapify
+#define buildMaxHeap heap_buildMaxHeap
+#define heapSort c_heapSort
+#define printArray heap_printArray
+#define main heap_main
+#include "../../public/code/heap/c/heapSort.c"
+#undef swap
+#undef heapify
+#undef buildMaxHeap
+#undef heapSort
+#undef printArray
+#undef main
+
+/* insertion */
+#define insertionSort c_insertionSort
+#define printArray insertion_printArray
+#define main insertion_main
+#include "../../public/code/insertion/c/insertionSort.c"
+#undef insertionSort
+#undef printArray
+#undef main
+
+/* merge */
+#define merge merge_merge
+#define mergeSort c_mergeSort
+#define printArray merge_printArray
+#define main merge_main
+#include "../../public/code/merge/c/mergeSort.c"
+#undef merge
+#undef mergeSort
+#undef printArray
+#undef main
+
+/* quick */
+#define swap quick_swap
+#define partition quick_partition
+#define quickSort c_quickSort
+#define printArray quick_printArray
+#define main quick_main
+#include "../../public/code/quick/c/quickSort.c"
+#undef swap
+#undef partition
+#undef quickSort
+#undef printArray
+#undef main
+
+/* radix */
+#define getMax radix_getMax
+#define countingSort radix_countingSort
+#define radixSort c_radixSort
+#define printArray radix_printArray
+#define main radix_main
+#include "../../public/code/radix/c/radixSort.c"
+#undef getMax
+#undef countingSort
+#undef radixSort
+#undef printArray
+#undef main
+
+/* selection */
+#define findMinIndex selection_findMinIndex
+#define selectionSort c_selectionSort
+#define printArray selection_printArray
+#define main selection_main
+#include "../../public/code/selection/c/selectionSort.c"
+#undef findMinIndex
+#undef selectionSort
+#undef printArray
+#undef main
@@ -0,0 +1,30 @@
+/*
+ * cAlgorithms.h
+ *
+ * Entry points of the C implementations under public/code/<algorithm>/c,
+ * renamed with a c_ prefix by cAlgorithms.c so they can be linked next to
+ * the C++ versions.
+ */
+#ifndef SORTVISION_C_ALGORITHMS_H
+#define SORTVISION_C_ALGORITHMS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void c_bubbleSort(int arr[], size_t n);
+void c_bucketSort(float arr[], size_t n, size_t bucketCount);
+void c_heapSort(int arr[], size_t n);
+void c_insertionSort(int arr[], size_t n);
+void c_mergeSort(int arr[], ptrdiff_t left, ptrdiff_t right);
+void c_quickSort(int arr[], ptrdiff_t low, ptrdiff_t high);
+void c_radixSort(int arr[], size_t n);
+void c_selectionSort(int arr[], size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SORTVISION_C_ALGORITHMS_H */
@@ -0,0 +1,422 @@
+/**
+ * sortBench.cpp
+ *
+ * Cross-algorithm throughput benchmark.
+ *
+ * Links every C and C++ implementation under public/code and libsortvision
+ * together with std::sort, std::stable_sort and qsort as baselines, sweeps input sizes
+ * (decades from --min-size to --max-size, up to 10^9) and input
+ * distributions, and reports ns/element over repeated runs as CSV or JSON.
+ *
+ * Timing:
+ *  - Small inputs are sorted in batches of copies so each timed run covers
+ *    at least 2^16 elements and stays well above timer resolution.
+ *  - Copies are prepared outside the timed region.
+ *  - Every run is checked for sortedness; a wrong result aborts the bench.
+ *  - Before each larger size the run time is projected from the previous
+ *    sizes; cells projected to exceed --budget seconds per run are skipped
+ *    (this keeps quadratic algorithms from stalling the sweep).
+ *
+ * Hardware counters:
+ *  - Built with -DSORTVISION_PERF, the per-phase counters from
+ *    perfCounters.hpp (partition, merge, countSort, heapify, ...) are
+ *    printed to stderr after every cell.
+ *
+ * Build (from SortVision/native):
+ *   gcc -O2 -c bench/cAlgorithms.c -o cAlgorithms.o
+ *   gcc -std=c99 -O2 -c lib/sortvision.c -o sortvision.o
+ *   g++ -std=c++17 -O2 -Iinclude -Ilib bench/sortBench.cpp cAlgorithms.o sortvision.o -o sortBench
+ *
+ * Example:
+ *   ./sortBench --max-size 1e8 --dist uniform,sorted --format json
+ */
+
+#include "algorithms.hpp"
+#include "distributions.hpp"
+#include "sortAuto.hpp"
+
+#include "cAlgorithms.h"
+#include "sortvision.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Engine
+{
+    std::string name;
+    std::string language; // "cpp", "c", "lib" or "baseline"
+    bool quadratic;       // O(n^2) on average; used for run-time projection
+    std::function<void(std::vector<int> &)> sortInts;
+    std::function<void(std::vector<float> &)> sortFloats; // set instead of sortInts for float sorts
+};
+
+struct Options
+{
+    size_t minSize = 10;
+    size_t maxSize = 10000000;
+    int warmup = 1;
+    int reps = 5;
+    double budgetSeconds = 2.0;
+    bool json = false;
+    uint64_t seed = 42;
+    std::vector<std::string> algorithms; // empty = all
+    std::vector<sv::Distribution> distributions;
+};
+
+struct Measurement
+{
+    size_t batch = 0;
+    int reps = 0;
+    double minNs = 0;    // best ns/element
+    double medianNs = 0; // median ns/element
+    double secondsPerSort = 0;
+};
+
+int cmpInt(const void *a, const void *b)
+{
+    int x = *static_cast<const int *>(a), y = *static_cast<const int *>(b);
+    return (x > y) - (x < y);
+}
+
+// libsortvision with a scratch buffer reused across runs
+template <typename T>
+void libSort(SvAlgorithm algorithm, std::vector<T> &a)
+{
+    static std::vector<char> scratch;
+    size_t bytes = std::is_same<T, float>::value ? svScratchSizeFloat(algorithm, a.size())
+                                                 : svScratchSizeInt32(algorithm, a.size());
+    if (scratch.size() < bytes)
+        scratch.resize(bytes);
+    int status;
+    if constexpr (std::is_same<T, float>::value)
+        status = svSortFloat(algorithm, a.data(), a.size(), scratch.data(), scratch.size());
+    else
+        status = svSortInt32(algorithm, a.data(), a.size(), scratch.data(), scratch.size());
+    if (status != SV_OK)
+    {
+        std::cerr << "error: libsortvision: " << svStatusString(status) << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+std::vector<Engine> makeEngines()
+{
+    std::vector<Engine> engines = {
+        {"std::sort", "baseline", false, [](std::vector<int> &a) { std::sort(a.begin(), a.end()); }, nullptr},
+        {"std::stable_sort", "baseline", false, [](std::vector<int> &a) { std::stable_sort(a.begin(), a.end()); }, nullptr},
+        {"qsort", "baseline", false, [](std::vector<int> &a) { std::qsort(a.data(), a.size(), sizeof(int), cmpInt); }, nullptr},
+
+        {"bubble", "cpp", true, [](std::vector<int> &a) { sv::bubbleSort(a); }, nullptr},
+        {"bucket", "cpp", false, nullptr, [](std::vector<float> &a) { sv::bucketSort(a); }},
+        {"heap", "cpp", false, [](std::vector<int> &a) { sv::heapSort(a); }, nullptr},
+        {"insertion", "cpp", true, [](std::vector<int> &a) { sv::insertionSort(a); }, nullptr},
+        {"merge", "cpp", false, [](std::vector<int> &a) { sv::mergeSort(a); }, nullptr},
+        {"quick", "cpp", false, [](std::vector<int> &a) { sv::quickSort(a); }, nullptr},
+        {"radix", "cpp", false, [](std::vector<int> &a) { sv::radixSort(a); }, nullptr},
+        {"selection", "cpp", true, [](std::vector<int> &a) { sv::selectionSort(a); }, nullptr},
+        {"auto", "cpp", false, [](std::vector<int> &a) { sv::sortAuto(a); }, nullptr},
+
+        {"bubble", "c", true, [](std::vector<int> &a) { c_bubbleSort(a.data(), a.size()); }, nullptr},
+        {"bucket", "c", false, nullptr, [](std::vector<float> &a) { c_bucketSort(a.data(), a.size(), a.size()); }},
+        {"heap", "c", false, [](std::vector<int> &a) { c_heapSort(a.data(), a.size()); }, nullptr},
+        {"insertion", "c", true, [](std::vector<int> &a) { c_insertionSort(a.data(), a.size()); }, nullptr},
+        {"merge", "c", false, [](std::vector<int> &a) { c_mergeSort(a.data(), 0, static_cast<ptrdiff_t>(a.size()) - 1); }, nullptr},
+        {"quick", "c", false, [](std::vector<int> &a) { c_quickSort(a.data(), 0, static_cast<ptrdiff_t>(a.size()) - 1); }, nullptr},
+        {"radix", "c", false, [](std::vector<int> &a) { c_radixSort(a.data(), a.size()); }, nullptr},
+        {"selection", "c", true, [](std::vector<int> &a) { c_selectionSort(a.data(), a.size()); }, nullptr},
+
+        {"bubble", "lib", true, [](std::vector<int> &a) { libSort(SV_ALGO_BUBBLE, a); }, nullptr},
+        {"bucket", "lib", false, nullptr, [](std::vector<float> &a) { libSort(SV_ALGO_BUCKET, a); }},
+        {"heap", "lib", false, [](std::vector<int> &a) { libSort(SV_ALGO_HEAP, a); }, nullptr},
+        {"insertion", "lib", true, [](std::vector<int> &a) { libSort(SV_ALGO_INSERTION, a); }, nullptr},
+        {"merge", "lib", false, [](std::vector<int> &a) { libSort(SV_ALGO_MERGE, a); }, nullptr},
+        {"quick", "lib", false, [](std::vector<int> &a) { libSort(SV_ALGO_QUICK, a); }, nullptr},
+        {"radix", "lib", false, [](std::vector<int> &a) { libSort(SV_ALGO_RADIX, a); }, nullptr},
+        {"selection", "lib", true, [](std::vector<int> &a) { libSort(SV_ALGO_SELECTION, a); }, nullptr},
+    };
+    return engines;
+}
+
+template <typename T>
+void verifySorted(const std::vector<T> &a, const Engine &e, sv::Distribution d)
+{
+    bool sorted;
+    if constexpr (std::is_same_v<T, int>)
+        sorted = sv::simd::isSorted(a.data(), a.size());
+    else
+        sorted = std::is_sorted(a.begin(), a.end());
+    if (!sorted)
+    {
+        std::cerr << "error: " << e.language << "/" << e.name << " produced unsorted output on "
+                  << sv::distributionName(d) << " n=" << a.size() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Times one (engine, input) cell.
+ * Runs opts.warmup untimed passes, then up to opts.reps timed passes,
+ * fewer if a single pass would blow the time budget.
+ */
+template <typename T>
+Measurement measure(const Engine &e, const std::function<void(std::vector<T> &)> &sortFn,
+                    const std::vector<T> &input, sv::Distribution d, const Options &opts)
+{
+    const size_t n = input.size();
+    Measurement m;
+    m.batch = std::max<size_t>(1, (size_t(1) << 16) / std::max<size_t>(1, n));
+
+    std::vector<std::vector<T>> copies;
+    auto runOnce = [&]() {
+        copies.assign(m.batch, input);
+        auto start = Clock::now();
+        for (auto &copy : copies)
+            sortFn(copy);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        for (const auto &copy : copies)
+            verifySorted(copy, e, d);
+        return seconds;
+    };
+
+    double lastSeconds = 0;
+    for (int w = 0; w < opts.warmup; ++w)
+        lastSeconds = runOnce();
+
+    int reps = opts.reps;
+    if (lastSeconds > 0)
+        reps = std::max(1, std::min(reps, static_cast<int>(opts.budgetSeconds / lastSeconds)));
+
+    std::vector<double> nsPerElement;
+    for (int r = 0; r < reps; ++r)
+        nsPerElement.push_back(runOnce() * 1e9 / static_cast<double>(m.batch * std::max<size_t>(1, n)));
+
+    std::sort(nsPerElement.begin(), nsPerElement.end());
+    m.reps = reps;
+    m.minNs = nsPerElement.front();
+    m.medianNs = nsPerElement[nsPerElement.size() / 2];
+    m.secondsPerSort = m.medianNs * static_cast<double>(n) * 1e-9;
+    return m;
+}
+
+/**
+ * Projects the run time at size `next` from previous measurements.
+ * Uses the growth exponent observed between the last two sizes
+ * (clamped to [1, 2]); with a single point, assumes n^2 for quadratic
+ * engines and n for the rest.
+ */
+double projectSeconds(const std::vector<std::pair<size_t, double>> &history, size_t next, bool quadratic)
+{
+    if (history.empty())
+        return 0;
+    auto [n1, t1] = history.back();
+    double exponent = quadratic ? 2.0 : 1.0;
+    if (history.size() >= 2)
+    {
+        auto [n0, t0] = history[history.size() - 2];
+        if (t0 > 0 && t1 > 0 && n1 > n0)
+            exponent = std::log(t1 / t0) / std::log(static_cast<double>(n1) / n0);
+        exponent = std::clamp(exponent, 1.0, 2.0);
+    }
+    return t1 * std::pow(static_cast<double>(next) / n1, exponent);
+}
+
+class Reporter
+{
+public:
+    explicit Reporter(bool json) : json(json)
+    {
+        if (json)
+            std::cout << "[\n";
+        else
+            std::cout << "engine,language,distribution,size,batch,reps,min_ns_per_element,median_ns_per_element\n";
+    }
+
+    ~Reporter()
+    {
+        if (json)
+            std::cout << "\n]\n";
+    }
+
+    void row(const Engine &e, sv::Distribution d, size_t n, const Measurement &m)
+    {
+        if (json)
+        {
+            std::cout << (first ? "" : ",\n") << "  {\"engine\": \"" << e.name << "\", \"language\": \"" << e.language
+                      << "\", \"distribution\": \"" << sv::distributionName(d) << "\", \"size\": " << n
+                      << ", \"batch\": " << m.batch << ", \"reps\": " << m.reps
+                      << ", \"min_ns_per_element\": " << m.minNs
+                      << ", \"median_ns_per_element\": " << m.medianNs << "}";
+        }
+        else
+        {
+            std::cout << e.name << ',' << e.language << ',' << sv::distributionName(d) << ',' << n << ','
+                      << m.batch << ',' << m.reps << ',' << m.minNs << ',' << m.medianNs << '\n';
+        }
+        std::cout.flush();
+        first = false;
+    }
+
+private:
+    bool json;
+    bool first = true;
+};
+
+std::vector<std::string> splitList(const std::string &s)
+{
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            out.push_back(item);
+    return out;
+}
+
+void printUsage(const char *prog)
+{
+    std::cerr << "Usage: " << prog << " [options]\n"
+              << "  --min-size N      smallest input size (default 10)\n"
+              << "  --max-size N      largest input size, e.g. 1e9 (default 1e7)\n"
+              << "  --dist a,b,...    distributions: uniform, sorted, reversed, organ-pipe,\n"
+              << "                    few-unique, zipf, nearly-sorted (default all)\n"
+              << "  --algo a,b,...    engines by name, e.g. quick,std::sort (default all)\n"
+              << "  --warmup N        untimed runs per cell (default 1)\n"
+              << "  --reps N          timed runs per cell (default 5)\n"
+              << "  --budget S        max seconds per timed run before a cell is skipped (default 2)\n"
+              << "  --seed N          input generator seed (default 42)\n"
+              << "  --format csv|json output format (default csv)\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc)
+                throw std::invalid_argument("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--min-size")
+            opts.minSize = static_cast<size_t>(std::stod(value()));
+        else if (arg == "--max-size")
+            opts.maxSize = static_cast<size_t>(std::stod(value()));
+        else if (arg == "--warmup")
+            opts.warmup = std::stoi(value());
+        else if (arg == "--reps")
+            opts.reps = std::max(1, std::stoi(value()));
+        else if (arg == "--budget")
+            opts.budgetSeconds = std::stod(value());
+        else if (arg == "--seed")
+            opts.seed = std::stoull(value());
+        else if (arg == "--algo")
+            opts.algorithms = splitList(value());
+        else if (arg == "--format")
+            opts.json = value() == "json";
+        else if (arg == "--dist")
+        {
+            for (const std::string &name : splitList(value()))
+            {
+                sv::Distribution d;
+                if (!sv::parseDistribution(name, d))
+                    throw std::invalid_argument("unknown distribution " + name);
+                opts.distributions.push_back(d);
+            }
+        }
+        else
+            return false;
+    }
+    if (opts.distributions.empty())
+        opts.distributions = sv::allDistributions();
+    return opts.minSize >= 1 && opts.minSize <= opts.maxSize;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    try
+    {
+        if (!parseOptions(argc, argv, opts))
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "error: " << ex.what() << "\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<size_t> sizes;
+    for (size_t n = opts.minSize; n <= opts.maxSize; n *= 10)
+    {
+        sizes.push_back(n);
+        if (n > opts.maxSize / 10)
+            break;
+    }
+
+    std::vector<Engine> engines = makeEngines();
+    Reporter reporter(opts.json);
+
+    for (sv::Distribution d : opts.distributions)
+    {
+        std::vector<std::vector<std::pair<size_t, double>>> history(engines.size());
+        std::vector<bool> skipped(engines.size(), false);
+
+        for (size_t n : sizes)
+        {
+            std::vector<int> input = sv::generateInput(d, n, opts.seed);
+            std::vector<float> floatInput(input.begin(), input.end());
+
+            for (size_t e = 0; e < engines.size(); ++e)
+            {
+                const Engine &engine = engines[e];
+                if (!opts.algorithms.empty() &&
+                    std::find(opts.algorithms.begin(), opts.algorithms.end(), engine.name) == opts.algorithms.end())
+                    continue;
+                if (skipped[e])
+                    continue;
+
+                double projected = projectSeconds(history[e], n, engine.quadratic);
+                if (projected > opts.budgetSeconds)
+                {
+                    std::cerr << "skip: " << engine.language << "/" << engine.name << " on "
+                              << sv::distributionName(d) << " from n=" << n << " (projected "
+                              << projected << " s per run)\n";
+                    skipped[e] = true;
+                    continue;
+                }
+
+                sv::perf::reset();
+                Measurement m = engine.sortInts
+                                    ? measure<int>(engine, engine.sortInts, input, d, opts)
+                                    : measure<float>(engine, engine.sortFloats, floatInput, d, opts);
+                history[e].emplace_back(n, m.secondsPerSort);
+                reporter.row(engine, d, n, m);
+
+                if (sv::perf::enabled())
+                {
+                    std::cerr << "# " << engine.language << "/" << engine.name << " "
+                              << sv::distributionName(d) << " n=" << n << "\n";
+                    sv::perf::report(std::cerr);
+                }
+            }
+        }
+    }
+    return 0;
+}
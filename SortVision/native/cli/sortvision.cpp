@@ -0,0 +1,684 @@
+/**
+ * sortvision.cpp
+ *
+ * Command-line sorter for files of integers.
+ *
+ *   sortvision [options] [input]      (stdin when no input file is given)
+ *   sortvision --merge [options] a.svpk b.svpk ...
+ *
+ * Pipeline:
+ *  - Input: regular files are mmap'ed (read-only, sequential advice);
+ *    pipes are read into memory.
+ *  - Text input is parsed in parallel chunks with std::from_chars
+ *    (textIo.hpp); binary input is native-endian int32.
+ *  - Any implementation can sort the keys (--algo, default auto).
+ *  - Text output is formatted in parallel with a two-digits-per-step
+ *    integer formatter into per-thread buffers, which go out with a
+ *    single writev() per IOV_MAX buffers; binary output is written
+ *    straight from the sorted array.
+ *  - --huge-pages thp|hugetlb backs the key array and the sorts' scratch
+ *    memory with 2 MiB pages (hugePages.hpp).
+ *  - --packed-out writes delta-coded, bit-packed blocks (packedInts.hpp).
+ *    Packed input is recognized by its magic and decoded in parallel.
+ *  - --merge streams a k-way merge of sorted packed files to the output
+ *    without loading them: one decoded block per input at a time.
+ *  - --memory-budget sorts within a byte budget (budgetSort.hpp): an
+ *    in-place radix sort with as large an LSD buffer as fits, or an
+ *    external sort through packed runs in a temporary file.
+ *  - --unique and --count emit each distinct key once (with its count).
+ *    Radix and merge sort (and auto) fold duplicates while producing
+ *    the sorted order (sortGroup.hpp); other algorithms sort first and
+ *    fold afterwards.
+ *
+ * Build (from SortVision/native):
+ *   g++ -std=c++17 -O2 -pthread -Iinclude cli/sortvision.cpp -o sortvision
+ *
+ * Example:
+ *   ./sortvision --algo radix --stats numbers.txt -o sorted.txt
+ */
+
+#include "algorithms.hpp"
+#include "budgetSort.hpp"
+#include "numaSort.hpp"
+#include "packedInts.hpp"
+#include "parallelSort.hpp"
+#include "sortAuto.hpp"
+#include "textIo.hpp"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    std::string algorithm = "auto";
+    std::string input;  // empty = stdin
+    std::vector<std::string> inputs; // every positional argument (several with --merge)
+    std::string output; // empty = stdout
+    bool binaryIn = false;
+    bool binaryOut = false;
+    bool packedOut = false;
+    bool merge = false;
+    bool unique = false;
+    bool count = false; // "key count" lines
+    bool stats = false;
+    size_t memoryBudget = 0; // bytes, 0 = unlimited
+    unsigned threads = 0;
+    sv::huge::Mode hugePages = sv::huge::defaultMode();
+};
+
+const std::map<std::string, std::function<void(std::vector<int> &, unsigned)>> &algorithms()
+{
+    static const std::map<std::string, std::function<void(std::vector<int> &, unsigned)>> table = {
+        {"auto", [](std::vector<int> &a, unsigned) { sv::sortAuto(a); }},
+        {"bubble", [](std::vector<int> &a, unsigned) { sv::bubbleSort(a); }},
+        {"heap", [](std::vector<int> &a, unsigned) { sv::heapSort(a); }},
+        {"insertion", [](std::vector<int> &a, unsigned) { sv::insertionSort(a); }},
+        {"merge", [](std::vector<int> &a, unsigned) { sv::mergeSort(a); }},
+        {"quick", [](std::vector<int> &a, unsigned) { sv::quickSort(a); }},
+        {"radix", [](std::vector<int> &a, unsigned) { sv::radixSort(a); }},
+        {"selection", [](std::vector<int> &a, unsigned) { sv::selectionSort(a); }},
+        {"parallel", [](std::vector<int> &a, unsigned threads) {
+             sv::parallel::parallelSort(a.data(), a.size(), sv::parallel::introKernel, threads);
+         }},
+        {"numa", [](std::vector<int> &a, unsigned) { sv::numa::parallelSortNuma(a.data(), a.size()); }},
+    };
+    return table;
+}
+
+/**
+ * Read-only view of the input: an mmap of a regular file, or a copy of
+ * a pipe's contents.
+ */
+class InputView
+{
+public:
+    bool open(const std::string &path)
+    {
+        fd = path.empty() ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+        {
+            size = static_cast<size_t>(st.st_size);
+            if (size == 0)
+                return true;
+            void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+                return false;
+            madvise(p, size, MADV_SEQUENTIAL);
+            madvise(p, size, MADV_WILLNEED);
+            mapped = static_cast<char *>(p);
+            return true;
+        }
+        char chunk[1 << 16];
+        for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) != 0;)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                return false;
+            copy.insert(copy.end(), chunk, chunk + n);
+        }
+        size = copy.size();
+        return true;
+    }
+
+    ~InputView()
+    {
+        if (mapped != nullptr)
+            munmap(mapped, size);
+        if (fd > STDIN_FILENO)
+            ::close(fd);
+    }
+
+    const char *data() const { return mapped != nullptr ? mapped : copy.data(); }
+    size_t bytes() const { return size; }
+
+private:
+    int fd = -1;
+    char *mapped = nullptr;
+    std::vector<char> copy;
+    size_t size = 0;
+};
+
+/** Writes every buffer, at most IOV_MAX per writev() call. */
+bool writeAll(int fd, std::vector<iovec> parts)
+{
+    size_t first = 0;
+    while (first < parts.size())
+    {
+        if (parts[first].iov_len == 0)
+        {
+            ++first;
+            continue;
+        }
+        int count = static_cast<int>(std::min<size_t>(parts.size() - first, IOV_MAX));
+        ssize_t n = ::writev(fd, &parts[first], count);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        // Skip what was written, possibly stopping inside a buffer
+        for (size_t done = static_cast<size_t>(n); done > 0;)
+        {
+            size_t step = std::min(done, parts[first].iov_len);
+            parts[first].iov_base = static_cast<char *>(parts[first].iov_base) + step;
+            parts[first].iov_len -= step;
+            done -= step;
+            if (parts[first].iov_len == 0)
+                ++first;
+        }
+    }
+    return true;
+}
+
+void printUsage(const char *prog)
+{
+    std::cerr << "Usage: " << prog << " [options] [input]\n"
+              << "       " << prog << " --merge [options] sorted.svpk ...\n"
+              << "  --algo NAME        auto (default), quick, merge, heap, radix, insertion,\n"
+              << "                     selection, bubble, parallel, numa\n"
+              << "  --binary           input and output are native-endian int32\n"
+              << "  --binary-in        input is native-endian int32\n"
+              << "  --binary-out       output is native-endian int32\n"
+              << "  --packed-out       output is delta-coded, bit-packed blocks (packed input\n"
+              << "                     is detected automatically)\n"
+              << "  --merge            k-way merge of sorted packed inputs, without sorting\n"
+              << "  --unique           output each distinct key once\n"
+              << "  --count            output \"key count\" lines, one per distinct key (text only)\n"
+              << "  --memory-budget SIZE\n"
+              << "                     sort within SIZE bytes (K, M or G suffix, at least 4M),\n"
+              << "                     externally through a temporary file ($TMPDIR) if needed\n"
+              << "  --threads N        threads for parsing, formatting and --algo parallel\n"
+              << "  --huge-pages MODE  off, thp or hugetlb: back the keys and scratch memory\n"
+              << "                     with 2 MiB pages (default $SORTVISION_HUGEPAGES or off)\n"
+              << "  -o FILE            output file (default stdout)\n"
+              << "  --stats            print phase timings to stderr\n";
+}
+
+/** "64M", "1G", "500000": binary suffixes K, M and G. */
+size_t parseBytes(const std::string &text)
+{
+    // stoull would take "-1" as 2^64 - 1, and 0 means "no budget"
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])))
+        throw std::invalid_argument("bad size " + text);
+    size_t end = 0;
+    unsigned long long value = std::stoull(text, &end);
+    size_t unit = end + 1 == text.size() ? std::string("KMG").find(static_cast<char>(std::toupper(static_cast<unsigned char>(text[end])))) : std::string::npos;
+    if (end != text.size() && unit == std::string::npos)
+        throw std::invalid_argument("bad size " + text);
+    int shift = end == text.size() ? 0 : 10 * static_cast<int>(unit + 1);
+    if (value == 0 || value > (~0ull >> shift))
+        throw std::invalid_argument("bad size " + text);
+    return static_cast<size_t>(value << shift);
+}
+
+bool parseOptions(int argc, char **argv, Options &opt)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc)
+                throw std::invalid_argument("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--algo")
+            opt.algorithm = value();
+        else if (arg == "--binary")
+            opt.binaryIn = opt.binaryOut = true;
+        else if (arg == "--binary-in")
+            opt.binaryIn = true;
+        else if (arg == "--binary-out")
+            opt.binaryOut = true;
+        else if (arg == "--packed-out")
+            opt.packedOut = true;
+        else if (arg == "--merge")
+            opt.merge = true;
+        else if (arg == "--unique")
+            opt.unique = true;
+        else if (arg == "--count")
+            opt.count = true;
+        else if (arg == "--memory-budget")
+            opt.memoryBudget = parseBytes(value());
+        else if (arg == "--threads")
+            opt.threads = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--huge-pages")
+        {
+            if (!sv::huge::parseMode(value().c_str(), opt.hugePages))
+                return false;
+        }
+        else if (arg == "-o")
+            opt.output = value();
+        else if (arg == "--stats")
+            opt.stats = true;
+        else if (!arg.empty() && arg[0] == '-' && arg != "-")
+            return false;
+        else
+            opt.inputs.push_back(arg == "-" ? "" : arg);
+    }
+    if (opt.binaryOut && opt.packedOut)
+        return false;
+    if (opt.count && (opt.unique || opt.binaryOut || opt.packedOut))
+        return false;
+    if (opt.merge && (opt.unique || opt.count))
+        return false;
+    // The budget picks its own engine and streams; grouping would need the whole input
+    if (opt.memoryBudget != 0 && (opt.merge || opt.unique || opt.count || opt.algorithm != "auto"))
+        return false;
+    if (opt.merge)
+        return !opt.inputs.empty();
+    if (opt.inputs.size() > 1)
+        return false;
+    if (!opt.inputs.empty())
+        opt.input = opt.inputs[0];
+    return algorithms().count(opt.algorithm) != 0;
+}
+
+int openOutput(const std::string &path)
+{
+    return path.empty() ? STDOUT_FILENO : ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+}
+
+/**
+ * --unique / --count: keys becomes its distinct keys in ascending order,
+ * with their multiplicities in counts for --count.
+ */
+void groupKeys(const Options &opt, std::vector<int> &keys, std::vector<size_t> &counts)
+{
+    if (opt.algorithm == "radix")
+    {
+        if (opt.count)
+            counts = sv::radixSortCounts(keys);
+        else
+            sv::radixSortUnique(keys);
+        return;
+    }
+    if (opt.algorithm == "merge" || opt.algorithm == "auto")
+    {
+        if (opt.count)
+            counts = sv::mergeSortCounts(keys);
+        else
+            sv::mergeSortUnique(keys);
+        return;
+    }
+    algorithms().at(opt.algorithm)(keys, opt.threads);
+    sv::group::Emitter out(keys.data(), opt.count ? &counts : nullptr);
+    out.add(keys.data(), keys.size());
+    keys.resize(out.size());
+}
+
+/**
+ * Sorted keys arriving in pieces (--merge, --memory-budget), written as
+ * they come: packed blocks through an Encoder, binary as is, text in
+ * batches large enough to format on every thread. Closes fd on finish()
+ * unless it is stdout.
+ */
+class StreamWriter
+{
+public:
+    StreamWriter(const Options &opt, int fd) : opt(opt), fd(fd)
+    {
+        if (opt.packedOut)
+            encoder = std::make_unique<sv::packed::Encoder>([this](const uint8_t *p, size_t n) { write(p, n); });
+    }
+
+    void add(const int *keys, size_t n)
+    {
+        total += n;
+        if (encoder)
+            return encoder->append(keys, n);
+        batch.insert(batch.end(), keys, keys + n);
+        if (batch.size() >= (size_t(1) << 20))
+            flush();
+    }
+
+    /** @return false when a write failed (errno is set) */
+    bool finish()
+    {
+        if (encoder)
+            encoder->finish();
+        else
+            flush();
+        if (fd != STDOUT_FILENO)
+            written = ::close(fd) == 0 && written;
+        return written;
+    }
+
+    uint64_t count() const { return total; }
+
+private:
+    const Options &opt;
+    int fd;
+    bool written = true;
+    uint64_t total = 0;
+    std::unique_ptr<sv::packed::Encoder> encoder;
+    std::vector<int> batch;
+
+    void write(const void *p, size_t n) { written = written && writeAll(fd, {{const_cast<void *>(p), n}}); }
+
+    void flush()
+    {
+        if (opt.binaryOut)
+        {
+            write(batch.data(), batch.size() * sizeof(int));
+        }
+        else
+        {
+            std::vector<std::string> text = sv::textio::formatInts(batch.data(), batch.size(), opt.threads);
+            std::vector<iovec> parts;
+            for (std::string &t : text)
+                parts.push_back({&t[0], t.size()});
+            written = written && writeAll(fd, std::move(parts));
+        }
+        batch.clear();
+    }
+};
+
+/** --merge: streams the k-way merge of sorted packed inputs to the output. */
+int runMerge(const Options &opt)
+{
+    auto t0 = Clock::now();
+    std::vector<std::unique_ptr<InputView>> views;
+    std::vector<sv::packed::Reader> readers;
+    for (const std::string &path : opt.inputs)
+    {
+        views.push_back(std::make_unique<InputView>());
+        const char *name = path.empty() ? "stdin" : path.c_str();
+        if (!views.back()->open(path))
+        {
+            std::cerr << "error: cannot read " << name << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        try
+        {
+            readers.emplace_back(views.back()->data(), views.back()->bytes());
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << "error: " << name << ": " << ex.what() << "\n";
+            return 1;
+        }
+    }
+
+    int out = openOutput(opt.output);
+    if (out < 0)
+    {
+        std::cerr << "error: cannot write " << opt.output << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    StreamWriter writer(opt, out);
+    sv::packed::mergeStreams(readers, [&](const int *keys, size_t n) { writer.add(keys, n); });
+    if (!writer.finish())
+    {
+        std::cerr << "error: write failed: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    if (opt.stats)
+        std::cerr << writer.count() << " keys merged from " << readers.size() << " streams in "
+                  << std::chrono::duration<double>(Clock::now() - t0).count() << " s\n";
+    return 0;
+}
+
+/**
+ * --memory-budget: sorts through sv::budget::sortStream, reading the
+ * input a chunk at a time and streaming the sorted keys to the output.
+ * The budget covers the sort's own memory; the mapped input file and
+ * the output batches are outside it.
+ */
+int runBudget(const Options &opt, InputView &input)
+{
+    auto t0 = Clock::now();
+    const char *begin = input.data(), *end = begin + input.bytes();
+    sv::budget::Source read;
+    size_t hint = 0;
+    std::unique_ptr<sv::packed::Reader> packedIn;
+    int block[sv::packed::kBlockSize];
+    size_t blockPos = 0, blockKeys = 0;
+    const char *cursor = begin;
+    sv::textio::ParseError parseError;
+    try
+    {
+        if (sv::packed::isPacked(begin, input.bytes()))
+        {
+            packedIn = std::make_unique<sv::packed::Reader>(begin, input.bytes());
+            hint = packedIn->count();
+            read = [&](int *keys, size_t capacity) {
+                size_t n = 0;
+                while (n < capacity)
+                {
+                    if (blockPos == blockKeys)
+                    {
+                        blockKeys = packedIn->next(block);
+                        blockPos = 0;
+                        if (blockKeys == 0)
+                            break;
+                    }
+                    size_t take = std::min(capacity - n, blockKeys - blockPos);
+                    std::copy(block + blockPos, block + blockPos + take, keys + n);
+                    blockPos += take;
+                    n += take;
+                }
+                return n;
+            };
+        }
+        else if (opt.binaryIn)
+        {
+            if (input.bytes() % sizeof(int) != 0)
+            {
+                std::cerr << "error: binary input size is not a multiple of 4 bytes\n";
+                return 1;
+            }
+            hint = input.bytes() / sizeof(int);
+            read = [&](int *keys, size_t capacity) {
+                size_t n = std::min(capacity, static_cast<size_t>(end - cursor) / sizeof(int));
+                std::memcpy(keys, cursor, n * sizeof(int));
+                cursor += n * sizeof(int);
+                return n;
+            };
+        }
+        else
+        {
+            hint = sv::textio::countTokens(begin, end);
+            read = [&](int *keys, size_t capacity) {
+                size_t n = sv::textio::parseSome(begin, cursor, end, keys, capacity, parseError);
+                if (parseError.failed)
+                    throw std::runtime_error("bad integer at byte " + std::to_string(parseError.offset));
+                return n;
+            };
+        }
+
+        int out = openOutput(opt.output);
+        if (out < 0)
+        {
+            std::cerr << "error: cannot write " << opt.output << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        StreamWriter writer(opt, out);
+        sv::budget::Report report = sv::budget::sortStream(
+            read, [&](const int *keys, size_t n) { writer.add(keys, n); }, opt.memoryBudget, hint);
+        if (!writer.finish())
+        {
+            std::cerr << "error: write failed: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        if (opt.stats)
+        {
+            rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            std::cerr << report << "\n"
+                      << "  " << std::chrono::duration<double>(Clock::now() - t0).count()
+                      << " s, process max RSS " << usage.ru_maxrss << " KiB (includes mapped input)\n";
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "error: " << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    try
+    {
+        if (!parseOptions(argc, argv, opt))
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "error: " << ex.what() << "\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Before any workspace exists, so every sorting thread picks it up
+    sv::huge::setDefaultMode(opt.hugePages);
+    if (opt.merge)
+        return runMerge(opt);
+
+    auto t0 = Clock::now();
+    InputView input;
+    if (!input.open(opt.input))
+    {
+        std::cerr << "error: cannot read " << (opt.input.empty() ? "stdin" : opt.input) << ": "
+                  << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    if (opt.memoryBudget != 0)
+        return runBudget(opt, input);
+
+    std::vector<int> keys;
+    if (sv::packed::isPacked(input.data(), input.bytes()))
+    {
+        try
+        {
+            sv::packed::Reader reader(input.data(), input.bytes());
+            keys.resize(reader.count());
+            sv::packed::decode(reader, keys.data(), opt.threads);
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << "error: " << ex.what() << "\n";
+            return 1;
+        }
+    }
+    else if (opt.binaryIn)
+    {
+        if (input.bytes() % sizeof(int) != 0)
+        {
+            std::cerr << "error: binary input size is not a multiple of 4 bytes\n";
+            return 1;
+        }
+        // Advise before the first touch so the copy faults in huge pages
+        keys.reserve(input.bytes() / sizeof(int));
+        if (opt.hugePages != sv::huge::Mode::Off)
+            sv::huge::advise(keys.data(), input.bytes());
+        keys.resize(input.bytes() / sizeof(int));
+        if (!keys.empty())
+            std::memcpy(keys.data(), input.data(), input.bytes());
+    }
+    else
+    {
+        sv::textio::ParseError e =
+            sv::textio::parseInts(input.data(), input.data() + input.bytes(), keys, opt.threads);
+        if (e.failed)
+        {
+            std::cerr << "error: bad integer at byte " << e.offset << "\n";
+            return 1;
+        }
+        // Already populated: khugepaged collapses the pages in the background
+        if (opt.hugePages != sv::huge::Mode::Off)
+            sv::huge::advise(keys.data(), keys.size() * sizeof(int));
+    }
+    auto t1 = Clock::now();
+
+    std::vector<size_t> counts;
+    if (opt.unique || opt.count)
+        groupKeys(opt, keys, counts);
+    else
+        algorithms().at(opt.algorithm)(keys, opt.threads);
+    auto t2 = Clock::now();
+
+    int out = openOutput(opt.output);
+    if (out < 0)
+    {
+        std::cerr << "error: cannot write " << opt.output << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    std::vector<std::string> text;
+    std::vector<uint8_t> packed;
+    std::vector<iovec> parts;
+    if (opt.packedOut)
+    {
+        packed = sv::packed::encode(keys.data(), keys.size(), opt.threads);
+        parts.push_back({packed.data(), packed.size()});
+    }
+    else if (opt.binaryOut)
+    {
+        parts.push_back({keys.data(), keys.size() * sizeof(int)});
+    }
+    else
+    {
+        text = opt.count ? sv::textio::formatCounts(keys.data(), counts.data(), keys.size(), opt.threads)
+                         : sv::textio::formatInts(keys.data(), keys.size(), opt.threads);
+        for (std::string &t : text)
+            parts.push_back({&t[0], t.size()});
+    }
+    auto t3 = Clock::now();
+    bool written = writeAll(out, std::move(parts));
+    if (out != STDOUT_FILENO)
+        written = ::close(out) == 0 && written;
+    if (!written)
+    {
+        std::cerr << "error: write failed: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    auto t4 = Clock::now();
+
+    if (opt.stats)
+    {
+        auto seconds = [](Clock::time_point a, Clock::time_point b) {
+            return std::chrono::duration<double>(b - a).count();
+        };
+        double mb = input.bytes() / 1e6;
+        std::cerr << keys.size() << " keys, " << mb << " MB input\n"
+                  << "  read+parse " << seconds(t0, t1) << " s (" << mb / seconds(t0, t1) << " MB/s)\n"
+                  << "  sort       " << seconds(t1, t2) << " s (" << opt.algorithm << ", "
+                  << sv::simd::isaName(sv::simd::activeIsa()) << " scans)\n"
+                  << "  format     " << seconds(t2, t3) << " s\n"
+                  << "  write      " << seconds(t3, t4) << " s\n";
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * protocol.hpp
+ *
+ * Wire format of the SortVision sort daemon (sortDaemon.cpp).
+ *
+ * Every message is a 16-byte header followed by a payload, all in host
+ * byte order (the daemon only listens on a Unix socket or on localhost):
+ *
+ *     request:  magic "SVSQ" | op (1 byte) | 3 reserved bytes | count (u64) | count x int32
+ *     response: magic "SVSR" | status (u32)                   | count (u64) | payload
+ *
+ * A sort reply carries the sorted int32 keys; a Stats reply carries
+ * `count` bytes of plain-text latency statistics. Requests on one
+ * connection are answered in order, so clients may pipeline them.
+ */
+#ifndef SORTVISION_DAEMON_PROTOCOL_HPP
+#define SORTVISION_DAEMON_PROTOCOL_HPP
+
+#include <cstdint>
+
+namespace sv::daemon {
+
+constexpr uint32_t kRequestMagic = 0x51535653;  // "SVSQ"
+constexpr uint32_t kResponseMagic = 0x52535653; // "SVSR"
+
+enum class Op : uint8_t
+{
+    Auto = 0, // batched with other small requests, or parallel when large
+    Quick = 1,
+    Merge = 2,
+    Heap = 3,
+    Radix = 4,
+    Insertion = 5,
+    Selection = 6,
+    Bubble = 7,
+    Stats = 0x80 // latency histograms as text; count must be 0
+};
+
+enum class Status : uint32_t
+{
+    Ok = 0,
+    BadMagic = 1,   // connection is closed after the reply
+    UnknownOp = 2,  // payload is discarded
+    TooLarge = 3    // connection is closed after the reply
+};
+
+struct RequestHeader
+{
+    uint32_t magic;
+    Op op;
+    uint8_t reserved[3];
+    uint64_t count;
+};
+
+struct ResponseHeader
+{
+    uint32_t magic;
+    Status status;
+    uint64_t count;
+};
+
+static_assert(sizeof(RequestHeader) == 16 && sizeof(ResponseHeader) == 16, "wire headers are 16 bytes");
+
+} // namespace sv::daemon
+
+#endif // SORTVISION_DAEMON_PROTOCOL_HPP
@@ -0,0 +1,705 @@
+/**
+ * sortDaemon.cpp
+ *
+ * Native sorting service for the SortVision server.
+ *
+ * Accepts length-prefixed int32 arrays (see protocol.hpp) over a Unix
+ * domain socket and/or localhost TCP and answers with the sorted array.
+ *
+ * Design:
+ *  - One epoll loop thread does all socket I/O (non-blocking,
+ *    level-triggered). Each connection receives its payload straight into
+ *    a std::vector<int> that it reuses across requests.
+ *  - After each epoll round, every complete request is dispatched:
+ *      Auto op, count <= --batch-max   sorted together as one segmented job
+ *      Auto op, count >= --parallel-min parallelSort on all threads
+ *      named op                          that implementation (quick and heap
+ *                                        run as parallel kernels when large)
+ *    Auto and Quick use the three-way introsort kernel, so duplicate-heavy
+ *    input cannot make them quadratic. Insertion, selection and bubble
+ *    accept at most --quadratic-max keys.
+ *  - Sorting runs on two worker threads, never on the loop: one takes the
+ *    batched jobs, the other every other request, so a long sort delays
+ *    neither socket I/O nor the small requests. A worker hands finished
+ *    connections back through an eventfd. While a request is being sorted
+ *    its socket is removed from the epoll set.
+ *  - Keys are sorted in place in the receive buffer and the reply is sent
+ *    with writev() from that same buffer: header + payload, no copy.
+ *  - Latency (first request byte to last reply byte) is recorded per
+ *    dispatch class in log2 histograms, returned by the Stats op and
+ *    printed on SIGINT/SIGTERM.
+ *
+ * Build (from SortVision/native):
+ *   g++ -std=c++17 -O2 -pthread -Iinclude daemon/sortDaemon.cpp -o sortDaemon
+ *
+ * Run:
+ *   ./sortDaemon --unix /tmp/sortvision.sock --tcp 7420
+ */
+
+#include "algorithms.hpp"
+#include "parallelSort.hpp"
+#include "protocol.hpp"
+
+#include <arpa/inet.h>
+#include <csignal>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace sv::daemon;
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    std::string unixPath;
+    int tcpPort = -1;
+    unsigned threads = 0;
+    size_t batchMax = 4096;
+    size_t parallelMin = size_t(1) << 16;
+    size_t maxElements = size_t(1) << 28;
+    size_t quadraticMax = size_t(1) << 14; // insertion, selection, bubble
+};
+
+/**
+ * Latency histogram with power-of-two microsecond buckets
+ * (bucket k holds latencies in [2^(k-1), 2^k) us).
+ */
+class Histogram
+{
+public:
+    void record(double micros)
+    {
+        size_t k = 0;
+        while (k + 1 < buckets.size() && (uint64_t(1) << k) <= micros)
+            ++k;
+        ++buckets[k];
+        ++count;
+        sum += micros;
+        max = std::max(max, micros);
+    }
+
+    /** Upper bound of the bucket holding quantile q (0 < q <= 1). */
+    double quantile(double q) const
+    {
+        uint64_t rank = static_cast<uint64_t>(q * count + 0.5), seen = 0;
+        for (size_t k = 0; k < buckets.size(); ++k)
+            if ((seen += buckets[k]) >= std::max<uint64_t>(rank, 1))
+                return std::min(static_cast<double>(uint64_t(1) << k), max);
+        return max;
+    }
+
+    uint64_t count = 0;
+    double sum = 0;
+    double max = 0;
+
+private:
+    std::array<uint64_t, 40> buckets{};
+};
+
+enum Dispatch
+{
+    Batched,
+    Parallel,
+    Sequential,
+    DispatchCount
+};
+
+const char *dispatchNames[DispatchCount] = {"batched", "parallel", "sequential"};
+
+struct Connection
+{
+    enum class State
+    {
+        Header,
+        Payload,
+        Ready,   // request complete, waiting for dispatch
+        Sorting, // owned by a worker thread until it is finished
+        Reply
+    };
+
+    int fd = -1;
+    State state = State::Header;
+    RequestHeader request{};
+    size_t received = 0;      // bytes of the current header or payload
+    std::vector<int> payload; // receive buffer, sorted in place and sent back
+    std::string text;         // Stats reply body
+    Status result = Status::Ok;
+
+    ResponseHeader response{};
+    iovec out[2]{};
+    size_t sent = 0;
+    bool closeAfterReply = false;
+
+    Clock::time_point started;
+    Dispatch dispatch = Sequential;
+};
+
+class SortDaemon
+{
+public:
+    explicit SortDaemon(const Options &options) : opt(options) {}
+
+    bool listenOn()
+    {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0)
+            return fail("epoll_create1");
+        wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0)
+            return fail("eventfd");
+        watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+        for (Lane &lane : lanes)
+            lane.worker = std::thread([this, &lane] { work(lane); });
+        if (!opt.unixPath.empty())
+        {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (opt.unixPath.size() >= sizeof(addr.sun_path))
+                return fail("socket path too long");
+            std::strcpy(addr.sun_path, opt.unixPath.c_str());
+            ::unlink(addr.sun_path);
+            if (!addListener(AF_UNIX, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)))
+                return false;
+            std::cerr << "listening on " << opt.unixPath << "\n";
+        }
+        if (opt.tcpPort >= 0)
+        {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(opt.tcpPort));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (!addListener(AF_INET, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)))
+                return false;
+            std::cerr << "listening on 127.0.0.1:" << opt.tcpPort << "\n";
+        }
+        return true;
+    }
+
+    /** Serves until `stop` becomes non-zero. */
+    void run(const volatile std::sig_atomic_t &stop)
+    {
+        std::vector<epoll_event> events(256);
+        while (!stop)
+        {
+            int n = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                fail("epoll_wait");
+                return;
+            }
+            for (int k = 0; k < n; ++k)
+            {
+                int fd = events[k].data.fd;
+                if (std::find(listeners.begin(), listeners.end(), fd) != listeners.end())
+                    acceptAll(fd);
+                else if (fd == wakeFd)
+                    collectFinished();
+                else if (auto it = connections.find(fd); it != connections.end())
+                    onReady(*it->second, events[k].events);
+            }
+            dispatchReady();
+        }
+    }
+
+    std::string stats() const
+    {
+        std::ostringstream out;
+        out << std::left << std::setw(12) << "class" << std::right << std::setw(10) << "requests"
+            << std::setw(12) << "mean_us" << std::setw(12) << "p50_us" << std::setw(12) << "p90_us"
+            << std::setw(12) << "p99_us" << std::setw(12) << "max_us" << "\n";
+        out << std::fixed << std::setprecision(1);
+        for (int d = 0; d < DispatchCount; ++d)
+        {
+            const Histogram &h = latency[d];
+            out << std::left << std::setw(12) << dispatchNames[d] << std::right << std::setw(10) << h.count
+                << std::setw(12) << (h.count ? h.sum / h.count : 0.0) << std::setw(12) << h.quantile(0.5)
+                << std::setw(12) << h.quantile(0.9) << std::setw(12) << h.quantile(0.99) << std::setw(12)
+                << h.max << "\n";
+        }
+        return out.str();
+    }
+
+    ~SortDaemon()
+    {
+        for (Lane &lane : lanes)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lane.lock);
+                lane.stopping = true;
+            }
+            lane.wake.notify_one();
+            if (lane.worker.joinable())
+                lane.worker.join();
+        }
+        if (wakeFd >= 0)
+            ::close(wakeFd);
+        for (auto &entry : connections)
+            ::close(entry.first);
+        for (int fd : listeners)
+            ::close(fd);
+        if (!opt.unixPath.empty())
+            ::unlink(opt.unixPath.c_str());
+        if (epollFd >= 0)
+            ::close(epollFd);
+    }
+
+private:
+    struct Job
+    {
+        std::vector<Connection *> connections;
+        bool batched = false;
+    };
+
+    // A worker thread and its queue of jobs
+    struct Lane
+    {
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<Job> jobs;
+        bool stopping = false;
+        std::thread worker;
+    };
+
+    enum LaneId
+    {
+        BatchLane,
+        SingleLane,
+        LaneCount
+    };
+
+    bool fail(const char *what)
+    {
+        std::cerr << "error: " << what << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    bool addListener(int family, const sockaddr *addr, socklen_t length)
+    {
+        int fd = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return fail("socket");
+        int one = 1;
+        if (family == AF_INET)
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(fd, addr, length) < 0 || ::listen(fd, SOMAXCONN) < 0)
+        {
+            ::close(fd);
+            return fail("bind/listen");
+        }
+        listeners.push_back(fd);
+        watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+        return true;
+    }
+
+    void watch(int fd, uint32_t events, int op)
+    {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, op, fd, &ev);
+    }
+
+    void acceptAll(int listener)
+    {
+        for (;;)
+        {
+            int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // fails harmlessly on Unix sockets
+            auto c = std::make_unique<Connection>();
+            c->fd = fd;
+            watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+            connections.emplace(fd, std::move(c));
+        }
+    }
+
+    void close(Connection &c)
+    {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+        ::close(c.fd);
+        ready.erase(std::remove(ready.begin(), ready.end(), &c), ready.end());
+        connections.erase(c.fd); // destroys c
+    }
+
+    void onReady(Connection &c, uint32_t events)
+    {
+        if (c.state == Connection::State::Reply)
+        {
+            sendReply(c);
+            return;
+        }
+        if (events & (EPOLLHUP | EPOLLERR) && !(events & EPOLLIN))
+        {
+            close(c);
+            return;
+        }
+        receive(c);
+    }
+
+    // Reads as much of the current request as is available
+    void receive(Connection &c)
+    {
+        while (c.state == Connection::State::Header || c.state == Connection::State::Payload)
+        {
+            char *target;
+            size_t wanted;
+            if (c.state == Connection::State::Header)
+            {
+                target = reinterpret_cast<char *>(&c.request) + c.received;
+                wanted = sizeof(RequestHeader) - c.received;
+            }
+            else
+            {
+                target = reinterpret_cast<char *>(c.payload.data()) + c.received;
+                wanted = c.payload.size() * sizeof(int) - c.received;
+            }
+
+            ssize_t got = wanted == 0 ? 0 : ::recv(c.fd, target, wanted, 0);
+            if (wanted != 0 && got <= 0)
+            {
+                if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    return;
+                if (got < 0 && errno == EINTR)
+                    continue;
+                close(c); // peer closed or error
+                return;
+            }
+            if (c.state == Connection::State::Header && c.received == 0)
+                c.started = Clock::now();
+            c.received += static_cast<size_t>(got);
+            if (static_cast<size_t>(got) != wanted)
+                continue;
+
+            if (c.state == Connection::State::Header)
+            {
+                if (!headerAccepted(c))
+                    return;
+                c.state = Connection::State::Payload;
+                c.received = 0;
+                c.payload.resize(c.request.count); // keeps capacity from earlier requests
+            }
+            else
+            {
+                c.state = Connection::State::Ready;
+                // No events until the reply starts: a hangup reported while a
+                // worker sorts the payload must not close the connection
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+                ready.push_back(&c);
+            }
+        }
+    }
+
+    bool headerAccepted(Connection &c)
+    {
+        Status status = Status::Ok;
+        if (c.request.magic != kRequestMagic)
+            status = Status::BadMagic;
+        else if (c.request.count > opt.maxElements)
+            status = Status::TooLarge;
+        else if (isQuadratic(c.request.op) && c.request.count > opt.quadraticMax)
+            status = Status::TooLarge;
+        if (status == Status::Ok)
+            return true;
+        c.closeAfterReply = true;
+        c.payload.clear();
+        startReply(c, status, nullptr, 0);
+        return false;
+    }
+
+    static bool isQuadratic(Op op) { return op == Op::Insertion || op == Op::Selection || op == Op::Bubble; }
+
+    // Hands every complete request collected during this epoll round to
+    // the workers; Stats is answered here
+    void dispatchReady()
+    {
+        if (ready.empty())
+            return;
+        Job batch;
+        batch.batched = true;
+        std::vector<Connection *> done;
+        done.swap(ready);
+        for (Connection *c : done)
+        {
+            if (c->request.op == Op::Stats)
+            {
+                watch(c->fd, 0, EPOLL_CTL_ADD);
+                c->text = stats();
+                startReply(*c, Status::Ok, c->text.data(), c->text.size());
+                continue;
+            }
+            c->state = Connection::State::Sorting;
+            if (c->request.op == Op::Auto && c->payload.size() <= opt.batchMax)
+                batch.connections.push_back(c);
+            else
+                submit(lanes[SingleLane], Job{{c}, false});
+        }
+        if (!batch.connections.empty())
+            submit(lanes[BatchLane], std::move(batch));
+    }
+
+    void submit(Lane &lane, Job job)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lane.lock);
+            lane.jobs.push_back(std::move(job));
+        }
+        lane.wake.notify_one();
+    }
+
+    // Worker thread: sorts jobs until the daemon shuts down
+    void work(Lane &lane)
+    {
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> guard(lane.lock);
+                lane.wake.wait(guard, [&] { return lane.stopping || !lane.jobs.empty(); });
+                if (lane.stopping)
+                    return;
+                job = std::move(lane.jobs.front());
+                lane.jobs.pop_front();
+            }
+            if (job.batched)
+            {
+                std::vector<sv::parallel::Segment> segments;
+                for (Connection *c : job.connections)
+                {
+                    segments.push_back({c->payload.data(), c->payload.size()});
+                    c->dispatch = Batched;
+                    c->result = Status::Ok;
+                }
+                sv::parallel::sortSegments(segments, sv::parallel::introKernel, opt.threads);
+            }
+            else
+            {
+                for (Connection *c : job.connections)
+                    c->result = sortOne(*c) ? Status::Ok : Status::UnknownOp;
+            }
+            {
+                std::lock_guard<std::mutex> guard(finishedLock);
+                finished.insert(finished.end(), job.connections.begin(), job.connections.end());
+            }
+            uint64_t one = 1;
+            ssize_t written = ::write(wakeFd, &one, sizeof(one));
+            (void)written; // the counter cannot overflow at one increment per job
+        }
+    }
+
+    // Starts the replies of the requests the workers have finished
+    void collectFinished()
+    {
+        uint64_t count;
+        ssize_t got = ::read(wakeFd, &count, sizeof(count));
+        (void)got; // EAGAIN when an earlier round already took the batch
+        std::vector<Connection *> done;
+        {
+            std::lock_guard<std::mutex> guard(finishedLock);
+            done.swap(finished);
+        }
+        for (Connection *c : done)
+        {
+            watch(c->fd, 0, EPOLL_CTL_ADD);
+            if (c->result == Status::Ok)
+                startReply(*c, Status::Ok, c->payload.data(), c->payload.size() * sizeof(int));
+            else
+                startReply(*c, c->result, nullptr, 0);
+        }
+    }
+
+    // Runs on a worker thread
+    bool sortOne(Connection &c)
+    {
+        std::vector<int> &keys = c.payload;
+        bool large = keys.size() >= opt.parallelMin;
+        c.dispatch = large ? Parallel : Sequential;
+        switch (c.request.op)
+        {
+        case Op::Auto:
+        case Op::Quick:
+            sv::parallel::parallelSort(keys.data(), keys.size(), sv::parallel::introKernel, opt.threads);
+            break;
+        case Op::Heap:
+            sv::parallel::parallelSort(keys.data(), keys.size(), sv::parallel::heapKernel, opt.threads);
+            break;
+        case Op::Merge:
+            c.dispatch = Sequential;
+            sv::mergeSort(keys);
+            break;
+        case Op::Radix:
+            c.dispatch = Sequential;
+            sv::radixSort(keys);
+            break;
+        case Op::Insertion:
+            c.dispatch = Sequential;
+            sv::insertionSort(keys);
+            break;
+        case Op::Selection:
+            c.dispatch = Sequential;
+            sv::selectionSort(keys);
+            break;
+        case Op::Bubble:
+            c.dispatch = Sequential;
+            sv::bubbleSort(keys);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    void startReply(Connection &c, Status status, const void *body, size_t bytes)
+    {
+        c.response = {kResponseMagic, status, c.request.op == Op::Stats ? bytes : bytes / sizeof(int)};
+        c.out[0] = {&c.response, sizeof(c.response)};
+        c.out[1] = {const_cast<void *>(body), bytes};
+        c.sent = 0;
+        c.state = Connection::State::Reply;
+        if (sendReply(c))
+            watch(c.fd, EPOLLOUT, EPOLL_CTL_MOD);
+    }
+
+    /** @return true if the reply is still incomplete */
+    bool sendReply(Connection &c)
+    {
+        size_t total = c.out[0].iov_len + c.out[1].iov_len;
+        while (c.sent < total)
+        {
+            iovec parts[2];
+            int count = 0;
+            size_t skip = c.sent;
+            for (const iovec &part : c.out)
+            {
+                if (skip >= part.iov_len)
+                {
+                    skip -= part.iov_len;
+                    continue;
+                }
+                parts[count++] = {static_cast<char *>(part.iov_base) + skip, part.iov_len - skip};
+                skip = 0;
+            }
+            ssize_t n = ::writev(c.fd, parts, count);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return true;
+                close(c);
+                return false;
+            }
+            c.sent += static_cast<size_t>(n);
+        }
+
+        if (c.response.status == Status::Ok && c.request.op != Op::Stats)
+            latency[c.dispatch].record(std::chrono::duration<double, std::micro>(Clock::now() - c.started).count());
+        if (c.closeAfterReply)
+        {
+            close(c);
+            return false;
+        }
+        c.state = Connection::State::Header;
+        c.received = 0;
+        watch(c.fd, EPOLLIN, EPOLL_CTL_MOD);
+        return false;
+    }
+
+    Options opt;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::vector<int> listeners;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::vector<Connection *> ready;
+    Histogram latency[DispatchCount];
+
+    Lane lanes[LaneCount];
+    std::mutex finishedLock;
+    std::vector<Connection *> finished; // sorted by a worker, reply not started
+};
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+bool parseArgs(int argc, char **argv, Options &opt)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        if (arg == "--unix")
+            opt.unixPath = value;
+        else if (arg == "--tcp")
+            opt.tcpPort = std::stoi(value);
+        else if (arg == "--threads")
+            opt.threads = static_cast<unsigned>(std::stoul(value));
+        else if (arg == "--batch-max")
+            opt.batchMax = static_cast<size_t>(std::stod(value));
+        else if (arg == "--parallel-min")
+            opt.parallelMin = static_cast<size_t>(std::stod(value));
+        else if (arg == "--max-elements")
+            opt.maxElements = static_cast<size_t>(std::stod(value));
+        else if (arg == "--quadratic-max")
+            opt.quadraticMax = static_cast<size_t>(std::stod(value));
+        else
+            return false;
+    }
+    if (opt.unixPath.empty() && opt.tcpPort < 0)
+        opt.unixPath = "/tmp/sortvision.sock";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--unix PATH] [--tcp PORT] [--threads N] [--batch-max N] [--parallel-min N]"
+                     " [--max-elements N] [--quadratic-max N]\n";
+        return 1;
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = onSignal; // no SA_RESTART: epoll_wait returns EINTR
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    SortDaemon daemon(opt);
+    if (!daemon.listenOn())
+        return 1;
+    daemon.run(stopRequested);
+    std::cerr << daemon.stats();
+    return 0;
+}
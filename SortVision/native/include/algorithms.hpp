@@ -0,0 +1,203 @@
+/**
+ * algorithms.hpp
+ *
+ * Pulls every C++ implementation under public/code/<algorithm>/cpp into a
+ * single program so native tools (benchmark, CLI, daemon) can call them.
+ *
+ * Each source file is a standalone demo with its own main() and helper
+ * names (printArray, runTests, partition, ...) that collide with each
+ * other. They are therefore included one by one inside their own
+ * namespace, with main renamed so the demo entry points stay unused.
+ *
+ * Every standard or system header used by the implementations must be
+ * included here first, at global scope: the include guards then turn the
+ * nested #includes inside the namespaces into no-ops.
+ */
+#ifndef SORTVISION_ALGORITHMS_HPP
+#define SORTVISION_ALGORITHMS_HPP
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../public/code/common/cpp/opCounters.hpp"
+#include "../../public/code/common/cpp/perfCounters.hpp"
+#include "../../public/code/common/cpp/simdMerge.hpp"
+#include "../../public/code/common/cpp/simdScan.hpp"
+#include "../../public/code/common/cpp/sortControl.hpp"
+#include "../../public/code/common/cpp/sortGroup.hpp"
+#include "../../public/code/common/cpp/sortWorkspace.hpp"
+
+namespace sv::impl::bubble {
+#define main bubbleSortDemoMain
+#include "../../public/code/bubble/cpp/bubbleSort.cpp"
+#undef main
+#undef fastio
+}
+
+namespace sv::impl::bucket {
+#define main bucketSortDemoMain
+#include "../../public/code/bucket/cpp/bucketSort.cpp"
+#undef main
+}
+
+namespace sv::impl::heap {
+#define main heapSortDemoMain
+#include "../../public/code/heap/cpp/heapSort.cpp"
+#undef main
+}
+
+namespace sv::impl::insertion {
+#include "../../public/code/insertion/cpp/insertionSort.cpp"
+}
+
+namespace sv::impl::merge {
+#define main mergeSortDemoMain
+#include "../../public/code/merge/cpp/mergeSort.cpp"
+#undef main
+}
+
+namespace sv::impl::quick {
+#define main quickSortDemoMain
+#include "../../public/code/quick/cpp/quickSort.cpp"
+#undef main
+}
+
+namespace sv::impl::radix {
+#define main radixSortDemoMain
+#include "../../public/code/radix/cpp/radixSort.cpp"
+#undef main
+}
+
+namespace sv::impl::selection {
+#define main selectionSortDemoMain
+#include "../../public/code/selection/cpp/selectionSort.cpp"
+#undef main
+}
+
+namespace sv {
+
+/**
+ * Uniform entry points over the C++ implementations.
+ * Every function sorts the whole vector in ascending order.
+ */
+inline void bubbleSort(std::vector<int> &arr) { impl::bubble::bubbleSort(arr); }
+inline void insertionSort(std::vector<int> &arr) { impl::insertion::insertionSort(arr); }
+inline void selectionSort(std::vector<int> &arr) { impl::selection::selectionSort(arr); }
+inline void tournamentSort(std::vector<int> &arr) { impl::selection::tournamentSort(arr); }
+inline void cycleSort(std::vector<int> &arr) { impl::selection::cycleSort(arr); }
+inline void quickSort(std::vector<int> &arr) { impl::quick::quickSort(arr); }
+inline void introSort(std::vector<int> &arr) { impl::quick::introSort(arr); }
+inline void radixSort(std::vector<int> &arr) { impl::radix::radixSort(arr); }
+
+inline void heapSort(std::vector<int> &arr)
+{
+    impl::heap::heapSort(arr.data(), arr.size());
+}
+
+inline void mergeSort(std::vector<int> &arr)
+{
+    if (!arr.empty())
+        impl::merge::mergeSort(arr, 0, static_cast<ptrdiff_t>(arr.size()) - 1);
+}
+
+inline void bucketSort(std::vector<float> &arr)
+{
+    impl::bucket::bucketSort(arr.data(), arr.size());
+}
+
+/**
+ * Fused sort + dedup and sort + count (sortGroup.hpp): arr becomes its
+ * distinct keys in ascending order, and the Counts variants return how
+ * often each one occurred (counts[i] for arr[i]).
+ */
+inline void radixSortUnique(std::vector<int> &arr) { impl::radix::radixSortUnique(arr); }
+inline void mergeSortUnique(std::vector<int> &arr) { impl::merge::mergeSortUnique(arr); }
+inline std::vector<size_t> radixSortCounts(std::vector<int> &arr) { return impl::radix::radixSortCounts(arr); }
+inline std::vector<size_t> mergeSortCounts(std::vector<int> &arr) { return impl::merge::mergeSortCounts(arr); }
+
+namespace detail {
+
+template <typename Sort>
+bool controlled(SortControl &control, Sort &&sort)
+{
+    ops::Controlled::Bind bind(control);
+    if (!control.cancelRequested())
+        sort();
+    return !control.cancelRequested();
+}
+
+} // namespace detail
+
+/**
+ * Same, reporting progress to `control` and stopping early once
+ * control.cancel() is called (see sortControl.hpp).
+ * @return false when cancelled; the vector then holds its keys partly sorted
+ */
+inline bool bubbleSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::bubble::bubbleSort<ops::Controlled>(arr); });
+}
+
+inline bool insertionSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::insertion::insertionSort<ops::Controlled>(arr); });
+}
+
+inline bool selectionSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::selection::selectionSort<ops::Controlled>(arr); });
+}
+
+inline bool tournamentSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::selection::tournamentSort<ops::Controlled>(arr); });
+}
+
+inline bool cycleSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::selection::cycleSort<ops::Controlled>(arr); });
+}
+
+inline bool quickSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::quick::quickSort<ops::Controlled>(arr); });
+}
+
+inline bool introSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::quick::introSort<ops::Controlled>(arr); });
+}
+
+inline bool radixSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] { impl::radix::radixSort<ops::Controlled>(arr); });
+}
+
+inline bool heapSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] {
+        impl::heap::heapSort<ops::Controlled>(arr.data(), arr.size());
+    });
+}
+
+inline bool mergeSort(std::vector<int> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] {
+        if (!arr.empty())
+            impl::merge::mergeSort<ops::Controlled>(arr, 0, static_cast<ptrdiff_t>(arr.size()) - 1);
+    });
+}
+
+inline bool bucketSort(std::vector<float> &arr, SortControl &control)
+{
+    return detail::controlled(control, [&] {
+        impl::bucket::bucketSort<ops::Controlled>(arr.data(), arr.size());
+    });
+}
+
+} // namespace sv
+
+#endif // SORTVISION_ALGORITHMS_HPP
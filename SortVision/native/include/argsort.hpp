@@ -0,0 +1,349 @@
+/**
+ * argsort.hpp
+ *
+ * Indirect sorts: return the permutation that sorts a key column instead
+ * of moving the keys, so any number of parallel columns can be reordered
+ * consistently afterwards.
+ *
+ *     std::vector<uint32_t> perm = sv::argsort::radixArgsort(price.data(), price.size());
+ *     sv::argsort::applyPermutation(perm, price, volume, timestamp, symbol);
+ *
+ * perm[i] is the original row of the i-th smallest key. Every variant is
+ * stable (equal keys keep their original order).
+ *
+ * Key caching: the sorts carry a private copy of the keys alongside the
+ * indices and permute both together. Comparisons therefore read keys
+ * sequentially from the cached copy instead of gathering keys[idx[i]]
+ * from random rows of the original column.
+ *
+ *  - quickArgsort:  the Lomuto quick sort of quickSort.cpp on (key, index)
+ *                   pairs; the index tie-break makes every pair distinct,
+ *                   so duplicate keys cannot degrade it. Ninther pivots
+ *                   and a heap-sort fallback after 2 log2 n levels (as in
+ *                   introSort) bound it at O(n log n) on organ-pipe and
+ *                   adversarial inputs
+ *  - mergeArgsort:  top-down merge sort as in mergeSort.cpp, with one
+ *                   scratch buffer allocated up front
+ *  - radixArgsort:  LSD radix sort with 8-bit digits on an order-preserving
+ *                   unsigned image of the key (integers and floats);
+ *                   passes whose digit is the same for every key are skipped
+ *
+ * Index is uint32_t by default; use uint64_t for more than 2^32 - 1 rows.
+ */
+#ifndef SORTVISION_ARGSORT_HPP
+#define SORTVISION_ARGSORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sv::argsort {
+
+namespace detail {
+
+template <typename Index>
+std::vector<Index> identity(size_t n)
+{
+    if (n > static_cast<size_t>(std::numeric_limits<Index>::max()))
+        throw std::length_error("argsort: too many rows for the index type");
+    std::vector<Index> idx(n);
+    std::iota(idx.begin(), idx.end(), Index(0));
+    return idx;
+}
+
+// (key, index) order: keys first, original row breaks ties
+template <typename Key, typename Index>
+bool before(const Key *k, const Index *idx, size_t a, size_t b)
+{
+    return k[a] < k[b] || (!(k[b] < k[a]) && idx[a] < idx[b]);
+}
+
+template <typename Key, typename Index>
+void swapRows(Key *k, Index *idx, size_t a, size_t b)
+{
+    std::swap(k[a], k[b]);
+    std::swap(idx[a], idx[b]);
+}
+
+// Position of the median of rows a, b and c
+template <typename Key, typename Index>
+ptrdiff_t median3(const Key *k, const Index *idx, ptrdiff_t a, ptrdiff_t b, ptrdiff_t c)
+{
+    if (before(k, idx, a, b))
+        return before(k, idx, b, c) ? b : before(k, idx, a, c) ? c : a;
+    return before(k, idx, a, c) ? a : before(k, idx, b, c) ? c : b;
+}
+
+template <typename Key, typename Index>
+ptrdiff_t partition(Key *k, Index *idx, ptrdiff_t low, ptrdiff_t high)
+{
+    // Median of three, or on long ranges the median of three medians
+    // (ninther), which keeps sorted and organ-pipe inputs balanced
+    ptrdiff_t mid = low + (high - low) / 2, pivot;
+    if (high - low >= 128)
+    {
+        ptrdiff_t s = (high - low) / 8;
+        pivot = median3(k, idx, median3(k, idx, low, low + s, low + 2 * s), median3(k, idx, mid - s, mid, mid + s),
+                        median3(k, idx, high - 2 * s, high - s, high));
+    }
+    else
+    {
+        pivot = median3(k, idx, low, mid, high);
+    }
+    swapRows(k, idx, pivot, high);
+    ptrdiff_t i = low - 1;
+    for (ptrdiff_t j = low; j < high; ++j)
+        if (before(k, idx, j, high))
+            swapRows(k, idx, ++i, j);
+    swapRows(k, idx, i + 1, high);
+    return i + 1;
+}
+
+// Heap sort of rows [0, n), the fallback once the depth budget is spent
+template <typename Key, typename Index>
+void heapSortRows(Key *k, Index *idx, size_t n)
+{
+    auto siftDown = [&](size_t root, size_t end) {
+        for (size_t child; (child = 2 * root + 1) < end; root = child)
+        {
+            if (child + 1 < end && before(k, idx, child, child + 1))
+                ++child;
+            if (!before(k, idx, root, child))
+                return;
+            swapRows(k, idx, root, child);
+        }
+    };
+    for (size_t i = n / 2; i-- > 0;)
+        siftDown(i, n);
+    for (size_t end = n; end-- > 1;)
+    {
+        swapRows(k, idx, 0, end);
+        siftDown(0, end);
+    }
+}
+
+// Introsort: after `budget` partitions on a path the range is heap sorted
+template <typename Key, typename Index>
+void quickSortRows(Key *k, Index *idx, ptrdiff_t low, ptrdiff_t high, int budget)
+{
+    while (low < high)
+    {
+        if (budget-- == 0)
+        {
+            heapSortRows(k + low, idx + low, static_cast<size_t>(high - low + 1));
+            return;
+        }
+        ptrdiff_t p = partition(k, idx, low, high);
+        // Recurse into the smaller side to bound the stack depth
+        if (p - low < high - p)
+        {
+            quickSortRows(k, idx, low, p - 1, budget);
+            low = p + 1;
+        }
+        else
+        {
+            quickSortRows(k, idx, p + 1, high, budget);
+            high = p - 1;
+        }
+    }
+}
+
+template <typename Key, typename Index>
+void mergeSortRows(Key *k, Index *idx, Key *kTmp, Index *idxTmp, size_t left, size_t right)
+{
+    if (right - left < 2)
+        return;
+    size_t mid = left + (right - left) / 2;
+    mergeSortRows(k, idx, kTmp, idxTmp, left, mid);
+    mergeSortRows(k, idx, kTmp, idxTmp, mid, right);
+    if (!(k[mid] < k[mid - 1]))
+        return; // halves already in order
+
+    std::copy(k + left, k + mid, kTmp + left);
+    std::copy(idx + left, idx + mid, idxTmp + left);
+    size_t i = left, j = mid, out = left;
+    while (i < mid && j < right)
+    {
+        // Take from the right half only when strictly smaller: stable
+        bool takeRight = k[j] < kTmp[i];
+        k[out] = takeRight ? k[j] : kTmp[i];
+        idx[out++] = takeRight ? idx[j++] : idxTmp[i++];
+    }
+    while (i < mid)
+    {
+        k[out] = kTmp[i];
+        idx[out++] = idxTmp[i++];
+    }
+}
+
+/** Order-preserving map of a key to an unsigned integer of the same width. */
+template <typename Key>
+auto radixImage(Key key)
+{
+    static_assert(std::is_arithmetic_v<Key>, "radixArgsort needs integer or floating-point keys");
+    using U = std::conditional_t<sizeof(Key) <= 4, uint32_t, uint64_t>;
+    constexpr int bits = 8 * sizeof(Key);
+    if constexpr (std::is_floating_point_v<Key>)
+    {
+        using Bits = std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>;
+        Bits b;
+        std::memcpy(&b, &key, sizeof(b));
+        // Negative floats: flip everything; positive: flip the sign bit
+        Bits sign = Bits(1) << (bits - 1);
+        return static_cast<U>(b & sign ? ~b : b | sign);
+    }
+    else if constexpr (std::is_signed_v<Key>)
+    {
+        using S = std::make_unsigned_t<Key>;
+        return static_cast<U>(static_cast<S>(static_cast<S>(key) ^ (S(1) << (bits - 1))));
+    }
+    else
+    {
+        return static_cast<U>(key);
+    }
+}
+
+/**
+ * Stable LSD radix sort of (k, idx) rows on the low `bytes` bytes of k,
+ * 8 bits per pass. Passes whose digit is the same for every row are
+ * skipped.
+ */
+template <typename U, typename Index>
+void radixSortRows(std::vector<U> &k, std::vector<Index> &idx, size_t bytes)
+{
+    size_t n = k.size();
+    std::vector<U> kTmp(n);
+    std::vector<Index> idxTmp(n);
+    for (size_t shift = 0; shift < 8 * bytes; shift += 8)
+    {
+        size_t count[257] = {};
+        for (size_t i = 0; i < n; ++i)
+            ++count[((k[i] >> shift) & 0xff) + 1];
+        if (std::find(count + 1, count + 257, n) != count + 257)
+            continue; // every key has the same digit: the pass would not move anything
+        for (int d = 0; d < 256; ++d)
+            count[d + 1] += count[d];
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t to = count[(k[i] >> shift) & 0xff]++;
+            kTmp[to] = k[i];
+            idxTmp[to] = idx[i];
+        }
+        k.swap(kTmp);
+        idx.swap(idxTmp);
+    }
+}
+
+} // namespace detail
+
+/** Stable quick-sort argsort (see file comment). */
+template <typename Index = uint32_t, typename Key>
+std::vector<Index> quickArgsort(const Key *keys, size_t n)
+{
+    std::vector<Index> idx = detail::identity<Index>(n);
+    if (n > 1)
+    {
+        std::vector<Key> k(keys, keys + n);
+        int budget = 0; // 2 log2 n partition levels
+        for (size_t m = n; m > 1; m >>= 1)
+            budget += 2;
+        detail::quickSortRows(k.data(), idx.data(), 0, static_cast<ptrdiff_t>(n) - 1, budget);
+    }
+    return idx;
+}
+
+/** Stable merge-sort argsort. */
+template <typename Index = uint32_t, typename Key>
+std::vector<Index> mergeArgsort(const Key *keys, size_t n)
+{
+    std::vector<Index> idx = detail::identity<Index>(n);
+    if (n > 1)
+    {
+        std::vector<Key> k(keys, keys + n), kTmp(n);
+        std::vector<Index> idxTmp(n);
+        detail::mergeSortRows(k.data(), idx.data(), kTmp.data(), idxTmp.data(), 0, n);
+    }
+    return idx;
+}
+
+/** Stable LSD radix argsort for integer and floating-point keys. */
+template <typename Index = uint32_t, typename Key>
+std::vector<Index> radixArgsort(const Key *keys, size_t n)
+{
+    std::vector<Index> idx = detail::identity<Index>(n);
+    if (n < 2)
+        return idx;
+
+    std::vector<decltype(detail::radixImage(keys[0]))> k(n);
+    for (size_t i = 0; i < n; ++i)
+        k[i] = detail::radixImage(keys[i]);
+    detail::radixSortRows(k, idx, sizeof(Key));
+    return idx;
+}
+
+/** Rows gathered per block by applyPermutation (block of indices stays in L1). */
+constexpr size_t kPermutationBlock = 4096;
+
+/**
+ * Reorders every column so that column[i] becomes column[perm[i]].
+ *
+ * The permutation is walked in blocks of kPermutationBlock indices; each
+ * block is applied to all columns before moving on, so the indices are
+ * read from memory once however many columns there are. Each column needs
+ * a temporary copy of its own size while the gather runs.
+ */
+template <typename Index, typename... Columns>
+void applyPermutation(const std::vector<Index> &perm, Columns &...columns)
+{
+    size_t n = perm.size();
+    if (((columns.size() != n) || ...))
+        throw std::invalid_argument("applyPermutation: column length differs from the permutation");
+
+    std::tuple<Columns...> out{Columns(n)...};
+    for (size_t lo = 0; lo < n; lo += kPermutationBlock)
+    {
+        size_t hi = std::min(n, lo + kPermutationBlock);
+        std::apply(
+            [&](auto &...dst) {
+                auto gather = [&](auto &to, const auto &from) {
+                    for (size_t i = lo; i < hi; ++i)
+                        to[i] = from[perm[i]];
+                };
+                (gather(dst, columns), ...);
+            },
+            out);
+    }
+    std::apply([&](auto &...dst) { (columns.swap(dst), ...); }, out);
+}
+
+/**
+ * applyPermutation() for a runtime list of same-typed columns, each of
+ * perm.size() elements.
+ */
+template <typename Index, typename T>
+void applyPermutationToColumns(const std::vector<Index> &perm, const std::vector<T *> &columns)
+{
+    size_t n = perm.size();
+    std::vector<std::vector<T>> out(columns.size(), std::vector<T>(n));
+    for (size_t lo = 0; lo < n; lo += kPermutationBlock)
+    {
+        size_t hi = std::min(n, lo + kPermutationBlock);
+        for (size_t c = 0; c < columns.size(); ++c)
+            for (size_t i = lo; i < hi; ++i)
+                out[c][i] = columns[c][perm[i]];
+    }
+    for (size_t c = 0; c < columns.size(); ++c)
+        std::copy(out[c].begin(), out[c].end(), columns[c]);
+}
+
+} // namespace sv::argsort
+
+#endif // SORTVISION_ARGSORT_HPP
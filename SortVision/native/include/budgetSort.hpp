@@ -0,0 +1,547 @@
+/**
+ * budgetSort.hpp
+ *
+ * Sorting under a memory budget: the caller says how many bytes the sort
+ * may use, and the planner configures an engine that fits.
+ *
+ *     sv::budget::Report r = sv::budget::sortWithBudget(vec, 1 << 20);
+ *     std::cerr << r << "\n"; // "radix: n=10000000 budget=1048576 peak=1048512 buffer=262128 ..."
+ *
+ *     sv::budget::sortStream(read, write, 64 << 20);  // input of any size, 64 MiB in total
+ *
+ * The engine is one radix sort whose scratch is a parameter. American flag
+ * sort (MSD, one byte per level, keys moved in place along permutation
+ * cycles) runs until a bucket fits a buffer of b keys; that bucket is
+ * finished by LSD passes through the buffer. Ranges of up to 32 keys go
+ * to sorting networks. Scratch is 4b bytes plus O(1) stack:
+ *
+ *   buffer b         ns/key, n = 10^7      uniform  zipf  sorted
+ *   0 (in place)     flag-radix                21     21     7
+ *   4096             radix                     18     18     8
+ *   2^20 (4 MiB)     radix                     14     13     7
+ *   n (40 MB)        radix                     13     10    14
+ *
+ * For comparison, the demo engines with their full scratch: merge sort 47
+ * (4n bytes), base-256 radix sort 32 (8n). Past about 2^20 keys the LSD
+ * passes leave the cache, so plan() never takes more than that
+ * (kMaxBufferKeys): a 4 MiB buffer sorts 10^7 keys as fast as a 40 MB one.
+ * Smaller budgets shrink the buffer; below kMinBufferKeys keys the sort
+ * is fully in place.
+ *
+ * Scratch comes from a SortWorkspace sized to the plan up front, and
+ * Report::peakBytes is its high-water mark, the bytes in use at once as
+ * measured, not the model.
+ *
+ * sortStream() takes input that may not fit: chunks as large as the
+ * budget allows are sorted in memory by the same planner and spilled as
+ * delta bit-packed runs (packedInts.hpp) to an unlinked temporary file,
+ * which is then mapped and k-way merged into the sink. The budget then
+ * covers the chunk, its sort and the run encoder; mapped run pages are
+ * page cache and are not counted. A merge holds one decoded block per run,
+ * so when the runs outnumber what the budget holds (about 6000 at 4 MiB),
+ * merge passes first combine groups of them into longer runs.
+ */
+#ifndef SORTVISION_BUDGET_SORT_HPP
+#define SORTVISION_BUDGET_SORT_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "algorithms.hpp"
+#include "packedInts.hpp"
+#include "sortingNetwork.hpp"
+
+namespace sv::budget {
+
+enum class Engine
+{
+    Radix,     // in-place MSD passes, then LSD passes through a buffer
+    FlagRadix, // in-place MSD passes only
+    External
+};
+
+inline const char *engineName(Engine e)
+{
+    switch (e)
+    {
+    case Engine::Radix: return "radix";
+    case Engine::FlagRadix: return "flag-radix";
+    case Engine::External: return "external";
+    }
+    return "unknown";
+}
+
+/** Smallest LSD buffer worth taking: a bucket must outweigh its 256 counters. */
+constexpr size_t kMinBufferKeys = 256;
+
+/** Largest LSD buffer taken: 4 MiB, past which the LSD passes leave the cache. */
+constexpr size_t kMaxBufferKeys = size_t(1) << 20;
+
+/** Smallest budget sortStream() accepts: the run encoder alone holds about 1 MiB. */
+constexpr size_t kMinStreamBudget = size_t(4) << 20;
+
+struct Plan
+{
+    Engine engine = Engine::FlagRadix;
+    size_t scratchBytes = 0; // predicted, an upper bound
+    size_t bufferKeys = 0;
+    const char *reason = "";
+};
+
+struct Report
+{
+    Plan plan;                // External: the plan of the in-memory chunk sorts
+    Engine engine = Engine::FlagRadix;
+    size_t n = 0;
+    size_t budgetBytes = 0;
+    size_t peakBytes = 0;     // measured: workspace high-water (+ chunk and encoder for streams)
+    size_t reservedBytes = 0; // allocated for scratch, including alignment slack
+    size_t runs = 0;          // External: sorted runs spilled
+    size_t mergePasses = 0;   // External: passes that merged runs into longer runs
+    uint64_t spillBytes = 0;  // External: bytes written to the temporary file
+};
+
+inline std::ostream &operator<<(std::ostream &out, const Report &r)
+{
+    out << engineName(r.engine) << ": n=" << r.n << " budget=" << r.budgetBytes << " peak=" << r.peakBytes;
+    if (r.engine == Engine::External)
+        out << " runs=" << r.runs << " passes=" << r.mergePasses << " spill=" << r.spillBytes << " chunks by "
+            << engineName(r.plan.engine);
+    if (r.plan.bufferKeys > 0)
+        out << " buffer=" << r.plan.bufferKeys;
+    return out << " (" << r.plan.reason << ")";
+}
+
+namespace detail {
+
+// Alignment padding the workspace may add to a take()
+constexpr size_t kTakeSlack = 64;
+
+inline uint32_t digit(int key, int shift)
+{
+    return ((static_cast<uint32_t>(key) ^ 0x80000000u) >> shift) & 0xFF;
+}
+
+/** LSD radix sort of a[0, n) by the bytes at `shift` and below, through buf[0, n). */
+inline void lsdRadix(int *a, size_t n, int shift, int *buf)
+{
+    int passes = shift / 8 + 1;
+    size_t count[4][256] = {};
+    for (size_t i = 0; i < n; ++i)
+        for (int p = 0; p < passes; ++p)
+            ++count[p][digit(a[i], 8 * p)];
+    int *src = a, *dst = buf;
+    for (int p = 0; p < passes; ++p)
+    {
+        size_t *c = count[p];
+        if (c[digit(src[0], 8 * p)] == n) // every key has the same byte
+            continue;
+        for (size_t d = 0, sum = 0; d < 256; ++d)
+        {
+            size_t k = c[d];
+            c[d] = sum;
+            sum += k;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            int v = src[i];
+            dst[c[digit(v, 8 * p)]++] = v;
+        }
+        std::swap(src, dst);
+    }
+    if (src != a)
+        std::copy(src, src + n, a);
+}
+
+/**
+ * American flag sort of a[0, n) by the byte at `shift`, then each bucket
+ * by the next byte: ranges of up to b keys go through buf by LSD instead.
+ */
+inline void radix(int *a, size_t n, int shift, int *buf, size_t b)
+{
+    if (n <= sv::network::kMaxSize)
+    {
+        sv::network::sortSmall(a, n);
+        return;
+    }
+    if (n <= b)
+    {
+        lsdRadix(a, n, shift, buf);
+        return;
+    }
+    size_t count[256] = {};
+    for (size_t i = 0; i < n; ++i)
+        ++count[digit(a[i], shift)];
+
+    if (count[digit(a[0], shift)] != n)
+    {
+        // head[d]: next slot of bucket d still to be settled; end[d]: its end
+        size_t head[256], end[256];
+        for (size_t d = 0, sum = 0; d < 256; ++d)
+        {
+            head[d] = sum;
+            sum += count[d];
+            end[d] = sum;
+        }
+        // Cycle leader: carry each misplaced key to its bucket, taking the one found there
+        for (size_t d = 0; d < 256; ++d)
+        {
+            while (head[d] < end[d])
+            {
+                int v = a[head[d]];
+                uint32_t target = digit(v, shift);
+                while (target != d)
+                {
+                    std::swap(v, a[head[target]++]);
+                    target = digit(v, shift);
+                }
+                a[head[d]++] = v;
+            }
+        }
+    }
+    if (shift == 0)
+        return;
+    for (size_t d = 0, start = 0; d < 256; start += count[d++])
+        if (count[d] > 1)
+            radix(a + start, count[d], shift - 8, buf, b);
+}
+
+} // namespace detail
+
+/**
+ * Radix sort of a[0, n) with a buffer of b keys taken from ws: in-place
+ * MSD passes until a bucket fits the buffer, LSD passes for the rest.
+ * b = 0 sorts fully in place (American flag sort); b >= n is a plain LSD
+ * radix sort.
+ */
+inline void radixSort(int *a, size_t n, size_t b, SortWorkspace &ws = SortWorkspace::thisThread())
+{
+    if (n < 2)
+        return;
+    b = std::min(b, n);
+    SortWorkspace::Scope scope(ws);
+    detail::radix(a, n, 24, b > 0 ? ws.take<int>(b) : nullptr, b);
+}
+
+/**
+ * Chooses the buffer for n keys and budgetBytes of scratch: as many keys
+ * as the budget holds, up to n and kMaxBufferKeys. Budgets under
+ * kMinBufferKeys keys sort in place.
+ */
+inline Plan plan(size_t n, size_t budgetBytes)
+{
+    Plan p;
+    size_t fits = budgetBytes > detail::kTakeSlack ? (budgetBytes - detail::kTakeSlack) / sizeof(int) : 0;
+    size_t b = std::min({fits, n, kMaxBufferKeys});
+    if (n <= sv::network::kMaxSize || b < kMinBufferKeys)
+    {
+        p.reason = n <= sv::network::kMaxSize ? "sorting network" : "in place, no room for a radix buffer";
+        return p;
+    }
+    p.engine = Engine::Radix;
+    p.bufferKeys = b;
+    p.scratchBytes = b * sizeof(int) + detail::kTakeSlack;
+    p.reason = b == n                ? "LSD buffer for every key"
+               : b == kMaxBufferKeys ? "cache-sized LSD buffer"
+                                     : "LSD buffer reduced to the budget";
+    return p;
+}
+
+/**
+ * Sorts keys in memory with at most budgetBytes of scratch beyond the
+ * keys themselves.
+ */
+inline Report sortWithBudget(int *keys, size_t n, size_t budgetBytes)
+{
+    Report r;
+    r.n = n;
+    r.budgetBytes = budgetBytes;
+    r.plan = plan(n, budgetBytes);
+    r.engine = r.plan.engine;
+    SortWorkspace ws(r.plan.scratchBytes, huge::Mode::Off);
+    radixSort(keys, n, r.plan.bufferKeys, ws);
+    r.peakBytes = ws.highWater();
+    r.reservedBytes = ws.capacity();
+    return r;
+}
+
+inline Report sortWithBudget(std::vector<int> &keys, size_t budgetBytes)
+{
+    return sortWithBudget(keys.data(), keys.size(), budgetBytes);
+}
+
+/** Fills up to `capacity` keys; returns 0 only once the input is exhausted. */
+using Source = std::function<size_t(int *keys, size_t capacity)>;
+/** Receives the sorted keys in order, in chunks. */
+using Sink = std::function<void(const int *keys, size_t n)>;
+
+namespace detail {
+
+/** Unlinked temporary file; gone once closed. */
+class SpillFile
+{
+public:
+    explicit SpillFile(std::string dir)
+    {
+        if (dir.empty())
+        {
+            const char *env = std::getenv("TMPDIR");
+            dir = env && *env ? env : "/tmp";
+        }
+        std::string path = dir + "/sortvision-run-XXXXXX";
+        fd = ::mkstemp(&path[0]);
+        if (fd < 0)
+            throw std::runtime_error("cannot create a temporary file in " + dir + ": " + std::strerror(errno));
+        ::unlink(path.c_str());
+    }
+    ~SpillFile()
+    {
+        if (map != MAP_FAILED)
+            ::munmap(map, bytes);
+        ::close(fd);
+    }
+    SpillFile(const SpillFile &) = delete;
+    SpillFile &operator=(const SpillFile &) = delete;
+
+    void write(const uint8_t *p, size_t n)
+    {
+        bytes += n;
+        while (n > 0)
+        {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0)
+                throw std::runtime_error(std::string("cannot write the temporary file: ") + std::strerror(errno));
+            p += w;
+            n -= static_cast<size_t>(w);
+        }
+    }
+
+    /** Everything written so far, mapped read-only (replacing an earlier mapping). */
+    const uint8_t *mapAll()
+    {
+        if (map != MAP_FAILED)
+            ::munmap(map, mapped);
+        mapped = bytes;
+        map = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED)
+            throw std::runtime_error(std::string("cannot map the temporary file: ") + std::strerror(errno));
+        ::madvise(map, bytes, MADV_SEQUENTIAL);
+        return static_cast<const uint8_t *>(map);
+    }
+
+    /** Gives the disk space of [offset, offset + n) back; the range reads as zeros afterwards. */
+    void release(uint64_t offset, uint64_t n)
+    {
+        ::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset),
+                    static_cast<off_t>(n)); // best effort: not every file system can
+    }
+
+    uint64_t size() const { return bytes; }
+
+private:
+    int fd = -1;
+    void *map = MAP_FAILED;
+    size_t mapped = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * Bound on Encoder::memoryBytes() for a run of n keys: the output buffer
+ * (at most 1 MiB plus a block before it is flushed, then the footer) and
+ * the block index, each of which may have doubled its capacity.
+ */
+inline size_t encoderBytes(size_t n)
+{
+    size_t index = (n / packed::kBlockSize + 1) * sizeof(packed::IndexEntry);
+    size_t blocks = std::min(n * sizeof(int) + n / 8, size_t(1) << 20) + 1024;
+    return 2 * (blocks + index + 64) + 2 * index;
+}
+
+/** A sorted run in the spill file. */
+struct Run
+{
+    uint64_t offset;
+    uint64_t bytes;
+    uint64_t keys;
+};
+
+/**
+ * Memory a merge holds per input run: a decoded block and its cursor (528
+ * bytes), the Reader (56) and the heap entry and run records.
+ */
+constexpr size_t kMergeRunBytes = packed::kBlockSize * sizeof(int) + 192;
+
+/** Memory a merge holds whatever the run count: its output chunk and stack. */
+constexpr size_t kMergeFixedBytes = size_t(64) << 10;
+
+/** Most runs one merge into the sink takes within budgetBytes. */
+inline size_t mergeFanIn(size_t budgetBytes)
+{
+    return std::max<size_t>(2, (budgetBytes - kMergeFixedBytes) / kMergeRunBytes);
+}
+
+/**
+ * One merge pass: consecutive runs are grouped as long as their readers
+ * and the encoder of the merged run fit budgetBytes, and each group is
+ * merged into a new run at the end of the spill file. A run too long to
+ * share a group is carried over as it is.
+ * @return the runs after the pass
+ * @throws std::runtime_error when no two runs can be merged within the budget
+ */
+inline std::vector<Run> mergePass(SpillFile &spill, const std::vector<Run> &runs, size_t budgetBytes,
+                                  size_t &peakBytes)
+{
+    const uint8_t *base = spill.mapAll();
+    std::vector<Run> merged;
+    for (size_t first = 0; first < runs.size();)
+    {
+        size_t last = first + 1;
+        uint64_t keys = runs[first].keys;
+        while (last < runs.size() &&
+               kMergeFixedBytes + (last - first + 1) * kMergeRunBytes + encoderBytes(keys + runs[last].keys) <=
+                   budgetBytes)
+            keys += runs[last++].keys;
+        if (last - first == 1)
+        {
+            merged.push_back(runs[first++]);
+            continue;
+        }
+
+        std::vector<packed::Reader> readers;
+        readers.reserve(last - first);
+        for (size_t k = first; k < last; ++k)
+            readers.emplace_back(base + runs[k].offset, runs[k].bytes);
+        uint64_t offset = spill.size();
+        packed::Encoder encoder([&](const uint8_t *p, size_t n) { spill.write(p, n); });
+        packed::mergeStreams(readers, [&](const int *k, size_t n) { encoder.append(k, n); });
+        encoder.finish();
+        merged.push_back({offset, spill.size() - offset, keys});
+        peakBytes = std::max(peakBytes, kMergeFixedBytes + (last - first) * kMergeRunBytes + encoder.memoryBytes());
+        for (size_t k = first; k < last; ++k)
+            spill.release(runs[k].offset, runs[k].bytes);
+        first = last;
+    }
+    if (merged.size() == runs.size())
+        throw std::runtime_error("input too large to merge within the memory budget");
+    return merged;
+}
+
+/** Reads until chunk is full or the source ends; returns the keys read. */
+inline size_t fill(const Source &read, std::vector<int> &chunk)
+{
+    size_t filled = 0;
+    while (filled < chunk.size())
+    {
+        size_t got = read(chunk.data() + filled, chunk.size() - filled);
+        if (got == 0)
+            break;
+        filled += got;
+    }
+    return filled;
+}
+
+} // namespace detail
+
+/**
+ * Sorts the keys from `read` into `write` using at most budgetBytes in
+ * total (keys included, at least kMinStreamBudget). Input that fits is
+ * sorted in memory with whatever the keys leave of the budget; larger
+ * input is sorted externally in chunks. sizeHint, an upper bound on the
+ * number of keys if known, keeps the chunk buffer from outgrowing the input.
+ *
+ * @throws std::invalid_argument for a budget below kMinStreamBudget,
+ *         std::runtime_error when the temporary file cannot be written or
+ *         the runs cannot be merged within the budget
+ */
+inline Report sortStream(const Source &read, const Sink &write, size_t budgetBytes,
+                         size_t sizeHint = std::numeric_limits<size_t>::max(), const std::string &tempDir = {})
+{
+    if (budgetBytes < kMinStreamBudget)
+        throw std::invalid_argument("memory budget below " + std::to_string(kMinStreamBudget >> 20) + " MiB");
+    Report r;
+    r.budgetBytes = budgetBytes;
+
+    // Largest chunk that leaves room for a sort buffer of 1/16 of it, or
+    // for its run encoder once the sort has returned the buffer
+    auto fits = [&](size_t c) {
+        size_t sortBytes = std::min(c / 16, kMaxBufferKeys) * sizeof(int) + detail::kTakeSlack;
+        return c * sizeof(int) + std::max(sortBytes, detail::encoderBytes(c)) <= budgetBytes;
+    };
+    size_t capacity = 1;
+    for (size_t step = size_t(1) << 40; step > 0; step >>= 1)
+        if (fits(capacity + step))
+            capacity += step;
+    // One slot past the hint tells "exactly sizeHint keys" from "more" without another buffer
+    std::vector<int> chunk(sizeHint < capacity ? sizeHint + 1 : capacity);
+    size_t chunkBytes = chunk.capacity() * sizeof(int);
+
+    size_t filled = detail::fill(read, chunk);
+    if (filled < chunk.size())
+    {
+        // Fits: sort in memory with the rest of the budget
+        Report inMemory = sortWithBudget(chunk.data(), filled, budgetBytes - chunkBytes);
+        inMemory.budgetBytes = budgetBytes;
+        inMemory.peakBytes += chunkBytes;
+        if (filled > 0)
+            write(chunk.data(), filled);
+        return inMemory;
+    }
+
+    r.engine = Engine::External;
+    detail::SpillFile spill(tempDir);
+    std::vector<detail::Run> runs;
+    while (filled > 0)
+    {
+        Report sorted = sortWithBudget(chunk.data(), filled, budgetBytes - chunkBytes);
+        if (runs.empty())
+            r.plan = sorted.plan;
+        uint64_t offset = spill.size();
+        packed::Encoder encoder([&](const uint8_t *p, size_t n) { spill.write(p, n); });
+        encoder.append(chunk.data(), filled);
+        encoder.finish();
+        runs.push_back({offset, spill.size() - offset, filled});
+        r.n += filled;
+        r.peakBytes = std::max(r.peakBytes, chunkBytes + std::max(sorted.peakBytes, encoder.memoryBytes()));
+        r.reservedBytes = std::max(r.reservedBytes, sorted.reservedBytes);
+        filled = detail::fill(read, chunk);
+    }
+    std::vector<int>().swap(chunk);
+    r.runs = runs.size();
+
+    while (runs.size() > detail::mergeFanIn(budgetBytes))
+    {
+        runs = detail::mergePass(spill, runs, budgetBytes, r.peakBytes);
+        ++r.mergePasses;
+    }
+
+    const uint8_t *base = spill.mapAll();
+    std::vector<packed::Reader> readers;
+    readers.reserve(runs.size());
+    for (const detail::Run &run : runs)
+        readers.emplace_back(base + run.offset, run.bytes);
+    packed::mergeStreams(readers, [&](const int *keys, size_t n) { write(keys, n); });
+    r.spillBytes = spill.size();
+    r.peakBytes = std::max(r.peakBytes, detail::kMergeFixedBytes + runs.size() * detail::kMergeRunBytes);
+    return r;
+}
+
+} // namespace sv::budget
+
+#endif // SORTVISION_BUDGET_SORT_HPP
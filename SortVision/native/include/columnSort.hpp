@@ -0,0 +1,109 @@
+/**
+ * columnSort.hpp
+ *
+ * Sorting of records stored as a struct of arrays: a std::tuple of
+ * equally long std::vector columns, one element per row.
+ *
+ *     std::tuple<std::vector<int>, std::vector<double>, std::vector<std::string>> table;
+ *     sv::columns::sortColumns<0, 1>(table); // by column 0, then column 1
+ *
+ * The key columns are given as template arguments, most significant first,
+ * so the lexicographic order is fixed at compile time. Keys must be
+ * integers or floating-point numbers; other columns can hold anything
+ * movable.
+ *
+ * The row order is found without touching the records: a row permutation
+ * is radix sorted (argsort.hpp, 8-bit digits) by each key column in turn,
+ * least significant first. Every pass is stable, so ties on a column keep
+ * the order established by the less significant ones. Each pass gathers
+ * its key column through the current permutation once, then sorts cached
+ * (key, row) pairs. Finally every column, keys and payload alike, is moved
+ * to its sorted position exactly once by applyPermutation().
+ */
+#ifndef SORTVISION_COLUMN_SORT_HPP
+#define SORTVISION_COLUMN_SORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "argsort.hpp"
+
+namespace sv::columns {
+
+namespace detail {
+
+/** Stable re-sort of perm by column[perm[i]]. */
+template <typename Key, typename Index>
+void sortByColumn(const std::vector<Key> &column, std::vector<Index> &perm)
+{
+    static_assert(std::is_arithmetic_v<Key>, "key columns must hold integers or floating-point numbers");
+    std::vector<decltype(sv::argsort::detail::radixImage(Key()))> k(perm.size());
+    for (size_t i = 0; i < perm.size(); ++i)
+        k[i] = sv::argsort::detail::radixImage(column[perm[i]]);
+    sv::argsort::detail::radixSortRows(k, perm, sizeof(Key));
+}
+
+template <typename Table, size_t... All>
+size_t checkedRows(const Table &table, std::index_sequence<All...>)
+{
+    size_t rows = std::get<0>(table).size();
+    if (((std::get<All>(table).size() != rows) || ...))
+        throw std::invalid_argument("sortColumns: columns have different lengths");
+    return rows;
+}
+
+// Least significant key first: walks the key list backwards
+template <size_t... Keys, typename Table, typename Index, size_t... K>
+void sortByKeys(const Table &table, std::vector<Index> &perm, std::index_sequence<K...>)
+{
+    constexpr size_t keys[] = {Keys...};
+    (sortByColumn(std::get<keys[sizeof...(Keys) - 1 - K]>(table), perm), ...);
+}
+
+template <typename Index, size_t... Keys, typename... Columns>
+std::vector<Index> columnOrder(const std::tuple<std::vector<Columns>...> &table)
+{
+    static_assert(sizeof...(Keys) > 0, "columnOrder needs at least one key column");
+    static_assert(((Keys < sizeof...(Columns)) && ...), "key column index out of range");
+
+    size_t rows = checkedRows(table, std::index_sequence_for<Columns...>());
+    std::vector<Index> perm = sv::argsort::detail::identity<Index>(rows);
+    if (rows > 1)
+        sortByKeys<Keys...>(table, perm, std::make_index_sequence<sizeof...(Keys)>());
+    return perm;
+}
+
+} // namespace detail
+
+/**
+ * Returns the permutation that orders the rows of `table` by the key
+ * columns Keys... (most significant first); perm[i] is the original row
+ * that belongs at position i. The table is not modified.
+ */
+template <size_t... Keys, typename... Columns>
+std::vector<uint32_t> columnOrder(const std::tuple<std::vector<Columns>...> &table)
+{
+    return detail::columnOrder<uint32_t, Keys...>(table);
+}
+
+/** Sorts the rows of `table` in place by the key columns Keys... */
+template <size_t... Keys, typename... Columns>
+void sortColumns(std::tuple<std::vector<Columns>...> &table)
+{
+    auto reorder = [&](const auto &perm) {
+        std::apply([&](auto &...columns) { sv::argsort::applyPermutation(perm, columns...); }, table);
+    };
+    if (std::get<0>(table).size() <= UINT32_MAX)
+        reorder(detail::columnOrder<uint32_t, Keys...>(table));
+    else
+        reorder(detail::columnOrder<uint64_t, Keys...>(table));
+}
+
+} // namespace sv::columns
+
+#endif // SORTVISION_COLUMN_SORT_HPP
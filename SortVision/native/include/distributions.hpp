@@ -0,0 +1,162 @@
+/**
+ * distributions.hpp
+ *
+ * Input generators shared by the benchmark and calibration tools.
+ *
+ * All generators produce non-negative 32-bit keys so every implementation
+ * in the project (including the C radix sort, which does not handle
+ * negative numbers) can be measured on the same data.
+ */
+#ifndef SORTVISION_DISTRIBUTIONS_HPP
+#define SORTVISION_DISTRIBUTIONS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sv {
+
+enum class Distribution
+{
+    Uniform,      // independent keys in [0, 2^31)
+    Sorted,       // ascending
+    Reversed,     // descending
+    OrganPipe,    // ascending first half, descending second half
+    FewUnique,    // 16 distinct keys
+    Zipf,         // rank-frequency s = 1 over min(n, 2^20) distinct keys
+    NearlySorted  // ascending with 1% of positions swapped at random
+};
+
+inline const std::vector<Distribution> &allDistributions()
+{
+    static const std::vector<Distribution> all = {
+        Distribution::Uniform, Distribution::Sorted, Distribution::Reversed,
+        Distribution::OrganPipe, Distribution::FewUnique, Distribution::Zipf,
+        Distribution::NearlySorted};
+    return all;
+}
+
+inline const char *distributionName(Distribution d)
+{
+    switch (d)
+    {
+    case Distribution::Uniform: return "uniform";
+    case Distribution::Sorted: return "sorted";
+    case Distribution::Reversed: return "reversed";
+    case Distribution::OrganPipe: return "organ-pipe";
+    case Distribution::FewUnique: return "few-unique";
+    case Distribution::Zipf: return "zipf";
+    case Distribution::NearlySorted: return "nearly-sorted";
+    }
+    return "unknown";
+}
+
+/**
+ * Parses a distribution name as printed by distributionName().
+ * @return true on success
+ */
+inline bool parseDistribution(const std::string &name, Distribution &out)
+{
+    for (Distribution d : allDistributions())
+    {
+        if (name == distributionName(d))
+        {
+            out = d;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Fills a vector with n keys drawn from the given distribution.
+ *
+ * @param d    Distribution to draw from
+ * @param n    Number of keys
+ * @param seed Seed for the pseudo-random generator (same seed, same keys)
+ */
+inline std::vector<int> generateInput(Distribution d, size_t n, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<int> keys(n);
+    const int maxKey = INT32_MAX;
+
+    // Evenly spaced ascending keys, used by the ordered distributions
+    auto ascending = [&](size_t i) {
+        return static_cast<int>(n <= 1 ? 0 : (static_cast<double>(i) / (n - 1)) * (maxKey - 1));
+    };
+
+    switch (d)
+    {
+    case Distribution::Uniform:
+    {
+        std::uniform_int_distribution<int> key(0, maxKey - 1);
+        for (int &k : keys)
+            k = key(rng);
+        break;
+    }
+    case Distribution::Sorted:
+        for (size_t i = 0; i < n; ++i)
+            keys[i] = ascending(i);
+        break;
+    case Distribution::Reversed:
+        for (size_t i = 0; i < n; ++i)
+            keys[i] = ascending(n - 1 - i);
+        break;
+    case Distribution::OrganPipe:
+    {
+        size_t half = n / 2;
+        for (size_t i = 0; i < n; ++i)
+            keys[i] = ascending(i < half ? 2 * i : 2 * (n - 1 - i));
+        break;
+    }
+    case Distribution::FewUnique:
+    {
+        std::uniform_int_distribution<int> pick(0, 15);
+        for (int &k : keys)
+            k = pick(rng) * (maxKey / 16);
+        break;
+    }
+    case Distribution::Zipf:
+    {
+        // Inverse-CDF sampling over a bounded universe of ranks
+        size_t universe = std::max<size_t>(1, std::min<size_t>(n, size_t(1) << 20));
+        std::vector<double> cdf(universe);
+        double total = 0.0;
+        for (size_t r = 0; r < universe; ++r)
+        {
+            total += 1.0 / static_cast<double>(r + 1);
+            cdf[r] = total;
+        }
+        std::uniform_real_distribution<double> u(0.0, total);
+        for (int &k : keys)
+        {
+            size_t rank = std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin();
+            rank = std::min(rank, universe - 1);
+            // Scatter ranks over the key space so frequency and order are unrelated
+            k = static_cast<int>((rank * 2654435761ULL) % static_cast<uint64_t>(maxKey));
+        }
+        break;
+    }
+    case Distribution::NearlySorted:
+    {
+        for (size_t i = 0; i < n; ++i)
+            keys[i] = ascending(i);
+        if (n > 1)
+        {
+            std::uniform_int_distribution<size_t> pos(0, n - 1);
+            for (size_t s = 0; s < std::max<size_t>(1, n / 100); ++s)
+                std::swap(keys[pos(rng)], keys[pos(rng)]);
+        }
+        break;
+    }
+    }
+    return keys;
+}
+
+} // namespace sv
+
+#endif // SORTVISION_DISTRIBUTIONS_HPP
@@ -0,0 +1,271 @@
+/**
+ * numaSort.hpp
+ *
+ * NUMA-aware variant of parallelSort() for multi-socket machines.
+ *
+ *     sv::numa::NumaStats st = sv::numa::parallelSortNuma(vec.data(), vec.size());
+ *
+ * The array is cut into one contiguous part per node, sized by the node's
+ * CPU count, and each part's pages are moved to its node (mbind with
+ * MPOL_PREFERRED + MPOL_MF_MOVE). For every node, a leader thread pinned to
+ * the node's CPUs sorts the part with parallelSort(); the threads it starts
+ * inherit the pinning, so the chunk sorts and merge buffers are first
+ * touched on the node that uses them.
+ *
+ * The node runs are then merged pairwise. Output positions keep the
+ * node ownership of the input, so each node writes only the output range
+ * that lives in its own memory. Merge-path splits find the inputs for that
+ * range, and reads cross the interconnect but writes never do. The merge
+ * buffer (from the calling thread's SortWorkspace, like parallelSort's)
+ * is bound the same way as the input before the sort writes to it.
+ *
+ * The topology is read from /sys/devices/system/node and memory policy is
+ * set with the raw mbind system call, so nothing links against libnuma.
+ * On a single node, or when sysfs is unavailable, this is parallelSort().
+ * Failed pinning or mbind calls (containers, seccomp) are reported in
+ * NumaStats and the sort continues unplaced.
+ */
+#ifndef SORTVISION_NUMA_SORT_HPP
+#define SORTVISION_NUMA_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "parallelSort.hpp"
+
+namespace sv::numa {
+
+/** CPUs of every NUMA node that has any, in node order. */
+struct Topology
+{
+    std::vector<int> nodes;             // node ids
+    std::vector<std::vector<int>> cpus; // cpus[k] belong to nodes[k]
+
+    size_t size() const { return nodes.size(); }
+
+    /** Parses a sysfs cpulist such as "0-3,8-11". */
+    static std::vector<int> parseCpuList(const std::string &list)
+    {
+        std::vector<int> out;
+        std::stringstream in(list);
+        std::string range;
+        while (std::getline(in, range, ','))
+        {
+            if (range.empty() || range == "\n")
+                continue;
+            size_t dash = range.find('-');
+            int lo = std::stoi(range.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+            for (int c = lo; c <= hi; ++c)
+                out.push_back(c);
+        }
+        return out;
+    }
+
+    /** The machine's topology, read once. Empty when it cannot be read. */
+    static const Topology &detect()
+    {
+        static const Topology topology = [] {
+            Topology t;
+            std::ifstream online("/sys/devices/system/node/online");
+            std::string list;
+            if (!std::getline(online, list))
+                return t;
+            for (int node : parseCpuList(list))
+            {
+                std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                std::string cpus;
+                std::getline(cpulist, cpus);
+                std::vector<int> ids = parseCpuList(cpus);
+                if (!ids.empty())
+                {
+                    t.nodes.push_back(node);
+                    t.cpus.push_back(std::move(ids));
+                }
+            }
+            return t;
+        }();
+        return topology;
+    }
+};
+
+struct NumaStats
+{
+    size_t nodes = 1;       // nodes the sort ran on (1 = plain parallelSort)
+    bool pinned = true;     // every leader thread was pinned to its node
+    bool placed = true;     // every mbind call succeeded
+};
+
+namespace detail {
+
+/** Pins the calling thread (and threads it starts later) to cpus. */
+inline bool pinThisThread(const std::vector<int> &cpus)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c >= 0 && c < CPU_SETSIZE)
+            CPU_SET(c, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+/**
+ * Prefers `node` for the whole pages inside [p, p + bytes) and moves the
+ * ones already allocated. Partial pages at either end are left alone.
+ */
+inline bool placeOnNode(void *p, size_t bytes, int node)
+{
+#ifdef __linux__
+    uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t lo = (reinterpret_cast<uintptr_t>(p) + page - 1) & ~(page - 1);
+    uintptr_t hi = (reinterpret_cast<uintptr_t>(p) + bytes) & ~(page - 1);
+    if (hi <= lo)
+        return true;
+    constexpr size_t kMaskBits = 8 * sizeof(unsigned long);
+    if (node < 0 || static_cast<size_t>(node) >= 16 * kMaskBits)
+        return false;
+    unsigned long mask[16] = {};
+    mask[node / kMaskBits] = 1UL << (node % kMaskBits);
+    return syscall(SYS_mbind, lo, hi - lo, MPOL_PREFERRED, mask, 16 * kMaskBits + 1, MPOL_MF_MOVE) == 0;
+#else
+    (void)p, (void)bytes, (void)node;
+    return false;
+#endif
+}
+
+/** Runs work(k) for every node k on a leader thread pinned to that node. */
+template <typename Work>
+void onEveryNode(const Topology &topo, NumaStats &stats, Work &&work)
+{
+    std::vector<char> pinned(topo.size(), 0);
+    std::vector<std::thread> leaders;
+    for (size_t k = 0; k < topo.size(); ++k)
+        leaders.emplace_back([&, k] {
+            pinned[k] = pinThisThread(topo.cpus[k]);
+            work(k);
+        });
+    for (std::thread &t : leaders)
+        t.join();
+    for (char p : pinned)
+        stats.pinned = stats.pinned && p;
+}
+
+} // namespace detail
+
+/**
+ * Sorts data[0, n) across the nodes of `topo` (see the file comment).
+ * Arrays shorter than minPerNode elements per node, and single-node
+ * topologies, go to parallelSort() unchanged.
+ */
+template <typename Kernel = void (*)(int *, size_t)>
+NumaStats parallelSortNuma(int *data, size_t n, Kernel kernel = sv::parallel::introKernel,
+                           const Topology &topo = Topology::detect(), size_t minPerNode = size_t(1) << 16)
+{
+    NumaStats stats;
+    size_t nodes = topo.size();
+    if (nodes <= 1 || n < nodes * minPerNode)
+    {
+        sv::parallel::parallelSort(data, n, kernel);
+        return stats;
+    }
+    stats.nodes = nodes;
+
+    // One contiguous part per node, proportional to its CPU count
+    std::vector<size_t> bounds(nodes + 1, 0);
+    size_t totalCpus = 0;
+    for (const std::vector<int> &c : topo.cpus)
+        totalCpus += c.size();
+    for (size_t k = 0, cpus = 0; k < nodes; ++k)
+    {
+        cpus += topo.cpus[k].size();
+        bounds[k + 1] = n * cpus / totalCpus;
+    }
+
+    // The merge buffer comes from the calling thread's workspace (reused,
+    // and huge-page backed when that mode is on) and is placed before the
+    // sort touches it; mbind moves any pages an earlier sort left elsewhere
+    sv::SortWorkspace &ws = sv::SortWorkspace::thisThread();
+    sv::SortWorkspace::Scope scope(ws);
+    int *buffer = ws.take<int>(n);
+    for (size_t k = 0; k < nodes; ++k)
+    {
+        size_t bytes = (bounds[k + 1] - bounds[k]) * sizeof(int);
+        bool input = detail::placeOnNode(data + bounds[k], bytes, topo.nodes[k]);
+        bool scratch = detail::placeOnNode(buffer + bounds[k], bytes, topo.nodes[k]);
+        stats.placed = stats.placed && input && scratch;
+    }
+
+    detail::onEveryNode(topo, stats, [&](size_t k) {
+        unsigned threads = static_cast<unsigned>(topo.cpus[k].size());
+        sv::parallel::parallelSort(data + bounds[k], bounds[k + 1] - bounds[k], kernel, threads);
+    });
+
+    // Pairwise merges of the node runs. Every output range [bounds[k],
+    // bounds[k + 1]) is written by node k, whichever runs feed it.
+    std::vector<size_t> runs(bounds);
+    int *src = data, *dst = buffer;
+    while (runs.size() > 2)
+    {
+        std::vector<size_t> next;
+        for (size_t r = 0; r + 1 < runs.size(); r += 2)
+            next.push_back(runs[r]);
+        next.push_back(n);
+
+        detail::onEveryNode(topo, stats, [&](size_t k) {
+            unsigned threads = static_cast<unsigned>(topo.cpus[k].size());
+            for (size_t r = 0; r + 1 < runs.size(); r += 2)
+            {
+                size_t lo = runs[r], mid = runs[r + 1], hi = r + 2 < runs.size() ? runs[r + 2] : mid;
+                // Part of this pair's output that lies in node k's range
+                size_t d0 = std::max(lo, bounds[k]), d1 = std::min(hi, bounds[k + 1]);
+                if (d0 >= d1)
+                    continue;
+                if (mid == hi) // odd run out: carried over
+                {
+                    std::copy(src + d0, src + d1, dst + d0);
+                    continue;
+                }
+                const int *a = src + lo, *b = src + mid;
+                size_t na = mid - lo, nb = hi - mid;
+                size_t parts = std::max<size_t>(1, threads);
+                sv::parallel::forEachTask(parts, threads, [&](size_t p) {
+                    size_t e0 = d0 - lo + (d1 - d0) * p / parts, e1 = d0 - lo + (d1 - d0) * (p + 1) / parts;
+                    size_t i0 = sv::parallel::mergePathSplit(a, na, b, nb, e0);
+                    size_t i1 = sv::parallel::mergePathSplit(a, na, b, nb, e1);
+                    sv::simd::merge(a + i0, i1 - i0, b + (e0 - i0), (e1 - i1) - (e0 - i0), dst + lo + e0);
+                });
+            }
+        });
+        std::swap(src, dst);
+        runs.swap(next);
+    }
+
+    if (src != data)
+        detail::onEveryNode(topo, stats, [&](size_t k) {
+            std::copy(src + bounds[k], src + bounds[k + 1], data + bounds[k]);
+        });
+    return stats;
+}
+
+} // namespace sv::numa
+
+#endif // SORTVISION_NUMA_SORT_HPP
@@ -0,0 +1,521 @@
+/**
+ * packedInts.hpp
+ *
+ * Compressed storage for sorted int32 arrays: delta coding plus bit
+ * packing in blocks of 128 (frame of reference, SIMD-BP128 layout), with
+ * a block index for random access.
+ *
+ *     std::vector<uint8_t> file = sv::packed::encode(sorted.data(), sorted.size());
+ *
+ *     sv::packed::Reader in(file.data(), file.size());
+ *     int block[sv::packed::kBlockSize];
+ *     for (size_t n; (n = in.next(block)) != 0;)   // streaming decode
+ *         consume(block, n);
+ *     in.at(123456);                               // random access
+ *     in.lowerBound(42);                           // first index with key >= 42
+ *
+ *     sv::packed::mergeStreams(readers, [](const int *keys, size_t n) { ... });
+ *
+ * Layout (native byte order, like the CLI's int32 files):
+ *
+ *     header   "SVPK" | u32 version (1)
+ *     block    i32 first | u8 bits | u8 count - 1 | u16 0 | 16 * bits bytes
+ *       ...    (all blocks hold 128 keys except the last)
+ *     end      a block header with bits = 0xFF
+ *     index    per block: i32 first | u32 0 | u64 byte offset of the block
+ *     trailer  u64 count | u64 blocks | u64 index offset | u32 128 | "SVPE"
+ *
+ * A block stores the differences to the previous key (the first is 0) in
+ * `bits` bits each, just enough for its largest gap. Key i of the block
+ * is in lane i % 4 at slot i / 4: each lane packs its 32 slots into
+ * `bits` words, and the words of the four lanes are interleaved. One SSE2
+ * register then decodes four keys per step, and a prefix sum over the
+ * register restores the keys. Dense sorted data (small gaps) needs a few
+ * bits per key instead of 32.
+ *
+ * Differences are taken modulo 2^32, so unsorted input round-trips too,
+ * but it compresses poorly. lowerBound() needs sorted input.
+ */
+#ifndef SORTVISION_PACKED_INTS_HPP
+#define SORTVISION_PACKED_INTS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "parallelSort.hpp"
+
+namespace sv::packed {
+
+constexpr size_t kBlockSize = 128;
+constexpr uint32_t kVersion = 1;
+constexpr char kMagic[4] = {'S', 'V', 'P', 'K'};
+constexpr char kTrailerMagic[4] = {'S', 'V', 'P', 'E'};
+
+struct BlockHeader
+{
+    int32_t first;
+    uint8_t bits;      // 0..32, or kEndMarker
+    uint8_t countLess; // keys in the block - 1
+    uint16_t reserved;
+};
+
+struct IndexEntry
+{
+    int32_t first;
+    uint32_t reserved;
+    uint64_t offset; // of the BlockHeader, from the start of the stream
+};
+
+struct Trailer
+{
+    uint64_t count;
+    uint64_t blocks;
+    uint64_t indexOffset;
+    uint32_t blockSize;
+    char magic[4];
+};
+
+constexpr uint8_t kEndMarker = 0xFF;
+constexpr size_t kHeaderBytes = 8;
+
+/** True when the bytes start like a packed stream. */
+inline bool isPacked(const void *data, size_t bytes)
+{
+    return bytes >= kHeaderBytes && std::memcmp(data, kMagic, 4) == 0;
+}
+
+namespace detail {
+
+/** Bits needed for the largest gap in v[0, n). */
+inline uint8_t blockBits(const int *v, size_t n)
+{
+    uint32_t all = 0;
+    for (size_t i = 1; i < n; ++i)
+        all |= static_cast<uint32_t>(v[i]) - static_cast<uint32_t>(v[i - 1]);
+    uint8_t bits = 0;
+    for (; all != 0; all >>= 1)
+        ++bits;
+    return bits;
+}
+
+inline size_t blockBytes(uint8_t bits) { return sizeof(BlockHeader) + 16 * size_t(bits); }
+
+/** Encodes v[0, n) (n <= kBlockSize) with `bits` bits per gap at out. */
+inline void encodeBlock(const int *v, size_t n, uint8_t bits, uint8_t *out)
+{
+    BlockHeader h{n > 0 ? v[0] : 0, bits, static_cast<uint8_t>(n - 1), 0};
+    std::memcpy(out, &h, sizeof(h));
+    uint32_t words[4 * 32] = {};
+    for (size_t i = 1; bits > 0 && i < n; ++i)
+    {
+        uint32_t gap = static_cast<uint32_t>(v[i]) - static_cast<uint32_t>(v[i - 1]);
+        size_t lane = i % 4, pos = (i / 4) * bits, w = pos / 32, shift = pos % 32;
+        words[4 * w + lane] |= gap << shift;
+        if (shift + bits > 32)
+            words[4 * (w + 1) + lane] |= gap >> (32 - shift);
+    }
+    std::memcpy(out + sizeof(h), words, 16 * size_t(bits));
+}
+
+/** Decodes a full block of gaps in `words` into out[0, kBlockSize). */
+inline void decodeBlock(const uint8_t *words, uint8_t bits, int32_t first, int *out)
+{
+#ifdef __SSE2__
+    const __m128i *w = reinterpret_cast<const __m128i *>(words);
+    __m128i mask = _mm_set1_epi32(bits == 32 ? -1 : static_cast<int>((uint32_t(1) << bits) - 1));
+    __m128i running = _mm_set1_epi32(first);
+    for (size_t slot = 0; slot < 32; ++slot)
+    {
+        __m128i gaps = _mm_setzero_si128();
+        if (bits > 0)
+        {
+            size_t pos = slot * bits, word = pos / 32, shift = pos % 32;
+            gaps = _mm_srl_epi32(_mm_loadu_si128(w + word), _mm_cvtsi32_si128(static_cast<int>(shift)));
+            if (shift + bits > 32)
+                gaps = _mm_or_si128(gaps, _mm_sll_epi32(_mm_loadu_si128(w + word + 1),
+                                                        _mm_cvtsi32_si128(static_cast<int>(32 - shift))));
+            gaps = _mm_and_si128(gaps, mask);
+        }
+        // Prefix sum across the four lanes, then add the previous key
+        gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 4));
+        gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 8));
+        running = _mm_add_epi32(gaps, _mm_shuffle_epi32(running, _MM_SHUFFLE(3, 3, 3, 3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * slot), running);
+    }
+#else
+    uint32_t w[4 * 32];
+    std::memcpy(w, words, 16 * size_t(bits));
+    uint32_t mask = bits == 32 ? ~uint32_t(0) : (uint32_t(1) << bits) - 1;
+    uint32_t key = static_cast<uint32_t>(first);
+    for (size_t i = 0; i < kBlockSize; ++i)
+    {
+        uint32_t gap = 0;
+        if (bits > 0)
+        {
+            size_t lane = i % 4, pos = (i / 4) * bits, word = pos / 32, shift = pos % 32;
+            gap = w[4 * word + lane] >> shift;
+            if (shift + bits > 32)
+                gap |= w[4 * (word + 1) + lane] << (32 - shift);
+            gap &= mask;
+        }
+        key += gap;
+        out[i] = static_cast<int>(key);
+    }
+#endif
+}
+
+inline void appendBytes(std::vector<uint8_t> &out, const void *p, size_t n)
+{
+    const uint8_t *b = static_cast<const uint8_t *>(p);
+    out.insert(out.end(), b, b + n);
+}
+
+/** End marker, index and trailer for blocks already written up to `offset`. */
+inline void appendFooter(std::vector<uint8_t> &out, const std::vector<IndexEntry> &index, uint64_t count,
+                         uint64_t offset)
+{
+    BlockHeader end{0, kEndMarker, 0, 0};
+    appendBytes(out, &end, sizeof(end));
+    Trailer t{count, index.size(), offset + sizeof(end), static_cast<uint32_t>(kBlockSize), {}};
+    std::memcpy(t.magic, kTrailerMagic, 4);
+    appendBytes(out, index.data(), index.size() * sizeof(IndexEntry));
+    appendBytes(out, &t, sizeof(t));
+}
+
+} // namespace detail
+
+/**
+ * Encodes v[0, n) in one call, with the blocks sized and filled on
+ * `threads` threads (0 = all hardware threads).
+ */
+inline std::vector<uint8_t> encode(const int *v, size_t n, unsigned threads = 0)
+{
+    size_t blocks = (n + kBlockSize - 1) / kBlockSize;
+    std::vector<uint8_t> bits(blocks);
+    size_t tasks = std::max<size_t>(1, std::min<size_t>(blocks / 1024, threads == 0 ? 64 : threads));
+    auto blockRange = [&](size_t t) { return std::make_pair(blocks * t / tasks, blocks * (t + 1) / tasks); };
+    parallel::forEachTask(tasks, threads, [&](size_t t) {
+        for (size_t b = blockRange(t).first; b < blockRange(t).second; ++b)
+            bits[b] = detail::blockBits(v + b * kBlockSize, std::min(kBlockSize, n - b * kBlockSize));
+    });
+
+    std::vector<IndexEntry> index(blocks);
+    uint64_t offset = kHeaderBytes;
+    for (size_t b = 0; b < blocks; ++b)
+    {
+        index[b] = {v[b * kBlockSize], 0, offset};
+        offset += detail::blockBytes(bits[b]);
+    }
+
+    std::vector<uint8_t> out(offset);
+    std::memcpy(out.data(), kMagic, 4);
+    std::memcpy(out.data() + 4, &kVersion, 4);
+    parallel::forEachTask(tasks, threads, [&](size_t t) {
+        for (size_t b = blockRange(t).first; b < blockRange(t).second; ++b)
+            detail::encodeBlock(v + b * kBlockSize, std::min(kBlockSize, n - b * kBlockSize), bits[b],
+                                out.data() + index[b].offset);
+    });
+    detail::appendFooter(out, index, n, offset);
+    return out;
+}
+
+/**
+ * Incremental encoder for output produced piece by piece (e.g. a merge).
+ * Encoded bytes go to `sink` in chunks of about 1 MiB, and the rest goes
+ * out on finish().
+ */
+class Encoder
+{
+public:
+    using Sink = std::function<void(const uint8_t *, size_t)>;
+
+    explicit Encoder(Sink sink) : sink(std::move(sink))
+    {
+        detail::appendBytes(buffer, kMagic, 4);
+        detail::appendBytes(buffer, &kVersion, 4);
+    }
+
+    void append(const int *v, size_t n)
+    {
+        while (n > 0)
+        {
+            size_t take = std::min(n, kBlockSize - pendingCount);
+            std::copy(v, v + take, pending + pendingCount);
+            pendingCount += take;
+            v += take;
+            n -= take;
+            if (pendingCount == kBlockSize)
+                flushBlock();
+        }
+    }
+
+    /** Writes the last block, the index and the trailer. */
+    void finish()
+    {
+        if (pendingCount > 0)
+            flushBlock();
+        detail::appendFooter(buffer, index, count, flushed + buffer.size());
+        sink(buffer.data(), buffer.size());
+        flushed += buffer.size();
+        buffer.clear();
+    }
+
+    uint64_t bytesWritten() const { return flushed; }
+
+    /** Heap bytes held by the output buffer and the block index. */
+    size_t memoryBytes() const { return buffer.capacity() + index.capacity() * sizeof(IndexEntry); }
+
+private:
+    Sink sink;
+    std::vector<uint8_t> buffer;
+    std::vector<IndexEntry> index;
+    int pending[kBlockSize];
+    size_t pendingCount = 0;
+    uint64_t count = 0;
+    uint64_t flushed = 0; // bytes already handed to the sink
+
+    void flushBlock()
+    {
+        uint8_t bits = detail::blockBits(pending, pendingCount);
+        index.push_back({pending[0], 0, flushed + buffer.size()});
+        size_t at = buffer.size();
+        buffer.resize(at + detail::blockBytes(bits));
+        detail::encodeBlock(pending, pendingCount, bits, buffer.data() + at);
+        count += pendingCount;
+        pendingCount = 0;
+        if (buffer.size() >= (size_t(1) << 20))
+        {
+            sink(buffer.data(), buffer.size());
+            flushed += buffer.size();
+            buffer.clear();
+        }
+    }
+};
+
+/** Decoder over a complete packed stream in memory (e.g. an mmap'ed file). */
+class Reader
+{
+public:
+    /** @throws std::runtime_error when the bytes are not a valid packed stream */
+    Reader(const void *data, size_t bytes) : base(static_cast<const uint8_t *>(data)), size(bytes)
+    {
+        uint32_t version = 0;
+        if (!isPacked(data, bytes) || bytes < kHeaderBytes + sizeof(Trailer))
+            throw std::runtime_error("not a packed int stream");
+        std::memcpy(&version, base + 4, 4);
+        std::memcpy(&trailer, base + bytes - sizeof(Trailer), sizeof(Trailer));
+        if (version != kVersion || std::memcmp(trailer.magic, kTrailerMagic, 4) != 0 ||
+            trailer.blockSize != kBlockSize || trailer.indexOffset > bytes - sizeof(Trailer) ||
+            trailer.blocks != (bytes - sizeof(Trailer) - trailer.indexOffset) / sizeof(IndexEntry) ||
+            trailer.count > trailer.blocks * kBlockSize || trailer.count + kBlockSize <= trailer.blocks * kBlockSize)
+            throw std::runtime_error("corrupt packed int stream");
+        cursor = kHeaderBytes;
+    }
+
+    /** Keys in the stream. */
+    uint64_t count() const { return trailer.count; }
+    size_t blocks() const { return static_cast<size_t>(trailer.blocks); }
+
+    /**
+     * Decodes the next block into out (room for kBlockSize keys).
+     * @return keys decoded, 0 at the end of the stream
+     */
+    size_t next(int *out)
+    {
+        BlockHeader h = header(cursor);
+        if (h.bits == kEndMarker)
+            return 0;
+        size_t n = decodeAt(cursor, h, out);
+        cursor += detail::blockBytes(h.bits);
+        return n;
+    }
+
+    /** Starts next() from the first block again. */
+    void rewind() { cursor = kHeaderBytes; }
+
+    /** Decodes block b into out; returns its key count. */
+    size_t block(size_t b, int *out) const
+    {
+        uint64_t at = entry(b).offset;
+        return decodeAt(at, header(at), out);
+    }
+
+    /** Key i (0 <= i < count()), decoding one block. */
+    int at(uint64_t i) const
+    {
+        if (i >= trailer.count)
+            throw std::out_of_range("packed::Reader::at");
+        int keys[kBlockSize];
+        block(static_cast<size_t>(i / kBlockSize), keys);
+        return keys[i % kBlockSize];
+    }
+
+    /** First index whose key is >= key, in sorted streams (binary search on the index, then one block). */
+    uint64_t lowerBound(int key) const
+    {
+        size_t lo = 0, hi = blocks(); // first block whose first key is >= key
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (entry(mid).first < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo == 0)
+            return 0;
+        int keys[kBlockSize];
+        size_t n = block(lo - 1, keys);
+        return (lo - 1) * kBlockSize + static_cast<uint64_t>(std::lower_bound(keys, keys + n, key) - keys);
+    }
+
+private:
+    const uint8_t *base;
+    size_t size;
+    Trailer trailer;
+    uint64_t cursor;
+
+    IndexEntry entry(size_t b) const
+    {
+        IndexEntry e;
+        std::memcpy(&e, base + trailer.indexOffset + b * sizeof(IndexEntry), sizeof(e));
+        return e;
+    }
+
+    BlockHeader header(uint64_t at) const
+    {
+        BlockHeader h;
+        if (at + sizeof(h) > trailer.indexOffset)
+            throw std::runtime_error("corrupt packed int stream");
+        std::memcpy(&h, base + at, sizeof(h));
+        return h;
+    }
+
+    size_t decodeAt(uint64_t at, const BlockHeader &h, int *out) const
+    {
+        size_t n = size_t(h.countLess) + 1;
+        if ((h.bits > 32 && h.bits != kEndMarker) || n > kBlockSize ||
+            at + detail::blockBytes(h.bits) > trailer.indexOffset)
+            throw std::runtime_error("corrupt packed int stream");
+        if (n == kBlockSize)
+        {
+            detail::decodeBlock(base + at + sizeof(h), h.bits, h.first, out);
+        }
+        else
+        {
+            int keys[kBlockSize];
+            detail::decodeBlock(base + at + sizeof(h), h.bits, h.first, keys);
+            std::copy(keys, keys + n, out);
+        }
+        return n;
+    }
+};
+
+/**
+ * Decodes a whole stream into out (room for in.count() keys), one block
+ * per task on `threads` threads.
+ * @throws std::runtime_error unless every block but the last holds
+ *         kBlockSize keys and the last one holds the rest of count()
+ */
+inline void decode(const Reader &in, int *out, unsigned threads = 0)
+{
+    size_t blocks = in.blocks();
+    if (blocks == 0)
+        return;
+    std::atomic<bool> corrupt{false};
+    parallel::forEachTask(blocks - 1, threads, [&](size_t b) {
+        try
+        {
+            if (in.block(b, out + b * kBlockSize) != kBlockSize)
+                corrupt = true;
+        }
+        catch (const std::runtime_error &)
+        {
+            corrupt = true; // rethrown below: an exception must not leave a worker thread
+        }
+    });
+    if (corrupt)
+        throw std::runtime_error("corrupt packed int stream");
+    // The last block goes through a buffer, so a wrong count cannot write past out
+    int last[kBlockSize];
+    size_t rest = static_cast<size_t>(in.count() - (blocks - 1) * kBlockSize);
+    if (in.block(blocks - 1, last) != rest)
+        throw std::runtime_error("corrupt packed int stream");
+    std::copy(last, last + rest, out + (blocks - 1) * kBlockSize);
+}
+
+/**
+ * k-way merge of sorted packed streams. Each input is decoded one block at
+ * a time, so memory stays at one block per input however long the
+ * streams are. The merged keys go to out(const int *keys, size_t n) in
+ * chunks of up to 4096.
+ */
+template <typename Out>
+void mergeStreams(std::vector<Reader> &inputs, Out &&out)
+{
+    struct Cursor
+    {
+        int keys[kBlockSize];
+        size_t pos = 0, n = 0;
+    };
+    std::vector<Cursor> cursors(inputs.size());
+    // Min-heap of (head key, input)
+    using Head = std::pair<int, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t k = 0; k < inputs.size(); ++k)
+    {
+        inputs[k].rewind();
+        cursors[k].n = inputs[k].next(cursors[k].keys);
+        if (cursors[k].n > 0)
+            heads.push({cursors[k].keys[0], k});
+    }
+
+    int chunk[4096];
+    size_t filled = 0;
+    while (!heads.empty())
+    {
+        size_t k = heads.top().second;
+        heads.pop();
+        Cursor &c = cursors[k];
+        // Take every key of this input up to the next input's head at once
+        int limit = heads.empty() ? c.keys[c.n - 1] : heads.top().first;
+        do
+        {
+            chunk[filled++] = c.keys[c.pos++];
+            if (filled == sizeof(chunk) / sizeof(chunk[0]))
+            {
+                out(static_cast<const int *>(chunk), filled);
+                filled = 0;
+            }
+            if (c.pos == c.n)
+            {
+                c.n = inputs[k].next(c.keys);
+                c.pos = 0;
+                if (c.n == 0)
+                    break;
+                if (heads.empty())
+                    limit = c.keys[c.n - 1];
+            }
+        } while (c.keys[c.pos] <= limit);
+        if (c.n > 0)
+            heads.push({c.keys[c.pos], k});
+    }
+    if (filled > 0)
+        out(static_cast<const int *>(chunk), filled);
+}
+
+} // namespace sv::packed
+
+#endif // SORTVISION_PACKED_INTS_HPP
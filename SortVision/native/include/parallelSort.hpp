@@ -0,0 +1,212 @@
+/**
+ * parallelSort.hpp
+ *
+ * Multi-threaded engines built from the sequential C++ implementations.
+ *
+ * parallelSort() splits the array into one chunk per thread, sorts the
+ * chunks concurrently with a sequential kernel, then merges runs
+ * pairwise. Every merge is itself split across threads with merge-path
+ * partitioning, so the last rounds (few, long runs) still use all cores.
+ * The default kernel is the three-way introsort, which stays O(n log n)
+ * on duplicate-heavy chunks where the Lomuto quick sort goes quadratic.
+ *
+ * sortSegments() sorts many independent arrays as one job, handing
+ * segments to threads in largest-first order.
+ *
+ *     sv::parallel::parallelSort(vec.data(), vec.size());
+ *     sv::parallel::parallelSort(vec.data(), vec.size(), sv::parallel::heapKernel, 8);
+ */
+#ifndef SORTVISION_PARALLEL_SORT_HPP
+#define SORTVISION_PARALLEL_SORT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "algorithms.hpp"
+
+namespace sv::parallel {
+
+/** Number of hardware threads (at least 1). */
+inline unsigned defaultThreads()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * Runs task(k) for every k in [0, tasks) on up to `threads` threads
+ * (the calling thread included). Tasks are claimed dynamically.
+ */
+template <typename Task>
+void forEachTask(size_t tasks, unsigned threads, Task &&task)
+{
+    size_t workers = std::min<size_t>(threads == 0 ? defaultThreads() : threads, tasks);
+    if (workers <= 1)
+    {
+        for (size_t k = 0; k < tasks; ++k)
+            task(k);
+        return;
+    }
+    std::atomic<size_t> nextTask{0};
+    auto work = [&] {
+        for (size_t k; (k = nextTask.fetch_add(1, std::memory_order_relaxed)) < tasks;)
+            task(k);
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w)
+        pool.emplace_back(work);
+    work();
+    for (std::thread &t : pool)
+        t.join();
+}
+
+// Sequential kernels usable by parallelSort and sortSegments
+inline void quickKernel(int *data, size_t n)
+{
+    if (n > 1)
+        impl::quick::quickSort(data, 0, static_cast<ptrdiff_t>(n) - 1);
+}
+
+inline void heapKernel(int *data, size_t n)
+{
+    impl::heap::heapSort(data, n);
+}
+
+// Three-way introsort: safe on duplicate-heavy or adversarial input
+inline void introKernel(int *data, size_t n)
+{
+    if (n > 1)
+        impl::quick::introSort(data, 0, static_cast<ptrdiff_t>(n) - 1, impl::quick::selectBudget(n));
+}
+
+/**
+ * Merge path: number of elements taken from `a` among the first `diagonal`
+ * outputs of merging a and b (ties go to a, so the merge stays stable).
+ */
+inline size_t mergePathSplit(const int *a, size_t na, const int *b, size_t nb, size_t diagonal)
+{
+    size_t lo = diagonal > nb ? diagonal - nb : 0;
+    size_t hi = std::min(diagonal, na);
+    while (lo < hi)
+    {
+        size_t i = lo + (hi - lo) / 2; // candidate count taken from a
+        if (a[i] <= b[diagonal - i - 1])
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+/**
+ * Merges sorted a and b into out using up to `parts` independent pieces.
+ */
+inline void parallelMerge(const int *a, size_t na, const int *b, size_t nb, int *out, size_t parts,
+                          unsigned threads)
+{
+    size_t total = na + nb;
+    parts = std::max<size_t>(1, std::min(parts, total));
+    forEachTask(parts, threads, [&](size_t p) {
+        size_t d0 = total * p / parts, d1 = total * (p + 1) / parts;
+        size_t i0 = mergePathSplit(a, na, b, nb, d0), i1 = mergePathSplit(a, na, b, nb, d1);
+        sv::simd::merge(a + i0, i1 - i0, b + (d0 - i0), (d1 - i1) - (d0 - i0), out + d0);
+    });
+}
+
+/**
+ * Sorts data[0, n) on `threads` threads (0 = all hardware threads).
+ * Arrays shorter than 2 * minChunk are sorted by kernel on the calling
+ * thread. Uses one temporary buffer of n ints from the calling thread's
+ * SortWorkspace.
+ */
+template <typename Kernel = void (*)(int *, size_t)>
+void parallelSort(int *data, size_t n, Kernel kernel = introKernel, unsigned threads = 0,
+                  size_t minChunk = size_t(1) << 15)
+{
+    if (threads == 0)
+        threads = defaultThreads();
+    size_t chunks = std::min<size_t>(threads, n / std::max<size_t>(1, minChunk));
+    if (chunks <= 1)
+    {
+        kernel(data, n);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t k = 0; k <= chunks; ++k)
+        bounds[k] = n * k / chunks;
+    forEachTask(chunks, threads, [&](size_t k) { kernel(data + bounds[k], bounds[k + 1] - bounds[k]); });
+
+    sv::SortWorkspace &ws = sv::SortWorkspace::thisThread();
+    sv::SortWorkspace::Scope scope(ws);
+    int *src = data, *dst = ws.take<int>(n);
+    while (bounds.size() > 2)
+    {
+        size_t runs = bounds.size() - 1;
+        size_t pairs = runs / 2;
+        size_t partsPerPair = std::max<size_t>(1, threads / pairs);
+        std::vector<size_t> next;
+        next.reserve(pairs + 2);
+        for (size_t r = 0; r < runs; r += 2)
+        {
+            next.push_back(bounds[r]);
+            if (r + 1 == runs) // odd run out: carried over unchanged
+                std::copy(src + bounds[r], src + bounds[r + 1], dst + bounds[r]);
+        }
+        next.push_back(n);
+        forEachTask(pairs, threads, [&](size_t p) {
+            size_t lo = bounds[2 * p], mid = bounds[2 * p + 1], hi = bounds[2 * p + 2];
+            parallelMerge(src + lo, mid - lo, src + mid, hi - mid, dst + lo, partsPerPair,
+                          static_cast<unsigned>(partsPerPair));
+        });
+        std::swap(src, dst);
+        bounds.swap(next);
+    }
+    if (src != data)
+        std::copy(src, src + n, data);
+}
+
+/** One independent array in a segmented job. */
+struct Segment
+{
+    int *data;
+    size_t size;
+};
+
+/**
+ * Sorts every segment independently. Jobs below `minParallel` total
+ * elements run on the calling thread; larger ones are spread over
+ * `threads` threads, longest segments first.
+ */
+template <typename Kernel = void (*)(int *, size_t)>
+void sortSegments(const std::vector<Segment> &segments, Kernel kernel = introKernel, unsigned threads = 0,
+                  size_t minParallel = size_t(1) << 16)
+{
+    size_t total = 0;
+    for (const Segment &s : segments)
+        total += s.size;
+    if (total < minParallel || segments.size() < 2)
+    {
+        for (const Segment &s : segments)
+            kernel(s.data, s.size);
+        return;
+    }
+
+    std::vector<size_t> order(segments.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(),
+              [&](size_t x, size_t y) { return segments[x].size > segments[y].size; });
+    forEachTask(order.size(), threads, [&](size_t k) {
+        const Segment &s = segments[order[k]];
+        kernel(s.data, s.size);
+    });
+}
+
+} // namespace sv::parallel
+
+#endif // SORTVISION_PARALLEL_SORT_HPP
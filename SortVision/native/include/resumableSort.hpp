@@ -0,0 +1,344 @@
+/**
+ * resumableSort.hpp
+ *
+ * Quick, merge and heap sort as C++20 coroutines that run in bounded time
+ * slices, the native counterpart of the visualizer's async sorts with
+ * shouldStopRef.
+ *
+ *     sv::resumable::SortTask task = sv::resumable::quickSort(data, n, {1 << 20});
+ *     while (!task.resume())       // sorts for one slice, then returns
+ *         serviceOtherRequests();
+ *
+ *     task.cancel();               // or stop early: data stays a permutation
+ *
+ * A slice ends after `operations` compare/move steps or, when `time` is
+ * set, once that much wall time has passed (the clock is read every 1024
+ * steps). The sorts follow the repository implementations, iteratively so
+ * that all state lives in one coroutine frame:
+ *  - quickSort: three-way partition around a median-of-three pivot
+ *    (partition3 in quickSort.cpp), explicit stack, smaller side first;
+ *    keys equal to the pivot are finished in one pass
+ *  - mergeSort: bottom-up merging between the array and one buffer
+ *  - heapSort:  build a max-heap, then extract (heapSort.cpp); every sift
+ *    level is a step, so input that is already heap-ordered still yields
+ *
+ * cancel() lets the sort stop at its next step and leaves every key in
+ * `data` (merge sort copies its buffer back if it was mid-pass). Destroying
+ * an unfinished task cancels it.
+ *
+ * Requires C++20 (-std=c++20); the rest of native/ stays C++17.
+ */
+#ifndef SORTVISION_RESUMABLE_SORT_HPP
+#define SORTVISION_RESUMABLE_SORT_HPP
+
+#if __cplusplus < 202002L
+#error "resumableSort.hpp needs C++20 coroutines (-std=c++20)"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sv::resumable {
+
+/** When a slice ends: whichever limit is reached first. */
+struct SliceBudget
+{
+    uint64_t operations = uint64_t(1) << 16; // compare/move steps per slice
+    std::chrono::nanoseconds time{0};        // 0 = no time limit
+};
+
+/** A sort in progress. Move-only; resume() runs it for one slice. */
+class SortTask
+{
+public:
+    struct promise_type
+    {
+        bool cancelRequested = false;
+        uint64_t operations = 0;
+        std::exception_ptr error;
+
+        SortTask get_return_object() { return SortTask(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    SortTask(SortTask &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    SortTask &operator=(SortTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            finish();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~SortTask() { finish(); }
+
+    /**
+     * Runs until the slice ends or the sort completes.
+     * @return true once the sort is finished (or was cancelled)
+     */
+    bool resume()
+    {
+        if (done())
+            return true;
+        handle.resume();
+        if (handle.promise().error)
+            std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+        return handle.done();
+    }
+
+    /** Stops the sort at its next step; the array keeps all its keys. */
+    void cancel()
+    {
+        if (done())
+            return;
+        handle.promise().cancelRequested = true;
+        handle.resume();
+    }
+
+    bool done() const { return !handle || handle.done(); }
+    bool cancelled() const { return handle && handle.promise().cancelRequested; }
+
+    /** Compare/move steps performed so far. */
+    uint64_t operations() const { return handle ? handle.promise().operations : 0; }
+
+private:
+    Handle handle;
+
+    explicit SortTask(Handle h) : handle(h) {}
+
+    void finish()
+    {
+        if (!handle)
+            return;
+        cancel();
+        handle.destroy();
+        handle = nullptr;
+    }
+};
+
+namespace detail {
+
+/** Counts steps and decides when a slice is over. */
+class Slice
+{
+public:
+    explicit Slice(SliceBudget budget)
+        : budget(budget), interval(budget.time.count() > 0 ? std::min(kClockEvery, budget.operations)
+                                                            : budget.operations),
+          left(std::max<uint64_t>(1, interval))
+    {
+        interval = left;
+    }
+
+    /** Counts one step; true when the slice is over. */
+    bool step(SortTask::promise_type &p)
+    {
+        ++p.operations;
+        if (--left != 0)
+            return false;
+        left = interval;
+        sinceStart += interval;
+        return sinceStart >= budget.operations ||
+               (budget.time.count() > 0 && Clock::now() - start >= budget.time);
+    }
+
+    /** Starts a new slice (on every resume). */
+    void begin()
+    {
+        sinceStart = 0;
+        if (budget.time.count() > 0)
+            start = Clock::now();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint64_t kClockEvery = 1024;
+
+    SliceBudget budget;
+    uint64_t interval; // steps between checks
+    uint64_t left;
+    uint64_t sinceStart = 0;
+    Clock::time_point start;
+};
+
+/** Suspends the sort; resumes with false when it was cancelled meanwhile. */
+struct Yield
+{
+    SortTask::promise_type *promise = nullptr;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(SortTask::Handle h) noexcept { promise = &h.promise(); }
+    bool await_resume() const noexcept { return !promise->cancelRequested; }
+};
+
+/** Gives the coroutine access to its own promise. */
+struct GetPromise
+{
+    SortTask::promise_type *promise = nullptr;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(SortTask::Handle h) noexcept
+    {
+        promise = &h.promise();
+        return false; // continue immediately
+    }
+    SortTask::promise_type &await_resume() const noexcept { return *promise; }
+};
+
+} // namespace detail
+
+// One step: count it and yield when the slice is over. Ends the sort
+// (after `onCancel`) when cancel() was called while suspended.
+#define SV_RESUMABLE_STEP(onCancel)                                                                                    \
+    if (slice.step(promise))                                                                                           \
+    {                                                                                                                  \
+        if (!co_await detail::Yield{})                                                                                 \
+        {                                                                                                              \
+            onCancel;                                                                                                  \
+            co_return;                                                                                                 \
+        }                                                                                                              \
+        slice.begin();                                                                                                 \
+    }
+
+/** Quick sort of data[0, n) in slices. */
+inline SortTask quickSort(int *data, size_t n, SliceBudget budget = SliceBudget())
+{
+    SortTask::promise_type &promise = co_await detail::GetPromise{};
+    if (promise.cancelRequested)
+        co_return;
+    detail::Slice slice(budget);
+    slice.begin();
+
+    std::vector<std::pair<ptrdiff_t, ptrdiff_t>> stack;
+    if (n > 1)
+        stack.emplace_back(0, static_cast<ptrdiff_t>(n) - 1);
+    while (!stack.empty())
+    {
+        auto [low, high] = stack.back();
+        stack.pop_back();
+        while (low < high)
+        {
+            ptrdiff_t mid = low + (high - low) / 2;
+            if (data[mid] < data[low])
+                std::swap(data[mid], data[low]);
+            if (data[high] < data[low])
+                std::swap(data[high], data[low]);
+            if (data[high] < data[mid])
+                std::swap(data[high], data[mid]);
+            int pivot = data[mid]; // median of three
+            // data[low, lt) < pivot, data[lt, i) == pivot, data(gt, high] > pivot
+            ptrdiff_t lt = low, i = low, gt = high;
+            while (i <= gt)
+            {
+                if (data[i] < pivot)
+                    std::swap(data[lt++], data[i++]);
+                else if (pivot < data[i])
+                    std::swap(data[i], data[gt--]);
+                else
+                    ++i;
+                SV_RESUMABLE_STEP((void)0)
+            }
+            // Continue with the smaller side, defer the larger one
+            if (lt - low < high - gt)
+            {
+                stack.emplace_back(gt + 1, high);
+                high = lt - 1;
+            }
+            else
+            {
+                stack.emplace_back(low, lt - 1);
+                low = gt + 1;
+            }
+        }
+    }
+}
+
+/** Bottom-up merge sort of data[0, n) in slices; uses a buffer of n ints. */
+inline SortTask mergeSort(int *data, size_t n, SliceBudget budget = SliceBudget())
+{
+    SortTask::promise_type &promise = co_await detail::GetPromise{};
+    if (promise.cancelRequested || n < 2)
+        co_return;
+    detail::Slice slice(budget);
+    slice.begin();
+
+    std::unique_ptr<int[]> buffer(new int[n]);
+    int *src = data, *dst = buffer.get();
+    for (size_t width = 1; width < n; width *= 2)
+    {
+        for (size_t lo = 0; lo < n; lo += 2 * width)
+        {
+            size_t mid = std::min(lo + width, n), hi = std::min(lo + 2 * width, n);
+            size_t i = lo, j = mid, k = lo;
+            while (k < hi)
+            {
+                dst[k++] = (j >= hi || (i < mid && src[i] <= src[j])) ? src[i++] : src[j++];
+                // When cancelled while writing into data, the buffer holds
+                // the last complete pass
+                SV_RESUMABLE_STEP((dst == data ? (void)std::copy(src, src + n, data) : (void)0))
+            }
+        }
+        std::swap(src, dst);
+    }
+    if (src != data)
+        std::copy(src, src + n, data);
+}
+
+/** Heap sort of data[0, n) in slices. */
+inline SortTask heapSort(int *data, size_t n, SliceBudget budget = SliceBudget())
+{
+    SortTask::promise_type &promise = co_await detail::GetPromise{};
+    if (promise.cancelRequested || n < 2)
+        co_return;
+    detail::Slice slice(budget);
+    slice.begin();
+
+    // Phase 1 builds the max-heap (roots n/2-1 .. 0), phase 2 extracts
+    for (size_t phase = 0; phase < 2; ++phase)
+    {
+        size_t count = phase == 0 ? n / 2 : n - 1;
+        for (size_t step = 0; step < count; ++step)
+        {
+            size_t size = n, root = n / 2 - 1 - step;
+            if (phase == 1)
+            {
+                size = n - 1 - step;
+                std::swap(data[0], data[size]);
+                root = 0;
+            }
+            // Sift data[root] down within data[0, size); each level is a
+            // step, including the last one that finds the heap in order
+            while (true)
+            {
+                SV_RESUMABLE_STEP((void)0)
+                size_t largest = root, left = 2 * root + 1, right = left + 1;
+                if (left < size && data[left] > data[largest])
+                    largest = left;
+                if (right < size && data[right] > data[largest])
+                    largest = right;
+                if (largest == root)
+                    break;
+                std::swap(data[root], data[largest]);
+                root = largest;
+            }
+        }
+    }
+}
+
+#undef SV_RESUMABLE_STEP
+
+} // namespace sv::resumable
+
+#endif // SORTVISION_RESUMABLE_SORT_HPP
@@ -0,0 +1,196 @@
+/**
+ * segmentedSort.hpp
+ *
+ * Sorts many independent small arrays stored back to back in one buffer.
+ *
+ *     std::vector<int> keys = ...;             // all segments, concatenated
+ *     std::vector<uint32_t> offsets = ...;     // segment s is keys[offsets[s], offsets[s + 1])
+ *     sv::segmented::sortSegmented(keys, offsets);
+ *
+ * Segments are grouped by size class in one pass over the offsets, and
+ * each class is sorted with the engine that suits it:
+ *
+ *   size <= 32              sorting network (sortingNetwork.hpp)
+ *   size <= smallMax        quick sort (fastest engine at these sizes, see
+ *                           AutoThresholds::smallInputMax)
+ *   larger                  heap sort while cache resident (robust to the
+ *                           duplicates and runs that degrade quick sort),
+ *                           sortAuto() beyond AutoThresholds::cacheResidentMax
+ *
+ * Within a class, consecutive segments are packed into tasks of about
+ * `grain` elements, so a task walks one contiguous stretch of the buffer
+ * and calls the same kernel every time. Large segments get a task each,
+ * longest first. Tasks run on `threads` threads once the job holds at
+ * least `minParallel` elements. Bookkeeping lives in the calling thread's
+ * SortWorkspace, so repeated calls do not allocate (except for segments
+ * past cacheResidentMax, which sortAuto sorts in a copy).
+ */
+#ifndef SORTVISION_SEGMENTED_SORT_HPP
+#define SORTVISION_SEGMENTED_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "parallelSort.hpp"
+#include "sortAuto.hpp"
+#include "sortingNetwork.hpp"
+
+namespace sv::segmented {
+
+struct SegmentedOptions
+{
+    unsigned threads = 0;                  // 0 = all hardware threads
+    size_t minParallel = size_t(1) << 16;  // fewer elements: run on the calling thread
+    size_t grain = size_t(1) << 14;        // elements per task for network and small segments
+    size_t smallMax = AutoThresholds().smallInputMax;
+};
+
+/** Number of segments sorted by each engine. */
+struct SegmentedStats
+{
+    size_t network = 0;
+    size_t small = 0;
+    size_t large = 0;
+};
+
+namespace detail {
+
+enum SizeClass : uint8_t
+{
+    kNetwork,
+    kSmall,
+    kLarge,
+    kClasses
+};
+
+struct Task
+{
+    uint8_t sizeClass;
+    size_t first, last; // range in the class's segment list
+};
+
+inline void sortLarge(int *data, size_t n)
+{
+    if (n <= AutoThresholds().cacheResidentMax)
+    {
+        sv::parallel::heapKernel(data, n);
+        return;
+    }
+    // sortAuto works on vectors; at this size the copy costs little next
+    // to the sort
+    std::vector<int> segment(data, data + n);
+    sortAuto(segment);
+    std::copy(segment.begin(), segment.end(), data);
+}
+
+} // namespace detail
+
+/**
+ * Sorts data[offsets[s], offsets[s + 1]) for every s < segments.
+ * offsets must be non-decreasing; gaps between segments are left alone.
+ */
+template <typename Offset>
+SegmentedStats sortSegmented(int *data, const Offset *offsets, size_t segments,
+                             const SegmentedOptions &opt = SegmentedOptions())
+{
+    using namespace detail;
+    SegmentedStats stats;
+    if (segments == 0)
+        return stats;
+
+    auto sizeOf = [&](size_t s) { return static_cast<size_t>(offsets[s + 1] - offsets[s]); };
+    auto classOf = [&](size_t n) {
+        return n <= sv::network::kMaxSize ? kNetwork : n <= opt.smallMax ? kSmall : kLarge;
+    };
+
+    // Pass 1: validate and count segments and elements per class
+    size_t counts[kClasses] = {}, elements[kClasses] = {};
+    for (size_t s = 0; s < segments; ++s)
+    {
+        if (offsets[s + 1] < offsets[s])
+            throw std::invalid_argument("sortSegmented: offsets must be non-decreasing");
+        size_t n = sizeOf(s);
+        ++counts[classOf(n)];
+        elements[classOf(n)] += n;
+    }
+    stats.network = counts[kNetwork];
+    stats.small = counts[kSmall];
+    stats.large = counts[kLarge];
+
+    // Pass 2: segment lists per class, in buffer order
+    sv::SortWorkspace &ws = sv::SortWorkspace::thisThread();
+    sv::SortWorkspace::Scope scope(ws);
+    size_t *lists[kClasses];
+    size_t filled[kClasses] = {};
+    for (int c = 0; c < kClasses; ++c)
+        lists[c] = ws.take<size_t>(counts[c]);
+    for (size_t s = 0; s < segments; ++s)
+    {
+        SizeClass c = classOf(sizeOf(s));
+        lists[c][filled[c]++] = s;
+    }
+    std::sort(lists[kLarge], lists[kLarge] + counts[kLarge],
+              [&](size_t x, size_t y) { return sizeOf(x) > sizeOf(y); });
+
+    // Tasks: large segments one each (longest first), then runs of about
+    // `grain` elements of the other classes
+    size_t grain = std::max<size_t>(1, opt.grain);
+    size_t maxTasks = counts[kLarge] + (elements[kNetwork] + elements[kSmall]) / grain + 2;
+    Task *tasks = ws.take<Task>(maxTasks);
+    size_t taskCount = 0;
+    for (size_t i = 0; i < counts[kLarge]; ++i)
+        tasks[taskCount++] = {kLarge, i, i + 1};
+    for (uint8_t c : {kSmall, kNetwork})
+    {
+        size_t first = 0, load = 0;
+        for (size_t i = 0; i < counts[c]; ++i)
+        {
+            load += sizeOf(lists[c][i]);
+            if (load >= grain || i + 1 == counts[c])
+            {
+                tasks[taskCount++] = {c, first, i + 1};
+                first = i + 1;
+                load = 0;
+            }
+        }
+    }
+
+    auto run = [&](size_t t) {
+        const Task &task = tasks[t];
+        for (size_t i = task.first; i < task.last; ++i)
+        {
+            size_t s = lists[task.sizeClass][i];
+            int *p = data + offsets[s];
+            size_t n = sizeOf(s);
+            switch (task.sizeClass)
+            {
+            case kNetwork: sv::network::sortSmall(p, n); break;
+            case kSmall: sv::parallel::quickKernel(p, n); break;
+            default: sortLarge(p, n); break;
+            }
+        }
+    };
+    size_t total = elements[kNetwork] + elements[kSmall] + elements[kLarge];
+    unsigned threads = total < opt.minParallel ? 1 : opt.threads;
+    sv::parallel::forEachTask(taskCount, threads, run);
+    return stats;
+}
+
+/** Same, for offsets.size() - 1 segments of `data`. */
+template <typename Offset>
+SegmentedStats sortSegmented(std::vector<int> &data, const std::vector<Offset> &offsets,
+                             const SegmentedOptions &opt = SegmentedOptions())
+{
+    if (offsets.empty())
+        return {};
+    if (static_cast<size_t>(offsets.back()) > data.size())
+        throw std::invalid_argument("sortSegmented: offsets run past the data");
+    return sortSegmented(data.data(), offsets.data(), offsets.size() - 1, opt);
+}
+
+} // namespace sv::segmented
+
+#endif // SORTVISION_SEGMENTED_SORT_HPP
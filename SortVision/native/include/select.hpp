@@ -0,0 +1,210 @@
+/**
+ * select.hpp
+ *
+ * Medians and percentiles without a full sort, built on the quick sort
+ * partition kernel (quickSelect / multiSelect in quickSort.cpp).
+ *
+ *     int median = sv::select::nthElement(vec.data(), vec.size(), vec.size() / 2);
+ *     std::vector<int> p = sv::select::quantiles(vec.data(), vec.size(), {0.5, 0.9, 0.99});
+ *
+ * All requested ranks are placed in one pass: each partition serves every
+ * rank on its side and only sides holding a rank are partitioned again.
+ * Afterwards data[r] holds the key a full sort would put at r, with no
+ * larger key before it and no smaller key after it.
+ *
+ * Ranges of at least `minParallel` elements are split on several threads:
+ *  - The pivot is taken from an evenly spaced sample of 1024 keys, at the
+ *    sample position of the middle requested rank (Floyd-Rivest style),
+ *    so one partition usually cuts the rank set in half.
+ *  - Each thread counts its chunk's keys below, equal to and above the
+ *    pivot, then scatters them into a buffer at prefix-sum offsets, and
+ *    the buffer is copied back in parallel (three-way, so duplicates are
+ *    settled at once).
+ *  - When both sides hold ranks they continue concurrently, with the
+ *    threads shared in proportion to their sizes.
+ * Smaller ranges use the sequential introselect. After 2 * log2(n)
+ * parallel levels without finishing (adversarial samples), the rest is
+ * also sequential, which has a median-of-medians worst-case bound.
+ */
+#ifndef SORTVISION_SELECT_HPP
+#define SORTVISION_SELECT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "parallelSort.hpp"
+
+namespace sv::select {
+
+namespace detail {
+
+constexpr size_t kSampleSize = 1024;
+
+/** Three-way parallel partition of data[0, n) around pivot; returns {less, equal} counts. */
+inline std::pair<size_t, size_t> parallelPartition(int *data, size_t n, int pivot, unsigned threads)
+{
+    size_t chunks = threads;
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t k = 0; k <= chunks; ++k)
+        bounds[k] = n * k / chunks;
+
+    // counts[3k + 0/1/2]: keys below / equal to / above the pivot in chunk k
+    std::vector<size_t> counts(3 * chunks, 0);
+    parallel::forEachTask(chunks, threads, [&](size_t k) {
+        size_t less = 0, equal = 0;
+        for (size_t i = bounds[k]; i < bounds[k + 1]; ++i)
+        {
+            less += data[i] < pivot;
+            equal += data[i] == pivot;
+        }
+        counts[3 * k] = less;
+        counts[3 * k + 1] = equal;
+        counts[3 * k + 2] = bounds[k + 1] - bounds[k] - less - equal;
+    });
+
+    // Exclusive prefix sums, all "less" slots first, then "equal", then "greater"
+    std::vector<size_t> offsets(3 * chunks);
+    size_t total = 0;
+    for (size_t side = 0; side < 3; ++side)
+        for (size_t k = 0; k < chunks; ++k)
+        {
+            offsets[3 * k + side] = total;
+            total += counts[3 * k + side];
+        }
+    size_t less = offsets[1], equal = offsets[2] - offsets[1];
+
+    sv::SortWorkspace &ws = sv::SortWorkspace::thisThread();
+    sv::SortWorkspace::Scope scope(ws);
+    int *buffer = ws.take<int>(n);
+    parallel::forEachTask(chunks, threads, [&](size_t k) {
+        size_t out[3] = {offsets[3 * k], offsets[3 * k + 1], offsets[3 * k + 2]};
+        for (size_t i = bounds[k]; i < bounds[k + 1]; ++i)
+        {
+            int v = data[i];
+            buffer[out[(v >= pivot) + (v > pivot)]++] = v;
+        }
+    });
+    parallel::forEachTask(chunks, threads, [&](size_t k) {
+        std::copy(buffer + bounds[k], buffer + bounds[k + 1], data + bounds[k]);
+    });
+    return {less, equal};
+}
+
+/** Places ranks[0, count) (sorted, relative to data) in data[0, n). */
+inline void selectParallel(int *data, size_t n, const ptrdiff_t *ranks, size_t count, unsigned threads,
+                           size_t minParallel, int levels)
+{
+    while (count > 0)
+    {
+        if (threads <= 1 || n < std::max<size_t>(minParallel, 2 * kSampleSize) || levels-- <= 0)
+        {
+            impl::quick::selectRanks<ops::NoCounting>(data, 0, static_cast<ptrdiff_t>(n) - 1, ranks, count,
+                                                      impl::quick::selectBudget(n));
+            return;
+        }
+
+        // Pivot: the sample key at the relative position of the middle rank
+        int sample[kSampleSize];
+        for (size_t i = 0; i < kSampleSize; ++i)
+            sample[i] = data[n / kSampleSize * i + n / kSampleSize / 2];
+        ptrdiff_t target = ranks[count / 2] * static_cast<ptrdiff_t>(kSampleSize) / static_cast<ptrdiff_t>(n);
+        impl::quick::quickSelect(sample, 0, kSampleSize - 1, target);
+        auto [less, equal] = parallelPartition(data, n, sample[target], threads);
+
+        const ptrdiff_t *left = std::lower_bound(ranks, ranks + count, static_cast<ptrdiff_t>(less));
+        const ptrdiff_t *right = std::lower_bound(left, ranks + count, static_cast<ptrdiff_t>(less + equal));
+        size_t leftCount = static_cast<size_t>(left - ranks), rightCount = count - static_cast<size_t>(right - ranks);
+        size_t rightBegin = less + equal;
+
+        // Right-side ranks relative to their subarray
+        std::vector<ptrdiff_t> shifted(right, ranks + count);
+        for (ptrdiff_t &r : shifted)
+            r -= static_cast<ptrdiff_t>(rightBegin);
+
+        if (leftCount > 0 && rightCount > 0)
+        {
+            unsigned leftThreads = static_cast<unsigned>(
+                std::clamp<size_t>(threads * less / (less + n - rightBegin), 1, threads - 1));
+            std::thread worker(selectParallel, data, less, ranks, leftCount, leftThreads, minParallel, levels);
+            selectParallel(data + rightBegin, n - rightBegin, shifted.data(), rightCount, threads - leftThreads,
+                           minParallel, levels);
+            worker.join();
+            return;
+        }
+        if (leftCount > 0)
+        {
+            n = less;
+            count = leftCount;
+        }
+        else
+        {
+            if (rightCount > 0)
+                selectParallel(data + rightBegin, n - rightBegin, shifted.data(), rightCount, threads, minParallel,
+                               levels);
+            return;
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * Places every rank in `ranks` (any order, repeats allowed) at its sorted
+ * position in data[0, n), on `threads` threads (0 = all hardware threads).
+ * @throws std::out_of_range when a rank is >= n
+ */
+inline void multiSelect(int *data, size_t n, std::vector<size_t> ranks, unsigned threads = 0,
+                        size_t minParallel = size_t(1) << 20)
+{
+    std::vector<ptrdiff_t> sorted(ranks.begin(), ranks.end());
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (!sorted.empty() && static_cast<size_t>(sorted.back()) >= n)
+        throw std::out_of_range("multiSelect: rank out of range");
+    if (threads == 0)
+        threads = parallel::defaultThreads();
+    detail::selectParallel(data, n, sorted.data(), sorted.size(), threads, minParallel,
+                           impl::quick::selectBudget(n));
+}
+
+/** The k-th smallest key (0-based), placed at data[k] like std::nth_element. */
+inline int nthElement(int *data, size_t n, size_t k, unsigned threads = 0, size_t minParallel = size_t(1) << 20)
+{
+    multiSelect(data, n, {k}, threads, minParallel);
+    return data[k];
+}
+
+/**
+ * Keys at quantiles q in [0, 1], by nearest rank round(q * (n - 1)), so
+ * 0 is the minimum, 0.5 the median (the upper one for even n) and 1 the
+ * maximum.
+ * @throws std::out_of_range for an empty array or q outside [0, 1]
+ */
+inline std::vector<int> quantiles(int *data, size_t n, const std::vector<double> &qs, unsigned threads = 0,
+                                  size_t minParallel = size_t(1) << 20)
+{
+    if (n == 0)
+        throw std::out_of_range("quantiles: empty array");
+    std::vector<size_t> ranks;
+    ranks.reserve(qs.size());
+    for (double q : qs)
+    {
+        if (!(q >= 0.0 && q <= 1.0))
+            throw std::out_of_range("quantiles: q outside [0, 1]");
+        ranks.push_back(static_cast<size_t>(std::llround(q * static_cast<double>(n - 1))));
+    }
+    multiSelect(data, n, ranks, threads, minParallel);
+    std::vector<int> out;
+    out.reserve(ranks.size());
+    for (size_t r : ranks)
+        out.push_back(data[r]);
+    return out;
+}
+
+} // namespace sv::select
+
+#endif // SORTVISION_SELECT_HPP
@@ -0,0 +1,309 @@
+/**
+ * sortAuto.hpp
+ *
+ * Picks one of the existing implementations for a given input.
+ *
+ *     sv::AutoDecision d = sv::sortAuto(vec);
+ *     std::cerr << d << "\n"; // "heap: n=100000 runs=66712 ... (cache-resident input)"
+ *
+ * sortAuto() profiles the input with one linear pass (min, max, descents,
+ * monotone runs) and a sorted sample of about sqrt(n) keys (duplicate
+ * ratio), then routes:
+ *
+ *   no descents                          nothing    (already sorted)
+ *   no ascents                           reverse    (descending input)
+ *   n <= networkMax                      network    (sortingNetwork.hpp, branchless)
+ *   few descents, n <= insertionMax      insertion  (O(n + inversions))
+ *   n <= smallInputMax                   quick
+ *   long monotone runs, or mostly        heap       (fastest measured there)
+ *   ascending
+ *   many duplicates                      heap, or radix once out of cache
+ *                                        (fastest measured there)
+ *   few decimal digits, n >= radixMinN   radix      (cost grows with the digit count)
+ *   n <= cacheResidentMax                heap
+ *   otherwise                            quick
+ *
+ * Few descents do not mean few inversions: a rotated sorted array has one
+ * descent and n^2/4 inversions, so insertion sort is capped at the size
+ * where it was measured to win.
+ *
+ * "quick" is the three-way introsort (quickSort.cpp). The duplicate
+ * estimate comes from a sample and misses a hot key of a few percent;
+ * the Lomuto quick sort went quadratic on such input (4M keys, 5% one
+ * key: 10.4 s), while three-way partitions finish each pivot's
+ * duplicates in one pass.
+ *
+ * The defaults in AutoThresholds come from sortBench runs of the C++
+ * engines (single thread, -O2, n = 10 .. 10^6, all distributions); see
+ * the comments on each field. Merge sort is not a candidate: it was never
+ * the fastest engine on any cell. Re-run the benchmark and adjust them for a
+ * different machine.
+ *
+ * Set SORTVISION_AUTO_LOG in the environment to print every decision to
+ * stderr.
+ */
+#ifndef SORTVISION_SORT_AUTO_HPP
+#define SORTVISION_SORT_AUTO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "algorithms.hpp"
+#include "sortingNetwork.hpp"
+
+namespace sv {
+
+enum class AutoAlgorithm
+{
+    None, // input already sorted
+    Reverse,
+    Network,
+    Insertion,
+    Heap,
+    Quick,
+    Radix,
+    Bucket
+};
+
+inline const char *autoAlgorithmName(AutoAlgorithm a)
+{
+    switch (a)
+    {
+    case AutoAlgorithm::None: return "none";
+    case AutoAlgorithm::Reverse: return "reverse";
+    case AutoAlgorithm::Network: return "network";
+    case AutoAlgorithm::Insertion: return "insertion";
+    case AutoAlgorithm::Heap: return "heap";
+    case AutoAlgorithm::Quick: return "quick";
+    case AutoAlgorithm::Radix: return "radix";
+    case AutoAlgorithm::Bucket: return "bucket";
+    }
+    return "unknown";
+}
+
+struct AutoThresholds
+{
+    // Unrolled networks sort 4-32 random keys 3-6x faster than insertion
+    // sort (n = 16: 54 vs 302 ns per array; insertion beats the other
+    // engines at these sizes)
+    size_t networkMax = sv::network::kMaxSize;
+    // Insertion on nearly-sorted input (1% swapped) wins at n = 10^4
+    // (54 vs 90 ns) and loses at 10^5 (517 vs 81): allow descents <= 32 log2 n,
+    // and no larger inputs, where a few long displacements (a rotation) cost
+    // O(n^2) (4 * 10^5 rotated keys: 11.8 s)
+    double nearlySortedDescentsPerLog = 32;
+    size_t insertionMax = 10000;
+    // Below a few hundred keys quick sort's bad cases cost little and heap
+    // sort's constant factor dominates (n = 100: quick 9-17 ns on every
+    // distribution, heap 20-24)
+    size_t smallInputMax = 256;
+    // Organ-pipe input (2 runs) made the Lomuto quick sort quadratic; heap
+    // is the fastest engine there at every size (82 ns at 10^6)
+    size_t longRunLength = 64;
+    // Nearly-sorted input past the insertion limit: heap 86, radix 104,
+    // merge 115, quick 125 ns at 10^6
+    double presortedDescentRatio = 0.05;
+    // Few-unique and Zipf keys made the Lomuto quick sort quadratic; heap is
+    // fastest up to 10^5 (63-84 ns), radix beyond (100-110 ns at 10^6)
+    double duplicateRatio = 0.1;
+    // Heap sort leads on uniform keys while the array fits in cache
+    // (49 ns at 10^4, 75 ns at 10^5) and falls behind quick at 10^6 (155 vs 108)
+    size_t cacheResidentMax = size_t(1) << 17;
+    // Base-10 radix sort costs ~11 ns/element per digit (10 digits: 112 ns),
+    // so up to 6 digits it beats quick sort's ~100 ns on large inputs
+    int radixMaxDigits = 6;
+    size_t radixMinN = size_t(1) << 12;
+};
+
+struct InputProfile
+{
+    size_t n = 0;
+    size_t descents = 0;    // positions with a[i] > a[i + 1]
+    size_t ascents = 0;     // positions with a[i] < a[i + 1]
+    size_t runs = 0;        // maximal non-increasing / non-decreasing runs
+    double minKey = 0;
+    double maxKey = 0;
+    int digits = 0;         // decimal digits of max |key| (integers only)
+    size_t sampleSize = 0;
+    double duplicateRatio = 0; // 1 - distinct / sampleSize
+};
+
+struct AutoDecision
+{
+    AutoAlgorithm algorithm = AutoAlgorithm::None;
+    InputProfile profile;
+    const char *reason = "";
+};
+
+inline std::ostream &operator<<(std::ostream &out, const AutoDecision &d)
+{
+    const InputProfile &p = d.profile;
+    return out << autoAlgorithmName(d.algorithm) << ": n=" << p.n << " runs=" << p.runs
+               << " descents=" << p.descents << " keys=[" << p.minKey << ", " << p.maxKey << "]"
+               << " duplicates=" << p.duplicateRatio << " (sample " << p.sampleSize << ") (" << d.reason << ")";
+}
+
+/**
+ * One pass over the keys plus a sorted sample of ~sqrt(n) evenly spaced
+ * keys for the duplicate estimate.
+ */
+template <typename T>
+InputProfile profileInput(const std::vector<T> &a)
+{
+    InputProfile p;
+    p.n = a.size();
+    if (a.empty())
+        return p;
+
+    T lo = a[0], hi = a[0];
+    int direction = 0; // of the current run: -1 descending, +1 ascending, 0 undecided
+    p.runs = 1;
+    for (size_t i = 1; i < a.size(); ++i)
+    {
+        lo = std::min(lo, a[i]);
+        hi = std::max(hi, a[i]);
+        int step = (a[i - 1] < a[i]) - (a[i] < a[i - 1]);
+        p.ascents += step > 0;
+        p.descents += step < 0;
+        if (step != 0 && direction != 0 && step != direction)
+        {
+            ++p.runs;
+            direction = 0;
+        }
+        else if (step != 0)
+        {
+            direction = step;
+        }
+    }
+    p.minKey = static_cast<double>(lo);
+    p.maxKey = static_cast<double>(hi);
+    if constexpr (std::is_integral_v<T>)
+    {
+        double maxAbs = std::max(std::fabs(p.minKey), std::fabs(p.maxKey));
+        for (double limit = 1; limit <= maxAbs; limit *= 10)
+            ++p.digits;
+    }
+
+    // sqrt(n) samples, at most kMaxSample (n = 2^20), kept on the stack
+    constexpr size_t kMaxSample = 1024;
+    size_t stride = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(a.size()))));
+    stride = std::max(stride, (a.size() + kMaxSample - 1) / kMaxSample);
+    T sample[kMaxSample];
+    for (size_t i = stride / 2; i < a.size() && p.sampleSize < kMaxSample; i += stride)
+        sample[p.sampleSize++] = a[i];
+    std::sort(sample, sample + p.sampleSize);
+    size_t distinct = std::unique(sample, sample + p.sampleSize) - sample;
+    p.duplicateRatio = p.sampleSize ? 1.0 - static_cast<double>(distinct) / p.sampleSize : 0.0;
+    return p;
+}
+
+/** Chooses an engine for an integer input profile (see the table above). */
+inline AutoDecision chooseAlgorithm(const InputProfile &p, const AutoThresholds &t = AutoThresholds())
+{
+    AutoDecision d;
+    d.profile = p;
+    auto pick = [&](AutoAlgorithm a, const char *reason) {
+        d.algorithm = a;
+        d.reason = reason;
+        return d;
+    };
+    if (p.n <= 1 || p.descents == 0)
+        return pick(AutoAlgorithm::None, "already sorted");
+    if (p.ascents == 0)
+        return pick(AutoAlgorithm::Reverse, "descending input");
+    if (p.n <= t.networkMax)
+        return pick(AutoAlgorithm::Network, "tiny input");
+    bool mostlyAscending = p.descents <= t.presortedDescentRatio * p.n;
+    if (mostlyAscending && p.n <= t.insertionMax &&
+        p.descents <= t.nearlySortedDescentsPerLog * std::log2(static_cast<double>(p.n)))
+        return pick(AutoAlgorithm::Insertion, "nearly sorted");
+    if (p.n <= t.smallInputMax)
+        return pick(AutoAlgorithm::Quick, "small input");
+    if (p.runs * t.longRunLength <= p.n)
+        return pick(AutoAlgorithm::Heap, "long monotone runs");
+    if (mostlyAscending)
+        return pick(AutoAlgorithm::Heap, "mostly ascending");
+    bool radixFits = p.minKey > std::numeric_limits<int>::min() && p.digits <= t.radixMaxDigits;
+    if (p.duplicateRatio >= t.duplicateRatio)
+    {
+        if (p.n <= t.cacheResidentMax || p.minKey == std::numeric_limits<int>::min())
+            return pick(AutoAlgorithm::Heap, "many duplicates");
+        return pick(AutoAlgorithm::Radix, "many duplicates, large input");
+    }
+    if (radixFits && p.n >= t.radixMinN)
+        return pick(AutoAlgorithm::Radix, "narrow key range");
+    if (p.n <= t.cacheResidentMax)
+        return pick(AutoAlgorithm::Heap, "cache-resident input");
+    return pick(AutoAlgorithm::Quick, "large random input");
+}
+
+namespace detail {
+
+inline void logDecision(const AutoDecision &d)
+{
+    static const bool enabled = std::getenv("SORTVISION_AUTO_LOG") != nullptr;
+    if (enabled)
+        std::cerr << "sortAuto " << d << "\n";
+}
+
+} // namespace detail
+
+/**
+ * Sorts integers with the implementation chooseAlgorithm() picks.
+ * @return the decision, including the measured input profile
+ */
+inline AutoDecision sortAuto(std::vector<int> &arr, const AutoThresholds &t = AutoThresholds())
+{
+    AutoDecision d = chooseAlgorithm(profileInput(arr), t);
+    switch (d.algorithm)
+    {
+    case AutoAlgorithm::None: break;
+    case AutoAlgorithm::Reverse: std::reverse(arr.begin(), arr.end()); break;
+    case AutoAlgorithm::Network: sv::network::sortSmall(arr.data(), arr.size()); break;
+    case AutoAlgorithm::Insertion: insertionSort(arr); break;
+    case AutoAlgorithm::Heap: heapSort(arr); break;
+    case AutoAlgorithm::Quick: introSort(arr); break;
+    case AutoAlgorithm::Radix: radixSort(arr); break;
+    case AutoAlgorithm::Bucket: break;
+    }
+    detail::logDecision(d);
+    return d;
+}
+
+/**
+ * Sorts floats. Bucket sort is the only float engine, so the profile only
+ * short-cuts sorted and descending inputs.
+ */
+inline AutoDecision sortAuto(std::vector<float> &arr)
+{
+    AutoDecision d;
+    d.profile = profileInput(arr);
+    if (d.profile.n <= 1 || d.profile.descents == 0)
+    {
+        d.algorithm = AutoAlgorithm::None;
+        d.reason = "already sorted";
+    }
+    else if (d.profile.ascents == 0)
+    {
+        d.algorithm = AutoAlgorithm::Reverse;
+        d.reason = "descending input";
+        std::reverse(arr.begin(), arr.end());
+    }
+    else
+    {
+        d.algorithm = AutoAlgorithm::Bucket;
+        d.reason = "only float engine";
+        bucketSort(arr);
+    }
+    detail::logDecision(d);
+    return d;
+}
+
+} // namespace sv
+
+#endif // SORTVISION_SORT_AUTO_HPP
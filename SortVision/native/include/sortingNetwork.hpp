@@ -0,0 +1,246 @@
+/**
+ * sortingNetwork.hpp
+ *
+ * Compile-time sorting networks for up to 32 elements.
+ *
+ *     std::array<int, 5> a = {4, 2, 5, 1, 3};
+ *     sv::network::sortArray(a);                       // unrolled min/max code
+ *     constexpr auto s = sv::network::sorted(std::array<int, 3>{3, 1, 2}); // constant evaluation
+ *     sv::network::sortSmall(ptr, n);                  // runtime n <= 32
+ *
+ * Networks:
+ *  - N <= 8: size-optimal networks (1, 3, 5, 9, 12, 16, 19 comparators for
+ *    N = 2..8).
+ *  - 9 <= N <= 32: Batcher's odd-even merge sort for the next power of two,
+ *    with every comparator that touches a position >= N removed (those
+ *    positions act as +infinity). This is within a few comparators of the
+ *    best known networks (N = 16: 63 vs 60, N = 32: 191 vs 185).
+ *
+ * Each network is a constexpr array built once per N. sortArray() expands
+ * it through an index_sequence, so every comparator has constant indices
+ * and compiles to a min/max pair (cmov, or minps/maxps for floats) with
+ * no loop and no data-dependent branch.
+ */
+#ifndef SORTVISION_SORTING_NETWORK_HPP
+#define SORTVISION_SORTING_NETWORK_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace sv::network {
+
+constexpr size_t kMaxSize = 32;
+
+struct Comparator
+{
+    uint8_t i, j; // i < j; afterwards a[i] <= a[j]
+};
+
+namespace detail {
+
+// Size-optimal networks for N = 2..8 (Knuth, TAOCP vol. 3, 5.3.4)
+constexpr Comparator kOptimal2[] = {{0, 1}};
+constexpr Comparator kOptimal3[] = {{1, 2}, {0, 2}, {0, 1}};
+constexpr Comparator kOptimal4[] = {{0, 1}, {2, 3}, {0, 2}, {1, 3}, {1, 2}};
+constexpr Comparator kOptimal5[] = {{0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4}, {2, 3}};
+constexpr Comparator kOptimal6[] = {{0, 5}, {1, 3}, {2, 4}, {1, 2}, {3, 4}, {0, 3},
+                                    {2, 5}, {0, 1}, {2, 3}, {4, 5}, {1, 2}, {3, 4}};
+constexpr Comparator kOptimal7[] = {{0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5},
+                                    {3, 4}, {1, 2}, {4, 6}, {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6}};
+constexpr Comparator kOptimal8[] = {{0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6},
+                                    {3, 7}, {0, 1}, {2, 3}, {4, 5}, {6, 7}, {2, 4}, {3, 5},
+                                    {1, 4}, {3, 6}, {1, 2}, {3, 4}, {5, 6}};
+
+/**
+ * Visits the comparators of Batcher's odd-even merge sort for the next
+ * power of two >= n, skipping those that reach past n.
+ */
+template <typename Visit>
+constexpr void forEachBatcher(size_t n, Visit &&visit)
+{
+    size_t p2 = 1;
+    while (p2 < n)
+        p2 <<= 1;
+    for (size_t p = 1; p < p2; p <<= 1)
+        for (size_t k = p; k >= 1; k >>= 1)
+            for (size_t j = k % p; j + k < p2; j += 2 * k)
+                for (size_t i = 0; i < k && i + j + k < p2; ++i)
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n)
+                        visit(i + j, i + j + k);
+}
+
+template <size_t N>
+constexpr size_t networkSize()
+{
+    static_assert(N <= kMaxSize, "sorting networks are provided for N <= 32");
+    if constexpr (N < 2)
+        return 0;
+    else if constexpr (N == 2)
+        return std::size(kOptimal2);
+    else if constexpr (N == 3)
+        return std::size(kOptimal3);
+    else if constexpr (N == 4)
+        return std::size(kOptimal4);
+    else if constexpr (N == 5)
+        return std::size(kOptimal5);
+    else if constexpr (N == 6)
+        return std::size(kOptimal6);
+    else if constexpr (N == 7)
+        return std::size(kOptimal7);
+    else if constexpr (N == 8)
+        return std::size(kOptimal8);
+    else
+    {
+        size_t count = 0;
+        forEachBatcher(N, [&](size_t, size_t) { ++count; });
+        return count;
+    }
+}
+
+template <size_t M, size_t K>
+constexpr std::array<Comparator, M> copyNetwork(const Comparator (&source)[K])
+{
+    std::array<Comparator, M> out{};
+    for (size_t c = 0; c < M; ++c)
+        out[c] = source[c];
+    return out;
+}
+
+template <size_t N>
+constexpr std::array<Comparator, networkSize<N>()> makeNetwork()
+{
+    constexpr size_t M = networkSize<N>();
+    if constexpr (N == 2)
+        return copyNetwork<M>(kOptimal2);
+    else if constexpr (N == 3)
+        return copyNetwork<M>(kOptimal3);
+    else if constexpr (N == 4)
+        return copyNetwork<M>(kOptimal4);
+    else if constexpr (N == 5)
+        return copyNetwork<M>(kOptimal5);
+    else if constexpr (N == 6)
+        return copyNetwork<M>(kOptimal6);
+    else if constexpr (N == 7)
+        return copyNetwork<M>(kOptimal7);
+    else if constexpr (N == 8)
+        return copyNetwork<M>(kOptimal8);
+    else
+    {
+        std::array<Comparator, M> out{};
+        size_t c = 0;
+        forEachBatcher(N, [&](size_t i, size_t j) {
+            out[c++] = {static_cast<uint8_t>(i), static_cast<uint8_t>(j)};
+        });
+        return out;
+    }
+}
+
+} // namespace detail
+
+/** The comparators sorting N elements, in execution order. */
+template <size_t N>
+inline constexpr std::array<Comparator, detail::networkSize<N>()> kNetwork = detail::makeNetwork<N>();
+
+/**
+ * Orders a and b without branching on the data: both results are
+ * selected from the same comparison.
+ */
+template <typename T, typename Compare = std::less<>>
+constexpr void compareExchange(T &a, T &b, Compare less = Compare())
+{
+    const T x = a, y = b;
+    const bool swap = less(y, x);
+    a = swap ? y : x;
+    b = swap ? x : y;
+}
+
+namespace detail {
+
+template <size_t N, typename Access, typename Compare, size_t... K>
+constexpr void applyNetwork(Access &&a, Compare less, std::index_sequence<K...>)
+{
+    (void)less; // unused when N < 2
+    (compareExchange(a[kNetwork<N>[K].i], a[kNetwork<N>[K].j], less), ...);
+}
+
+} // namespace detail
+
+/**
+ * Sorts the first N elements of `a` (a std::array, C array or pointer)
+ * with the fully unrolled network for N.
+ */
+template <size_t N, typename Access, typename Compare = std::less<>>
+constexpr void sortFixed(Access &&a, Compare less = Compare())
+{
+    detail::applyNetwork<N>(a, less, std::make_index_sequence<kNetwork<N>.size()>());
+}
+
+/** Sorts a std::array of up to 32 elements in place. */
+template <typename T, size_t N, typename Compare = std::less<>>
+constexpr void sortArray(std::array<T, N> &a, Compare less = Compare())
+{
+    sortFixed<N>(a, less);
+}
+
+/** Returns a sorted copy; usable in constant expressions. */
+template <typename T, size_t N, typename Compare = std::less<>>
+constexpr std::array<T, N> sorted(std::array<T, N> a, Compare less = Compare())
+{
+    sortFixed<N>(a, less);
+    return a;
+}
+
+namespace detail {
+
+template <typename T, typename Compare, size_t... N>
+constexpr auto makeDispatch(std::index_sequence<N...>)
+{
+    using Kernel = void (*)(T *, Compare);
+    return std::array<Kernel, sizeof...(N)>{[](T *p, Compare less) { sortFixed<N>(p, less); }...};
+}
+
+} // namespace detail
+
+/**
+ * Sorts data[0, n) with the network for n.
+ * @return false (and leaves the data untouched) when n > 32
+ */
+template <typename T, typename Compare = std::less<>>
+bool sortSmall(T *data, size_t n, Compare less = Compare())
+{
+    static constexpr auto dispatch = detail::makeDispatch<T, Compare>(std::make_index_sequence<kMaxSize + 1>());
+    if (n > kMaxSize)
+        return false;
+    dispatch[n](data, less);
+    return true;
+}
+
+static_assert(kNetwork<4>.size() == 5 && kNetwork<8>.size() == 19 && kNetwork<16>.size() == 63 &&
+                  kNetwork<32>.size() == 191,
+              "unexpected network sizes");
+namespace detail {
+
+template <size_t N>
+constexpr bool sortsPermutation()
+{
+    std::array<int, N> a{};
+    for (size_t i = 0; i < N; ++i)
+        a[i] = static_cast<int>((i * 7 + 3) % N); // 7 is coprime to every N checked below
+    a = sorted(a);
+    for (size_t i = 0; i < N; ++i)
+        if (a[i] != static_cast<int>(i))
+            return false;
+    return true;
+}
+
+static_assert(sortsPermutation<5>() && sortsPermutation<9>() && sortsPermutation<32>(),
+              "networks must sort in constant evaluation");
+
+} // namespace detail
+
+} // namespace sv::network
+
+#endif // SORTVISION_SORTING_NETWORK_HPP
@@ -0,0 +1,246 @@
+/**
+ * textIo.hpp
+ *
+ * Fast text conversion of int32 keys for the native tools.
+ *
+ *  - parseInts() splits a text buffer into one chunk per thread (cut at
+ *    separators), parses each chunk with std::from_chars and concatenates
+ *    the results.
+ *  - parseSome() parses sequentially into a caller's buffer, for input
+ *    read a bounded chunk at a time; countTokens() sizes that buffer.
+ *  - formatInt() writes an integer two digits at a time from a 200-byte
+ *    table, avoiding the division per digit of the iostream path.
+ *  - formatInts() formats one chunk per thread into separate buffers so
+ *    they can be handed to writev() without joining them.
+ *  - formatCounts() does the same for "key count" lines (group-by output).
+ *
+ * Separators are spaces, tabs, newlines, carriage returns and commas.
+ */
+#ifndef SORTVISION_TEXT_IO_HPP
+#define SORTVISION_TEXT_IO_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "parallelSort.hpp"
+
+namespace sv::textio {
+
+inline bool isSeparator(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',';
+}
+
+struct ParseError
+{
+    bool failed = false;
+    size_t offset = 0; // byte offset of the bad token
+};
+
+/**
+ * Parses every integer in [begin, end) into keys using `threads` threads.
+ * @return failed = true (and the offset of the first bad token found) on
+ *         malformed or out-of-range input
+ */
+inline ParseError parseInts(const char *begin, const char *end, std::vector<int> &keys, unsigned threads = 0)
+{
+    size_t bytes = static_cast<size_t>(end - begin);
+    if (threads == 0)
+        threads = sv::parallel::defaultThreads();
+    size_t chunks = std::max<size_t>(1, std::min<size_t>(threads, bytes >> 20)); // at least 1 MiB each
+
+    // Chunk k starts at the first token beginning at or after bytes * k / chunks
+    std::vector<const char *> starts(chunks + 1, end);
+    for (size_t k = 0; k < chunks; ++k)
+    {
+        const char *p = begin + bytes * k / chunks;
+        while (k > 0 && p < end && !isSeparator(p[-1]))
+            ++p;
+        starts[k] = p;
+    }
+
+    std::vector<std::vector<int>> parts(chunks);
+    std::vector<ParseError> errors(chunks);
+    sv::parallel::forEachTask(chunks, threads, [&](size_t k) {
+        std::vector<int> &out = parts[k];
+        out.reserve(static_cast<size_t>(starts[k + 1] - starts[k]) / 8);
+        const char *p = starts[k], *stop = starts[k + 1];
+        while (true)
+        {
+            while (p < stop && isSeparator(*p))
+                ++p;
+            if (p >= stop) // the previous token ran up to or past the chunk end
+                return;
+            int value;
+            auto [next, ec] = std::from_chars(p, end, value);
+            if (ec != std::errc() || (next < end && !isSeparator(*next)))
+            {
+                errors[k] = {true, static_cast<size_t>(p - begin)};
+                return;
+            }
+            out.push_back(value);
+            p = next;
+        }
+    });
+
+    for (const ParseError &e : errors)
+        if (e.failed)
+            return e;
+
+    std::vector<size_t> offsets(chunks + 1, 0);
+    for (size_t k = 0; k < chunks; ++k)
+        offsets[k + 1] = offsets[k] + parts[k].size();
+    if (chunks == 1)
+    {
+        keys.swap(parts[0]);
+        return {};
+    }
+    keys.resize(offsets[chunks]);
+    sv::parallel::forEachTask(chunks, threads, [&](size_t k) {
+        std::copy(parts[k].begin(), parts[k].end(), keys.begin() + offsets[k]);
+        std::vector<int>().swap(parts[k]);
+    });
+    return {};
+}
+
+/** Number of tokens in [begin, end), e.g. to size a buffer for parseSome(). */
+inline size_t countTokens(const char *begin, const char *end)
+{
+    size_t n = 0;
+    bool inToken = false;
+    for (const char *p = begin; p < end; ++p)
+    {
+        bool separator = isSeparator(*p);
+        n += inToken && separator;
+        inToken = !separator;
+    }
+    return n + inToken;
+}
+
+/**
+ * Sequential counterpart of parseInts() for bounded memory: parses up to
+ * `capacity` integers from [cursor, end) into out and moves cursor past
+ * them, so the text can be consumed a buffer at a time.
+ * @return keys parsed; 0 once the text is exhausted or at a bad token,
+ *         which sets e (offset counted from begin)
+ */
+inline size_t parseSome(const char *begin, const char *&cursor, const char *end, int *out, size_t capacity,
+                        ParseError &e)
+{
+    size_t n = 0;
+    const char *p = cursor;
+    while (n < capacity)
+    {
+        while (p < end && isSeparator(*p))
+            ++p;
+        if (p >= end)
+            break;
+        auto [next, ec] = std::from_chars(p, end, out[n]);
+        if (ec != std::errc() || (next < end && !isSeparator(*next)))
+        {
+            e = {true, static_cast<size_t>(p - begin)};
+            break;
+        }
+        ++n;
+        p = next;
+    }
+    cursor = p;
+    return n;
+}
+
+/**
+ * Writes the decimal form of v at out.
+ * @return pointer past the last character (at most 11 are written)
+ */
+inline char *formatInt(int32_t v, char *out)
+{
+    static const char pairs[201] = "00010203040506070809101112131415161718192021222324"
+                                   "25262728293031323334353637383940414243444546474849"
+                                   "50515253545556575859606162636465666768697071727374"
+                                   "75767778798081828384858687888990919293949596979899";
+    uint32_t u = static_cast<uint32_t>(v);
+    if (v < 0)
+    {
+        *out++ = '-';
+        u = 0u - u;
+    }
+    char digits[10];
+    char *p = digits + sizeof(digits);
+    while (u >= 100)
+    {
+        uint32_t pair = (u % 100) * 2;
+        u /= 100;
+        *--p = pairs[pair + 1];
+        *--p = pairs[pair];
+    }
+    if (u >= 10)
+    {
+        *--p = pairs[u * 2 + 1];
+        *--p = pairs[u * 2];
+    }
+    else
+    {
+        *--p = static_cast<char>('0' + u);
+    }
+    size_t n = static_cast<size_t>(digits + sizeof(digits) - p);
+    std::memcpy(out, p, n);
+    return out + n;
+}
+
+/**
+ * Formats keys as text, one key per line, into one buffer per chunk
+ * (chunks of at least 2^18 keys, at most `threads` of them).
+ */
+inline std::vector<std::string> formatInts(const int *keys, size_t n, unsigned threads = 0, char separator = '\n')
+{
+    if (threads == 0)
+        threads = sv::parallel::defaultThreads();
+    size_t chunks = std::max<size_t>(1, std::min<size_t>(threads, n >> 18));
+    std::vector<std::string> buffers(chunks);
+    sv::parallel::forEachTask(chunks, threads, [&](size_t k) {
+        size_t lo = n * k / chunks, hi = n * (k + 1) / chunks;
+        std::string &text = buffers[k];
+        text.resize((hi - lo) * 12);
+        char *p = &text[0];
+        for (size_t i = lo; i < hi; ++i)
+        {
+            p = formatInt(keys[i], p);
+            *p++ = separator;
+        }
+        text.resize(static_cast<size_t>(p - text.data()));
+    });
+    return buffers;
+}
+
+/** Formats "key count" lines, like formatInts(); counts[i] belongs to keys[i]. */
+inline std::vector<std::string> formatCounts(const int *keys, const size_t *counts, size_t n, unsigned threads = 0)
+{
+    if (threads == 0)
+        threads = sv::parallel::defaultThreads();
+    size_t chunks = std::max<size_t>(1, std::min<size_t>(threads, n >> 18));
+    std::vector<std::string> buffers(chunks);
+    sv::parallel::forEachTask(chunks, threads, [&](size_t k) {
+        size_t lo = n * k / chunks, hi = n * (k + 1) / chunks;
+        std::string &text = buffers[k];
+        text.resize((hi - lo) * 33);
+        char *p = &text[0];
+        for (size_t i = lo; i < hi; ++i)
+        {
+            p = formatInt(keys[i], p);
+            *p++ = ' ';
+            p = std::to_chars(p, p + 20, counts[i]).ptr;
+            *p++ = '\n';
+        }
+        text.resize(static_cast<size_t>(p - text.data()));
+    });
+    return buffers;
+}
+
+} // namespace sv::textio
+
+#endif // SORTVISION_TEXT_IO_HPP
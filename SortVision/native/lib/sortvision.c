@@ -0,0 +1,428 @@
+/*
+ * sortvision.c
+ *
+ * libsortvision, see sortvision.h. The algorithms follow the versions in
+ * public/code/<algorithm>/c, reworked for library use:
+ *  - size_t indices, so arrays past 2^31 elements work
+ *  - no malloc: merge, radix and bucket sort take their buffers from the
+ *    caller's scratch memory, and quick sort recurses into the smaller side
+ *    only (O(log n) stack)
+ *  - radix sort uses 8-bit digits (at most 4 passes, skipping digits that
+ *    are equal in every key) and handles negatives with a sign flip
+ *  - quick sort falls back to heap sort past 2*log2(n) levels, so hostile
+ *    inputs stay O(n log n)
+ *  - bucket sort lays its buckets out back to back (counting pass), the
+ *    same layout as the C++ version
+ *
+ * Build (C99, no C++ runtime):
+ *     gcc -std=c99 -O2 -fPIC -fvisibility=hidden -shared sortvision.c -o libsortvision.so
+ */
+#include "sortvision.h"
+
+#include <string.h>
+
+// Ranges at or below this size are finished with insertion sort
+#define SV_SMALL_RANGE 16
+// Merge sort starts from insertion-sorted runs of this length
+#define SV_MERGE_RUN 32
+// Scratch is aligned up to this boundary, so sizes include the slack
+#define SV_SCRATCH_ALIGN 8
+
+/* ----------------------------------------------------------------------
+ * Comparison sorts, instantiated for int32_t and float
+ * -------------------------------------------------------------------- */
+
+#define SV_DEFINE_COMPARISON_SORTS(T, NAME)                                                                         \
+                                                                                                                    \
+    static void insertion##NAME(T* a, size_t n) {                                                                   \
+        for (size_t i = 1; i < n; ++i) {                                                                            \
+            T key = a[i];                                                                                           \
+            size_t j = i;                                                                                           \
+            for (; j > 0 && key < a[j - 1]; --j)                                                                    \
+                a[j] = a[j - 1];                                                                                    \
+            a[j] = key;                                                                                             \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    static void bubble##NAME(T* a, size_t n) {                                                                      \
+        for (size_t end = n; end > 1; --end) {                                                                      \
+            int swapped = 0;                                                                                        \
+            for (size_t j = 0; j + 1 < end; ++j) {                                                                  \
+                if (a[j + 1] < a[j]) {                                                                              \
+                    T t = a[j];                                                                                     \
+                    a[j] = a[j + 1];                                                                                \
+                    a[j + 1] = t;                                                                                   \
+                    swapped = 1;                                                                                    \
+                }                                                                                                   \
+            }                                                                                                       \
+            if (!swapped)                                                                                           \
+                break;                                                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    static void selection##NAME(T* a, size_t n) {                                                                   \
+        for (size_t i = 0; i + 1 < n; ++i) {                                                                        \
+            size_t m = i;                                                                                           \
+            for (size_t j = i + 1; j < n; ++j)                                                                      \
+                if (a[j] < a[m])                                                                                    \
+                    m = j;                                                                                          \
+            T t = a[i];                                                                                             \
+            a[i] = a[m];                                                                                            \
+            a[m] = t;                                                                                               \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    static void siftDown##NAME(T* a, size_t root, size_t n) {                                                       \
+        T value = a[root];                                                                                          \
+        for (;;) {                                                                                                  \
+            size_t child = 2 * root + 1;                                                                            \
+            if (child >= n)                                                                                         \
+                break;                                                                                              \
+            if (child + 1 < n && a[child] < a[child + 1])                                                           \
+                ++child;                                                                                            \
+            if (!(value < a[child]))                                                                                \
+                break;                                                                                              \
+            a[root] = a[child];                                                                                     \
+            root = child;                                                                                           \
+        }                                                                                                           \
+        a[root] = value;                                                                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    static void heap##NAME(T* a, size_t n) {                                                                        \
+        if (n < 2)                                                                                                  \
+            return;                                                                                                 \
+        for (size_t i = n / 2; i-- > 0;)                                                                            \
+            siftDown##NAME(a, i, n);                                                                                \
+        for (size_t end = n - 1; end > 0; --end) {                                                                  \
+            T t = a[0];                                                                                             \
+            a[0] = a[end];                                                                                          \
+            a[end] = t;                                                                                             \
+            siftDown##NAME(a, 0, end);                                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    /* Median-of-three Hoare partition; a[lo] and a[hi - 1] bound both scans */                                    \
+    static void quick##NAME(T* a, size_t n, int depth) {                                                            \
+        while (n > SV_SMALL_RANGE) {                                                                                \
+            if (depth-- == 0) {                                                                                     \
+                heap##NAME(a, n);                                                                                   \
+                return;                                                                                             \
+            }                                                                                                       \
+            size_t mid = n / 2, last = n - 1;                                                                       \
+            T t;                                                                                                    \
+            if (a[mid] < a[0]) { t = a[0]; a[0] = a[mid]; a[mid] = t; }                                             \
+            if (a[last] < a[mid]) { t = a[mid]; a[mid] = a[last]; a[last] = t; }                                    \
+            if (a[mid] < a[0]) { t = a[0]; a[0] = a[mid]; a[mid] = t; }                                             \
+            T pivot = a[mid];                                                                                       \
+            size_t i = 0, j = last;                                                                                 \
+            for (;;) {                                                                                              \
+                do ++i; while (a[i] < pivot);                                                                       \
+                do --j; while (pivot < a[j]);                                                                       \
+                if (i >= j)                                                                                         \
+                    break;                                                                                          \
+                t = a[i];                                                                                           \
+                a[i] = a[j];                                                                                        \
+                a[j] = t;                                                                                           \
+            }                                                                                                       \
+            /* a[0, j] <= pivot <= a[j + 1, n); recurse into the smaller side */                                    \
+            size_t left = j + 1;                                                                                    \
+            if (left < n - left) {                                                                                  \
+                quick##NAME(a, left, depth);                                                                        \
+                a += left;                                                                                          \
+                n -= left;                                                                                          \
+            } else {                                                                                                \
+                quick##NAME(a + left, n - left, depth);                                                             \
+                n = left;                                                                                           \
+            }                                                                                                       \
+        }                                                                                                           \
+        insertion##NAME(a, n);                                                                                      \
+    }                                                                                                               \
+                                                                                                                    \
+    /* Bottom-up, stable; buffer holds n elements */                                                                \
+    static void merge##NAME(T* a, size_t n, T* buffer) {                                                            \
+        for (size_t lo = 0; lo < n; lo += SV_MERGE_RUN)                                                             \
+            insertion##NAME(a + lo, n - lo < SV_MERGE_RUN ? n - lo : SV_MERGE_RUN);                                 \
+        T *src = a, *dst = buffer;                                                                                  \
+        for (size_t width = SV_MERGE_RUN; width < n; width *= 2) {                                                  \
+            for (size_t lo = 0; lo < n; lo += 2 * width) {                                                          \
+                size_t mid = n - lo < width ? n : lo + width;                                                       \
+                size_t hi = n - mid < width ? n : mid + width;                                                      \
+                size_t i = lo, j = mid, k = lo;                                                                     \
+                while (i < mid && j < hi)                                                                           \
+                    dst[k++] = src[j] < src[i] ? src[j++] : src[i++];                                               \
+                memcpy(dst + k, src + i, (mid - i) * sizeof(T));                                                    \
+                memcpy(dst + k + (mid - i), src + j, (hi - j) * sizeof(T));                                         \
+            }                                                                                                       \
+            T* t = src;                                                                                             \
+            src = dst;                                                                                              \
+            dst = t;                                                                                                \
+        }                                                                                                           \
+        if (src != a)                                                                                               \
+            memcpy(a, src, n * sizeof(T));                                                                          \
+    }
+
+SV_DEFINE_COMPARISON_SORTS(int32_t, Int32)
+SV_DEFINE_COMPARISON_SORTS(float, Float)
+
+#undef SV_DEFINE_COMPARISON_SORTS
+
+/* ----------------------------------------------------------------------
+ * Radix sort on unsigned 32-bit keys
+ * -------------------------------------------------------------------- */
+
+// Sorts keys[0, n) with 8-bit LSD passes through tmp[0, n)
+static void radixUint32(uint32_t* keys, uint32_t* tmp, size_t n) {
+    size_t counts[4][256];
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t k = keys[i];
+        ++counts[0][k & 0xFF];
+        ++counts[1][(k >> 8) & 0xFF];
+        ++counts[2][(k >> 16) & 0xFF];
+        ++counts[3][k >> 24];
+    }
+    uint32_t *src = keys, *dst = tmp;
+    for (int d = 0; d < 4; ++d) {
+        unsigned shift = 8u * (unsigned)d;
+        // A digit shared by every key leaves the order unchanged
+        if (counts[d][(src[0] >> shift) & 0xFF] == n)
+            continue;
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b) {
+            size_t c = counts[d][b];
+            counts[d][b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i)
+            dst[counts[d][(src[i] >> shift) & 0xFF]++] = src[i];
+        uint32_t* t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != keys)
+        memcpy(keys, src, n * sizeof(uint32_t));
+}
+
+// Order-preserving unsigned image of a float's bits, and its inverse
+static uint32_t floatKey(uint32_t bits) {
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+static uint32_t floatBits(uint32_t key) {
+    return (key & 0x80000000u) ? key & 0x7FFFFFFFu : ~key;
+}
+
+/* ----------------------------------------------------------------------
+ * Bucket sort on floats
+ * -------------------------------------------------------------------- */
+
+static size_t bucketIndex(float x, double minValue, double range, size_t buckets) {
+    double pos = ((double)x - minValue) / range * (double)buckets;
+    size_t index = pos > 0 ? (size_t)pos : 0;
+    return index < buckets ? index : buckets - 1;
+}
+
+// n buckets over [min, max]; slots holds n floats, first n + 2 counters
+static void bucketFloat(float* a, size_t n, float* slots, size_t* first) {
+    float minValue = a[0], maxValue = a[0];
+    for (size_t i = 1; i < n; ++i) {
+        if (a[i] < minValue)
+            minValue = a[i];
+        if (a[i] > maxValue)
+            maxValue = a[i];
+    }
+    // Differences in double: max - min may overflow a float
+    double range = (double)maxValue - (double)minValue;
+    if (range == 0)
+        return;
+
+    // Bucket b ends at first[b + 1] after the prefix sums; filling from the
+    // back keeps input order and leaves first[b + 1] at the bucket's start
+    memset(first, 0, (n + 2) * sizeof(size_t));
+    for (size_t i = 0; i < n; ++i)
+        ++first[bucketIndex(a[i], minValue, range, n) + 1];
+    for (size_t b = 1; b <= n; ++b)
+        first[b] += first[b - 1];
+    for (size_t i = n; i-- > 0;)
+        slots[--first[bucketIndex(a[i], minValue, range, n) + 1]] = a[i];
+    first[n + 1] = n;
+
+    for (size_t b = 0; b < n; ++b) {
+        float* bucket = slots + first[b + 1];
+        size_t size = first[b + 2] - first[b + 1];
+        if (size <= SV_MERGE_RUN)
+            insertionFloat(bucket, size);
+        else
+            heapFloat(bucket, size);
+    }
+    memcpy(a, slots, n * sizeof(float));
+}
+
+/* ----------------------------------------------------------------------
+ * Public entry points
+ * -------------------------------------------------------------------- */
+
+int svAbiVersion(void) {
+    return SV_ABI_VERSION;
+}
+
+const char* svStatusString(int status) {
+    switch (status) {
+    case SV_OK: return "ok";
+    case SV_ERR_ARGUMENT: return "invalid argument";
+    case SV_ERR_SCRATCH: return "scratch buffer too small";
+    case SV_ERR_UNSUPPORTED: return "algorithm does not support this key type";
+    case SV_ERR_NAN: return "input contains NaN";
+    default: return "unknown status";
+    }
+}
+
+// count * size + SV_SCRATCH_ALIGN, or SIZE_MAX on overflow
+static size_t scratchFor(size_t count, size_t size) {
+    if (count > (SIZE_MAX - SV_SCRATCH_ALIGN) / size)
+        return SIZE_MAX;
+    return count * size + SV_SCRATCH_ALIGN;
+}
+
+size_t svScratchSizeInt32(SvAlgorithm algorithm, size_t n) {
+    switch (algorithm) {
+    case SV_ALGO_BUBBLE:
+    case SV_ALGO_HEAP:
+    case SV_ALGO_INSERTION:
+    case SV_ALGO_QUICK:
+    case SV_ALGO_SELECTION: return 0;
+    case SV_ALGO_MERGE:
+    case SV_ALGO_RADIX: return n < 2 ? 0 : scratchFor(n, sizeof(int32_t));
+    default: return SIZE_MAX;
+    }
+}
+
+size_t svScratchSizeFloat(SvAlgorithm algorithm, size_t n) {
+    switch (algorithm) {
+    case SV_ALGO_BUBBLE:
+    case SV_ALGO_HEAP:
+    case SV_ALGO_INSERTION:
+    case SV_ALGO_QUICK:
+    case SV_ALGO_SELECTION: return 0;
+    case SV_ALGO_MERGE: return n < 2 ? 0 : scratchFor(n, sizeof(float));
+    case SV_ALGO_RADIX:
+        // The key images and the pass buffer
+        if (n < 2)
+            return 0;
+        return n > SIZE_MAX / 2 ? SIZE_MAX : scratchFor(2 * n, sizeof(uint32_t));
+    case SV_ALGO_BUCKET:
+        // n floats, then n + 2 size_t counters (each part aligned)
+        if (n < 2)
+            return 0;
+        if (n > (SIZE_MAX / 2 - 4 * SV_SCRATCH_ALIGN) / sizeof(size_t))
+            return SIZE_MAX;
+        return scratchFor(n, sizeof(float)) + scratchFor(n + 2, sizeof(size_t));
+    default: return SIZE_MAX;
+    }
+}
+
+static void* alignUp(void* p) {
+    uintptr_t u = (uintptr_t)p;
+    return (void*)((u + SV_SCRATCH_ALIGN - 1) & ~(uintptr_t)(SV_SCRATCH_ALIGN - 1));
+}
+
+// Aligns the scratch buffer; NULL when it holds fewer than `bytes`
+static void* alignedScratch(void* scratch, size_t scratchBytes, size_t bytes) {
+    if (bytes == 0)
+        return scratch;
+    if (bytes == SIZE_MAX || scratch == NULL || scratchBytes < bytes)
+        return NULL;
+    return alignUp(scratch);
+}
+
+static int knownAlgorithm(SvAlgorithm algorithm) {
+    return (int)algorithm >= (int)SV_ALGO_BUBBLE && (int)algorithm <= (int)SV_ALGO_SELECTION;
+}
+
+static int log2Floor(size_t n) {
+    int r = 0;
+    while (n >>= 1)
+        ++r;
+    return r;
+}
+
+int svSortInt32(SvAlgorithm algorithm, int32_t* data, size_t n, void* scratch, size_t scratchBytes) {
+    if (!knownAlgorithm(algorithm) || (data == NULL && n > 0))
+        return SV_ERR_ARGUMENT;
+    if (algorithm == SV_ALGO_BUCKET)
+        return SV_ERR_UNSUPPORTED;
+    size_t need = svScratchSizeInt32(algorithm, n);
+    void* buffer = alignedScratch(scratch, scratchBytes, need);
+    if (need != 0 && buffer == NULL)
+        return SV_ERR_SCRATCH;
+    if (n < 2)
+        return SV_OK;
+
+    switch (algorithm) {
+    case SV_ALGO_BUBBLE: bubbleInt32(data, n); break;
+    case SV_ALGO_HEAP: heapInt32(data, n); break;
+    case SV_ALGO_INSERTION: insertionInt32(data, n); break;
+    case SV_ALGO_MERGE: mergeInt32(data, n, (int32_t*)buffer); break;
+    case SV_ALGO_QUICK: quickInt32(data, n, 2 * log2Floor(n)); break;
+    case SV_ALGO_SELECTION: selectionInt32(data, n); break;
+    case SV_ALGO_RADIX: {
+        // Flipping the sign bit maps int32 order onto uint32 order;
+        // int32_t and uint32_t may alias
+        uint32_t* keys = (uint32_t*)data;
+        for (size_t i = 0; i < n; ++i)
+            keys[i] ^= 0x80000000u;
+        radixUint32(keys, (uint32_t*)buffer, n);
+        for (size_t i = 0; i < n; ++i)
+            keys[i] ^= 0x80000000u;
+        break;
+    }
+    case SV_ALGO_BUCKET: break;
+    }
+    return SV_OK;
+}
+
+int svSortFloat(SvAlgorithm algorithm, float* data, size_t n, void* scratch, size_t scratchBytes) {
+    if (!knownAlgorithm(algorithm) || (data == NULL && n > 0))
+        return SV_ERR_ARGUMENT;
+    size_t need = svScratchSizeFloat(algorithm, n);
+    void* buffer = alignedScratch(scratch, scratchBytes, need);
+    if (need != 0 && buffer == NULL)
+        return SV_ERR_SCRATCH;
+    if (n < 2)
+        return SV_OK;
+    if (algorithm != SV_ALGO_RADIX)
+        for (size_t i = 0; i < n; ++i)
+            if (data[i] != data[i])
+                return SV_ERR_NAN;
+
+    switch (algorithm) {
+    case SV_ALGO_BUBBLE: bubbleFloat(data, n); break;
+    case SV_ALGO_HEAP: heapFloat(data, n); break;
+    case SV_ALGO_INSERTION: insertionFloat(data, n); break;
+    case SV_ALGO_MERGE: mergeFloat(data, n, (float*)buffer); break;
+    case SV_ALGO_QUICK: quickFloat(data, n, 2 * log2Floor(n)); break;
+    case SV_ALGO_SELECTION: selectionFloat(data, n); break;
+    case SV_ALGO_BUCKET: {
+        float* slots = (float*)buffer;
+        size_t* first = (size_t*)alignUp(slots + n);
+        bucketFloat(data, n, slots, first);
+        break;
+    }
+    case SV_ALGO_RADIX: {
+        // Float and uint32_t may not alias: sort the key images in scratch
+        uint32_t* keys = (uint32_t*)buffer;
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t bits;
+            memcpy(&bits, &data[i], sizeof(bits));
+            keys[i] = floatKey(bits);
+        }
+        radixUint32(keys, keys + n, n);
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t bits = floatBits(keys[i]);
+            memcpy(&data[i], &bits, sizeof(bits));
+        }
+        break;
+    }
+    }
+    return SV_OK;
+}
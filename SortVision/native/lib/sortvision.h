@@ -0,0 +1,86 @@
+/*
+ * sortvision.h
+ *
+ * libsortvision: the SortVision sorts as a plain C library for services
+ * that cannot link a C++ runtime.
+ *
+ *     size_t bytes = svScratchSizeInt32(SV_ALGO_RADIX, n);
+ *     void* scratch = malloc(bytes);              // or a static / arena buffer
+ *     int status = svSortInt32(SV_ALGO_RADIX, data, n, scratch, bytes);
+ *     if (status != SV_OK)
+ *         log("sort failed: %s", svStatusString(status));
+ *
+ * The library never allocates, keeps no global state and never exits: all
+ * temporary memory comes from the caller's scratch buffer (any alignment),
+ * and every failure is returned as a negative SvStatus with the input left
+ * untouched. Calls on different arrays may run concurrently.
+ *
+ * ABI: plain functions and int-valued enums with fixed numbers. New
+ * algorithms and status codes get new numbers; existing ones never
+ * change. svAbiVersion() returns SV_ABI_VERSION of the built library.
+ */
+#ifndef SORTVISION_LIB_H
+#define SORTVISION_LIB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define SV_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define SV_API __attribute__((visibility("default")))
+#else
+#define SV_API
+#endif
+
+#define SV_ABI_VERSION 1
+
+typedef enum SvAlgorithm {
+    SV_ALGO_BUBBLE = 0,
+    SV_ALGO_BUCKET = 1,    // float only
+    SV_ALGO_HEAP = 2,
+    SV_ALGO_INSERTION = 3,
+    SV_ALGO_MERGE = 4,     // stable
+    SV_ALGO_QUICK = 5,     // introsort: heap sort past 2*log2(n) levels
+    SV_ALGO_RADIX = 6,     // LSD, 8-bit digits
+    SV_ALGO_SELECTION = 7
+} SvAlgorithm;
+
+typedef enum SvStatus {
+    SV_OK = 0,
+    SV_ERR_ARGUMENT = -1,    // NULL data with n > 0, or an unknown algorithm
+    SV_ERR_SCRATCH = -2,     // scratch buffer smaller than svScratchSize*()
+    SV_ERR_UNSUPPORTED = -3, // algorithm not available for this key type
+    SV_ERR_NAN = -4          // float input contains NaN (all but radix sort)
+} SvStatus;
+
+SV_API int svAbiVersion(void);
+
+// Human-readable text for an SvStatus (never NULL)
+SV_API const char* svStatusString(int status);
+
+/*
+ * Scratch bytes needed to sort n keys, or SIZE_MAX when the algorithm
+ * does not support the key type or the size overflows. 0 means the sort
+ * is in place and scratch may be NULL.
+ */
+SV_API size_t svScratchSizeInt32(SvAlgorithm algorithm, size_t n);
+SV_API size_t svScratchSizeFloat(SvAlgorithm algorithm, size_t n);
+
+/*
+ * Sorts data[0, n) in ascending order. Float radix sort orders by the IEEE
+ * bit pattern (-0.0 before +0.0, negative NaNs first, positive NaNs last);
+ * the other float sorts return SV_ERR_NAN if the input holds a NaN.
+ */
+SV_API int svSortInt32(SvAlgorithm algorithm, int32_t* data, size_t n, void* scratch, size_t scratchBytes);
+SV_API int svSortFloat(SvAlgorithm algorithm, float* data, size_t n, void* scratch, size_t scratchBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SORTVISION_LIB_H */
@@ -0,0 +1,94 @@
+/**
+ * packedInts.cpp
+ *
+ * Round trips and corrupt-stream checks for packedInts.hpp.
+ *
+ *     g++ -std=c++17 -O2 -pthread -Iinclude tests/packedInts.cpp -o packedIntsTest && ./packedIntsTest
+ */
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "packedInts.hpp"
+
+namespace {
+
+// Byte offset of the count - 1 field in the header of block b
+size_t countField(size_t b)
+{
+    return sv::packed::kHeaderBytes + b * (sizeof(sv::packed::BlockHeader) + 16 * 2) +
+           offsetof(sv::packed::BlockHeader, countLess);
+}
+
+bool decodeThrows(const std::vector<uint8_t> &file, size_t count)
+{
+    sv::packed::Reader in(file.data(), file.size());
+    std::vector<int> out(count);
+    try
+    {
+        sv::packed::decode(in, out.data(), 4);
+    }
+    catch (const std::runtime_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+bool nextThrows(const std::vector<uint8_t> &file)
+{
+    sv::packed::Reader in(file.data(), file.size());
+    int block[sv::packed::kBlockSize];
+    try
+    {
+        while (in.next(block) != 0)
+        {
+        }
+    }
+    catch (const std::runtime_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main()
+{
+    // Test 1: Round trip of three blocks (128 + 128 + 44 keys, gaps of 3 take two bits)
+    std::vector<int> keys(300);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = static_cast<int>(3 * i) - 400;
+    std::vector<uint8_t> file = sv::packed::encode(keys.data(), keys.size());
+    sv::packed::Reader in(file.data(), file.size());
+    assert(in.count() == 300 && in.blocks() == 3);
+    std::vector<int> decoded(300);
+    sv::packed::decode(in, decoded.data(), 4);
+    assert(decoded == keys);
+    assert(in.at(299) == keys[299] && in.lowerBound(-1) == 133);
+    assert(!decodeThrows(file, 300) && !nextThrows(file));
+
+    // Test 2: A block header claiming more than kBlockSize keys
+    std::vector<uint8_t> tooMany = file;
+    tooMany[countField(0)] = 199;
+    assert(decodeThrows(tooMany, 300) && nextThrows(tooMany));
+    tooMany = file;
+    tooMany[countField(2)] = 255;
+    assert(decodeThrows(tooMany, 300) && nextThrows(tooMany));
+
+    // Test 3: A short block before the last one
+    std::vector<uint8_t> shortBlock = file;
+    shortBlock[countField(1)] = 99;
+    assert(decodeThrows(shortBlock, 300));
+
+    // Test 4: A last block that disagrees with the trailer's count
+    std::vector<uint8_t> longTail = file;
+    longTail[countField(2)] = 127;
+    assert(decodeThrows(longTail, 300));
+
+    std::cout << "✅ All test cases passed!\n";
+}
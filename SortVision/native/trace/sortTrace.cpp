@@ -0,0 +1,200 @@
+/**
+ * sortTrace.cpp
+ *
+ * Records operation traces of the C++ implementations and inspects them.
+ *
+ *   sortTrace record <algorithm> <n> <file> [distribution] [seed]
+ *       Sorts n generated keys with the Tracing policy and writes the
+ *       trace (see traceRecorder.hpp for the format).
+ *   sortTrace info <file>
+ *       Prints event and byte counts and checks that replaying the trace
+ *       ends in a sorted array.
+ *   sortTrace frames <file> <count>
+ *       Replays the trace decimated to about <count> frames and prints,
+ *       for each frame, how many positions already hold their final value.
+ *
+ * Build (from SortVision/native):
+ *   g++ -std=c++17 -O2 -pthread -Iinclude trace/sortTrace.cpp -o sortTrace
+ */
+
+#include "algorithms.hpp"
+#include "distributions.hpp"
+
+#include "../../public/code/common/cpp/traceReader.hpp"
+#include "../../public/code/common/cpp/traceRecorder.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using sv::trace::Tracing;
+
+/**
+ * Runs the named algorithm with the Tracing policy.
+ * @return false for an unknown algorithm name
+ */
+bool sortTraced(const std::string &algorithm, std::vector<int> &keys, std::vector<float> &floats)
+{
+    namespace impl = sv::impl;
+    if (algorithm == "bubble")
+        impl::bubble::bubbleSort<Tracing>(keys);
+    else if (algorithm == "insertion")
+        impl::insertion::insertionSort<Tracing>(keys);
+    else if (algorithm == "selection")
+        impl::selection::selectionSort<Tracing>(keys);
+    else if (algorithm == "tournament")
+        impl::selection::tournamentSort<Tracing>(keys);
+    else if (algorithm == "cycle")
+        impl::selection::cycleSort<Tracing>(keys);
+    else if (algorithm == "quick")
+        impl::quick::quickSort<Tracing>(keys);
+    else if (algorithm == "merge")
+    {
+        if (!keys.empty())
+            impl::merge::mergeSort<Tracing>(keys, 0, static_cast<ptrdiff_t>(keys.size()) - 1);
+    }
+    else if (algorithm == "heap")
+        impl::heap::heapSort<Tracing>(keys.data(), keys.size());
+    else if (algorithm == "radix")
+        impl::radix::radixSort<Tracing>(keys);
+    else if (algorithm == "bucket")
+        impl::bucket::bucketSort<Tracing>(floats.data(), floats.size());
+    else
+        return false;
+    return true;
+}
+
+int record(int argc, char **argv)
+{
+    if (argc < 5)
+        return -1;
+    std::string algorithm = argv[2];
+    size_t n = static_cast<size_t>(std::stod(argv[3]));
+    const char *path = argv[4];
+    sv::Distribution d = sv::Distribution::Uniform;
+    if (argc > 5 && !sv::parseDistribution(argv[5], d))
+    {
+        std::cerr << "error: unknown distribution " << argv[5] << "\n";
+        return 1;
+    }
+    uint64_t seed = argc > 6 ? std::stoull(argv[6]) : 42;
+
+    std::vector<int> keys = sv::generateInput(d, n, seed);
+    std::vector<float> floats;
+    bool isFloat = algorithm == "bucket";
+    if (isFloat)
+        floats.assign(keys.begin(), keys.end());
+
+    sv::trace::TraceRecorder recorder;
+    bool started = isFloat ? recorder.start(path, floats.data(), n) : recorder.start(path, keys.data(), n);
+    if (!started)
+    {
+        std::cerr << "error: cannot write " << path << "\n";
+        return 1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    bool known;
+    {
+        Tracing::Bind bind(recorder);
+        known = sortTraced(algorithm, keys, floats);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (!recorder.finish())
+    {
+        std::cerr << "error: writing " << path << " failed\n";
+        return 1;
+    }
+    if (!known)
+    {
+        std::cerr << "error: unknown algorithm " << algorithm << "\n";
+        return 1;
+    }
+
+    std::cout << algorithm << ": " << recorder.eventCount() << " events recorded in " << seconds << " s\n";
+    return 0;
+}
+
+bool openTrace(sv::trace::TraceReader &reader, const char *path)
+{
+    if (reader.open(path))
+        return true;
+    std::cerr << "error: " << path << " is not a readable trace\n";
+    return false;
+}
+
+int info(int argc, char **argv)
+{
+    if (argc < 3)
+        return -1;
+    sv::trace::TraceReader reader;
+    if (!openTrace(reader, argv[2]))
+        return 1;
+
+    std::ifstream file(argv[2], std::ios::binary | std::ios::ate);
+    double bytes = static_cast<double>(file.tellg());
+    const std::vector<int64_t> &result = reader.finalArray();
+    bool sorted = reader.valueKind() == sv::trace::ValueKind::Integer
+                      ? std::is_sorted(result.begin(), result.end())
+                      : std::is_sorted(result.begin(), result.end(), [](int64_t a, int64_t b) {
+                            float x, y;
+                            uint32_t ba = static_cast<uint32_t>(a), bb = static_cast<uint32_t>(b);
+                            std::memcpy(&x, &ba, sizeof(x));
+                            std::memcpy(&y, &bb, sizeof(y));
+                            return x < y;
+                        });
+
+    std::cout << "elements: " << reader.initial().size() << "\n"
+              << "events:   " << reader.eventCount() << "\n"
+              << "bytes:    " << static_cast<uint64_t>(bytes) << " ("
+              << (reader.eventCount() ? bytes / reader.eventCount() : 0.0) << " per event)\n"
+              << "replay:   " << (sorted ? "sorted" : "NOT sorted") << "\n";
+    return sorted ? 0 : 1;
+}
+
+int frames(int argc, char **argv)
+{
+    if (argc < 4)
+        return -1;
+    sv::trace::TraceReader reader;
+    if (!openTrace(reader, argv[2]))
+        return 1;
+    uint64_t count = std::max<uint64_t>(1, std::stoull(argv[3]));
+    const std::vector<int64_t> &target = reader.finalArray();
+
+    reader.decimate(reader.eventCount() / count, [&](uint64_t event, const std::vector<int64_t> &state) {
+        size_t placed = 0;
+        for (size_t i = 0; i < state.size(); ++i)
+            placed += state[i] == target[i];
+        std::cout << event << '\t' << placed << '\n';
+    });
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string command = argc > 1 ? argv[1] : "";
+    int rc = -1;
+    if (command == "record")
+        rc = record(argc, argv);
+    else if (command == "info")
+        rc = info(argc, argv);
+    else if (command == "frames")
+        rc = frames(argc, argv);
+
+    if (rc < 0)
+    {
+        std::cerr << "Usage:\n"
+                  << "  " << argv[0] << " record <algorithm> <n> <file> [distribution] [seed]\n"
+                  << "  " << argv[0] << " info <file>\n"
+                  << "  " << argv[0] << " frames <file> <count>\n";
+        return 1;
+    }
+    return rc;
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * Bubble Sort implementation
@@ -17,13 +18,13 @@
  * @param arr The array to sort
  * @param n   The number of elements in the array
  */
-void bubbleSort(int arr[], int n) {
+void bubbleSort(int arr[], size_t n) {
     if (n <= 1) return;  // Handle empty or single-element arrays
 
-    for (int i = 0; i < n - 1; i++) {
+    for (size_t i = 0; i < n - 1; i++) {
         bool swapped = false;
 
-        for (int j = 0; j < n - i - 1; j++) {
+        for (size_t j = 0; j < n - i - 1; j++) {
             if (arr[j] > arr[j + 1]) {
                 // Swap elements
                 int temp = arr[j];
@@ -42,11 +43,11 @@ void bubbleSort(int arr[], int n) {
 /**
  * Utility function to print an array
  */
-void printArray(int arr[], int n) {
+void printArray(int arr[], size_t n) {
     printf("[");
-    for (int i = 0; i < n; i++) {
+    for (size_t i = 0; i < n; i++) {
         printf("%d", arr[i]);
-        if (i != n - 1) printf(", ");
+        if (i + 1 != n) printf(", ");
     }
     printf("]\n");
 }
@@ -1,21 +1,37 @@
 #include <bits/stdc++.h>
+
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/sortControl.hpp"
+
 using namespace std;
 
 #define fastio() ios_base::sync_with_stdio(false); cin.tie(NULL); cout.tie(NULL)
 
+// Ops: operation-counting policy (see opCounters.hpp)
+// Progress is reported per pass, in comparisons (n(n-1)/2 in total)
+template <class Ops = sv::ops::NoCounting>
 void bubbleSort(vector<int>& arr) {
-    int n = arr.size();
-    for (int i = 0; i < n - 1; ++i) {
+    size_t n = arr.size();
+    size_t total = n < 2 ? 0 : n * (n - 1) / 2;
+    if (!Ops::advance(0, total)) return;
+    for (size_t i = 0; i + 1 < n; ++i) {
         // Optimization: check if any swap occurred
         bool swapped = false;
-        for (int j = 0; j < n - i - 1; ++j) {
+        for (size_t j = 0; j + 1 < n - i; ++j) {
+            Ops::compare(j, j + 1);
             if (arr[j] > arr[j + 1]) {
+                Ops::swap(j, j + 1);
                 swap(arr[j], arr[j + 1]);
                 swapped = true;
             }
         }
         // If no two elements were swapped, array is already sorted
-        if (!swapped) break;
+        if (!swapped) {
+            size_t rest = (n - i) * (n - i - 1) / 2; // this pass included
+            Ops::advance(rest, 0);
+            break;
+        }
+        if (!Ops::advance(n - i - 1, 0)) return;
     }
 }
 
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../common/c/sortWorkspace.h"
+
 // Bucket Sort Implementation in C
 // This implementation sorts an array of floating-point numbers using the Bucket Sort algorithm.
 // It divides the array into a specified number of buckets, sorts each bucket using Insertion Sort,
@@ -15,84 +17,66 @@
 // Space Complexity: O(n + k)
 
 // Helper function: Insertion Sort for individual buckets
-void insertionSort(float* bucket, int size) {
-    for (int i = 1; i < size; i++) {
+void insertionSort(float* bucket, size_t size) {
+    for (size_t i = 1; i < size; i++) {
         float key = bucket[i];
-        int j = i - 1;
+        size_t j = i;  // the hole the key moves into
 
-        while (j >= 0 && bucket[j] > key) {
-            bucket[j + 1] = bucket[j];
+        while (j > 0 && bucket[j - 1] > key) {
+            bucket[j] = bucket[j - 1];
             j--;
         }
-        bucket[j + 1] = key;
+        bucket[j] = key;
     }
 }
 
 // Core Bucket Sort Function
-void bucketSort(float arr[], int n, int bucketCount) {
-    if (n <= 1 || bucketCount <= 0) return;
+void bucketSort(float arr[], size_t n, size_t bucketCount) {
+    if (n <= 1 || bucketCount == 0) return;
 
     // 1. Find minimum and maximum values in the array
     float min = arr[0], max = arr[0];
-    for (int i = 1; i < n; i++) {
+    for (size_t i = 1; i < n; i++) {
         if (arr[i] < min) min = arr[i];
         if (arr[i] > max) max = arr[i];
     }
 
-    // 2. Allocate memory for buckets
-    float** buckets = (float**)malloc(bucketCount * sizeof(float*));
-    int* sizes = (int*)calloc(bucketCount, sizeof(int));
-    int* capacities = (int*)malloc(bucketCount * sizeof(int));
+    // 2. Lay the buckets out back to back in the thread's workspace:
+    //    bucket b occupies slots[first[b] .. first[b + 1])
+    size_t bytes = (2 * bucketCount + 1) * sizeof(size_t) + n * sizeof(float);
+    size_t* first = (size_t*)sortWorkspaceReserve(sortWorkspaceThisThread(), bytes);
+    size_t* next = first + bucketCount + 1;
+    float* slots = (float*)(next + bucketCount);
+    for (size_t b = 0; b <= bucketCount; b++) first[b] = 0;
 
-    if (!buckets || !sizes || !capacities) {
-        fprintf(stderr, "Memory allocation failed.\n");
-        exit(EXIT_FAILURE);
+    // 3. Count the bucket sizes, then distribute array elements into the buckets
+    float denominator = max - min + 1e-9; // Precompute the denominator
+    for (size_t i = 0; i < n; i++) {
+        size_t index = (size_t)(((arr[i] - min) / denominator) * bucketCount); // normalize and scale
+        if (index >= bucketCount) index = bucketCount - 1;
+        first[index + 1]++;
     }
-
-    for (int i = 0; i < bucketCount; i++) {
-        capacities[i] = INITIAL_BUCKET_CAPACITY; // initial capacity
-        buckets[i] = (float*)malloc(capacities[i] * sizeof(float));
-        if (!buckets[i]) {
-            fprintf(stderr, "Memory allocation failed for bucket %d\n", i);
-            exit(EXIT_FAILURE);
-        }
+    for (size_t b = 0; b < bucketCount; b++) {
+        first[b + 1] += first[b];
+        next[b] = first[b];
     }
-
-    // 3. Distribute array elements into appropriate buckets
-    float denominator = max - min + 1e-9; // Precompute the denominator
-    for (int i = 0; i < n; i++) {
-        int index = (int)(((arr[i] - min) / denominator) * bucketCount); // normalize and scale
+    for (size_t i = 0; i < n; i++) {
+        size_t index = (size_t)(((arr[i] - min) / denominator) * bucketCount);
         if (index >= bucketCount) index = bucketCount - 1;
-
-        if (sizes[index] == capacities[index]) {
-            capacities[index] *= 2;
-            float* newBucket = (float*)realloc(buckets[index], capacities[index] * sizeof(float));
-            if (!newBucket) {
-                fprintf(stderr, "Memory reallocation failed for bucket %d\n", index);
-                exit(EXIT_FAILURE);
-            }
-            buckets[index] = newBucket;
-        }
-
-        buckets[index][sizes[index]++] = arr[i];
+        slots[next[index]++] = arr[i];
     }
 
     // 4. Sort each bucket and concatenate results
-    int pos = 0;
-    for (int i = 0; i < bucketCount; i++) {
-        if (sizes[i] > 0) {
-            insertionSort(buckets[i], sizes[i]);
-            for (int j = 0; j < sizes[i]; j++) {
-                arr[pos++] = buckets[i][j];
+    size_t pos = 0;
+    for (size_t b = 0; b < bucketCount; b++) {
+        size_t size = first[b + 1] - first[b];
+        if (size > 0) {
+            insertionSort(slots + first[b], size);
+            for (size_t j = 0; j < size; j++) {
+                arr[pos++] = slots[first[b] + j];
             }
         }
-        free(buckets[i]);
     }
-
-    // 5. Cleanup
-    free(buckets);
-    free(sizes);
-    free(capacities);
 }
 
 // Test cases and example usage
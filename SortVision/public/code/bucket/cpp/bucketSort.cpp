@@ -17,14 +17,31 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/perfCounters.hpp"
+#include "../../common/cpp/simdScan.hpp"
+#include "../../common/cpp/sortControl.hpp"
+#include "../../common/cpp/sortWorkspace.hpp"
 
 /**
- * Sorts an array of floats using the Bucket Sort algorithm.
+ * Bucket sort of arr[0, n) with Index-typed bucket bookkeeping.
  *
  * @param arr  Pointer to the first element of the array.
  * @param n    Number of elements in the array.
+ * @param ws   Workspace the buckets are laid out in (see sortWorkspace.hpp).
+ * @tparam Ops  Operation-counting policy (see opCounters.hpp). Comparisons
+ *              inside a bucket are reported at the positions the bucket
+ *              will occupy in the output. Progress is reported every
+ *              1024 output elements; when cancelled, the remaining buckets
+ *              are copied back unsorted.
+ * @tparam Index Type of the bucket bookkeeping; bucketSort() picks
+ *               uint32_t when n allows, halving that memory.
  */
-void bucketSort(float arr[], int n)
+template <class Ops, class Index>
+void bucketSortIndexed(float arr[], size_t n, sv::SortWorkspace &ws)
 {
     if (n <= 1 || arr == nullptr)
     {
@@ -32,77 +49,100 @@ void bucketSort(float arr[], int n)
         return;
     }
 
-    // Find minimum and maximum values in the array
-    float minValue = arr[0];
-    float maxValue = arr[0];
-    for (int i = 1; i < n; ++i)
-    {
-        if (arr[i] < minValue)
-            minValue = arr[i];
-        if (arr[i] > maxValue)
-            maxValue = arr[i];
-    }
+    // Find minimum and maximum values in the array (one SIMD pass)
+    auto [minValue, maxValue] = sv::simd::minMax(arr, n);
 
     // Number of buckets: here we use n buckets for simplicity
     // Use n buckets for better distribution and to avoid O(n^2) worst-case
-    int bucketCount = std::max(1, n);
-    std::vector<std::vector<float>> buckets(bucketCount);
-    // Optionally reserve space for buckets to reduce reallocations
-    for (auto &bucket : buckets)
-    {
-        bucket.reserve(n / bucketCount + 1);
-    }
-    // Distribute array elements into buckets
+    size_t bucketCount = n;
     float range = maxValue - minValue;
     if (range == 0.0f)
     {
-        // All elements are equal; place all in the first bucket
-        for (int i = 0; i < n; ++i)
-        {
-            buckets[0].push_back(arr[i]);
-        }
+        // All elements are equal; nothing to do
+        return;
     }
-    else
+
+    // The buckets are laid out back to back in one workspace array:
+    // bucket b occupies slots[first[b] .. first[b + 1])
+    sv::SortWorkspace::Scope scope(ws);
+    Index *bucketOf = ws.take<Index>(n);
+    Index *first = ws.take<Index>(bucketCount + 1);
+    Index *next = ws.take<Index>(bucketCount);
+    float *slots = ws.take<float>(n);
     {
-        for (int i = 0; i < n; ++i)
+        SV_PERF_PHASE("bucketDistribute", n);
+        std::fill(first, first + bucketCount + 1, Index(0));
+        for (size_t i = 0; i < n; ++i)
         {
-            int index = static_cast<int>(bucketCount * (arr[i] - minValue) / (range + 1e-6f));
-            // Clamp index to valid range
-            if (index < 0)
-                index = 0;
+            // Never negative; clamp to the last bucket
+            size_t index = static_cast<size_t>(bucketCount * (arr[i] - minValue) / (range + 1e-6f));
             if (index >= bucketCount)
                 index = bucketCount - 1;
-            buckets[index].push_back(arr[i]);
+            bucketOf[i] = static_cast<Index>(index);
+            ++first[index + 1];
         }
-        // Sort each bucket and concatenate into original array
-        int idx = 0;
-        for (auto &bucket : buckets)
+        for (size_t b = 0; b < bucketCount; ++b)
+            first[b + 1] += first[b];
+        // Distribute array elements into buckets, keeping their input order
+        std::copy(first, first + bucketCount, next);
+        for (size_t i = 0; i < n; ++i)
+            slots[next[bucketOf[i]]++] = arr[i];
+        Ops::scratch(n);
+    }
+
+    // Sort each bucket and concatenate into original array
+    SV_PERF_PHASE("bucketFinish", n);
+    if (!Ops::advance(0, n))
+        return;
+    size_t idx = 0, reported = 0;
+    for (size_t b = 0; b < bucketCount; ++b)
+    {
+        float *bucket = slots + first[b];
+        size_t size = static_cast<size_t>(first[b + 1] - first[b]);
+        if (size == 0)
+            continue;
+        if (size <= 32)
         {
-            if (!bucket.empty())
+            // Use insertion sort for small buckets
+            for (size_t i = 1; i < size; ++i)
             {
-                if (bucket.size() <= 32)
-                {
-                    // Use insertion sort for small buckets
-                    for (size_t i = 1; i < bucket.size(); ++i)
-                    {
-                        float key = bucket[i];
-                        size_t j = i;
-                        while (j > 0 && bucket[j - 1] > key)
-                        {
-                            bucket[j] = bucket[j - 1];
-                            --j;
-                        }
-                        bucket[j] = key;
-                    }
-                }
-                else
-                {
-                    std::sort(bucket.begin(), bucket.end());
-                }
-                for (float val : bucket)
+                float key = bucket[i];
+                size_t j = i;
+                while (j > 0 && (Ops::compare(idx + j - 1, idx + j), bucket[j - 1] > key))
                 {
-                    arr[idx++] = val;
+                    Ops::scratch(1);
+                    bucket[j] = bucket[j - 1];
+                    --j;
                 }
+                Ops::scratch(1);
+                bucket[j] = key;
+            }
+        }
+        else if constexpr (Ops::enabled)
+        {
+            size_t lo = idx, hi = idx + size - 1;
+            std::sort(bucket, bucket + size, [=](float a, float b) {
+                Ops::compare(lo, hi);
+                return a < b;
+            });
+        }
+        else
+        {
+            std::sort(bucket, bucket + size);
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            Ops::write(idx, bucket[i]);
+            arr[idx++] = bucket[i];
+        }
+        if (idx - reported >= 1024 || idx == n)
+        {
+            bool go = Ops::advance(idx - reported, 0);
+            reported = idx;
+            if (!go)
+            {
+                std::copy(slots + idx, slots + n, arr + idx);
+                return;
             }
         }
     }
@@ -116,7 +156,24 @@ void bucketSort(float arr[], int n)
      *  - O(n + k)  for buckets and array storage
      */
 
-    } // End of bucketSort
+    } // End of bucketSortIndexed
+
+/**
+ * Sorts an array of floats using the Bucket Sort algorithm.
+ *
+ * @param arr  Pointer to the first element of the array.
+ * @param n    Number of elements in the array.
+ * @param ws   Workspace the buckets are laid out in (see sortWorkspace.hpp).
+ * @tparam Ops Operation-counting policy (see opCounters.hpp).
+ */
+template <class Ops = sv::ops::NoCounting>
+void bucketSort(float arr[], size_t n, sv::SortWorkspace &ws = sv::SortWorkspace::thisThread())
+{
+    if (n <= UINT32_MAX)
+        bucketSortIndexed<Ops, uint32_t>(arr, n, ws);
+    else
+        bucketSortIndexed<Ops, size_t>(arr, n, ws);
+}
     
     /**
      * Prints an array to stdout.
@@ -124,10 +181,10 @@ void bucketSort(float arr[], int n)
      * @param arr  Pointer to the first element of the array.
      * @param n    Number of elements in the array.
      */
-    void printArray(const float arr[], int n)
+    void printArray(const float arr[], size_t n)
     {
         std::cout << '[';
-        for (int i = 0; i < n; ++i)
+        for (size_t i = 0; i < n; ++i)
         {
             std::cout << arr[i];
             if (i < n - 1)
@@ -150,7 +207,7 @@ void bucketSort(float arr[], int n)
     
         for (auto &caseArr : testCases)
         {
-            int n = static_cast<int>(caseArr.size());
+            size_t n = caseArr.size();
             float *arr = n ? caseArr.data() : nullptr;
     
             std::cout << "Original: ";
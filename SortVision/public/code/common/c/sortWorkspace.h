@@ -0,0 +1,62 @@
+/*
+ * sortWorkspace.h
+ *
+ * Reusable scratch memory for the out-of-place C sorts.
+ *
+ * A SortWorkspace is one growable buffer. sortWorkspaceReserve() returns
+ * it with room for at least the requested bytes, growing it (to at least
+ * twice its size) only when it is too small, so repeated sorts of similar
+ * sizes stop calling malloc after the first one.
+ *
+ *     SortWorkspace ws = SORT_WORKSPACE_INIT;
+ *     int* tmp = sortWorkspaceReserve(&ws, n * sizeof(int));
+ *     ...
+ *     sortWorkspaceFree(&ws);
+ *
+ * The sorts use sortWorkspaceThisThread(), a per-thread workspace that
+ * lives until the thread calls sortWorkspaceFree() on it. Only one user
+ * may hold the buffer at a time: a sort takes everything it needs in one
+ * reservation and does not call another sort while using it.
+ */
+#ifndef SORTVISION_SORT_WORKSPACE_H
+#define SORTVISION_SORT_WORKSPACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct SortWorkspace {
+    void* data;
+    size_t capacity; // bytes
+} SortWorkspace;
+
+#define SORT_WORKSPACE_INIT {NULL, 0}
+
+// Returns a buffer of at least `bytes` bytes (contents unspecified)
+static inline void* sortWorkspaceReserve(SortWorkspace* ws, size_t bytes) {
+    if (bytes > ws->capacity) {
+        size_t capacity = ws->capacity * 2 > bytes ? ws->capacity * 2 : bytes;
+        // The old contents are not needed, so free + malloc instead of realloc
+        free(ws->data);
+        ws->data = malloc(capacity);
+        ws->capacity = ws->data ? capacity : 0;
+        if (!ws->data) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return ws->data;
+}
+
+static inline void sortWorkspaceFree(SortWorkspace* ws) {
+    free(ws->data);
+    ws->data = NULL;
+    ws->capacity = 0;
+}
+
+// The calling thread's workspace
+static inline SortWorkspace* sortWorkspaceThisThread(void) {
+    static _Thread_local SortWorkspace ws = SORT_WORKSPACE_INIT;
+    return &ws;
+}
+
+#endif /* SORTVISION_SORT_WORKSPACE_H */
@@ -0,0 +1,178 @@
+/**
+ * hugePages.hpp
+ *
+ * Huge-page backed buffers for very large sorts. With 4 KiB pages a
+ * billion-int array spans a million pages and every pass over it misses
+ * the TLB; 2 MiB pages cut that by 512x.
+ *
+ *     sv::huge::Buffer buf = sv::huge::allocate(bytes, sv::huge::Mode::Transparent);
+ *     int *keys = static_cast<int *>(buf.get());
+ *
+ *     sv::huge::advise(vec.data(), vec.size() * sizeof(int)); // existing memory
+ *
+ * Modes:
+ *  - Off:         plain operator new
+ *  - Transparent: anonymous mmap aligned to 2 MiB plus madvise(MADV_HUGEPAGE),
+ *                 so transparent huge pages back it even when THP is set to
+ *                 "madvise" (/sys/kernel/mm/transparent_hugepage/enabled)
+ *  - Explicit:    mmap(MAP_HUGETLB) from the reserved hugetlbfs pool
+ *                 (vm.nr_hugepages); falls back to Transparent when the pool
+ *                 is empty or too small
+ *
+ * SortWorkspace uses defaultMode() for its blocks, so setting
+ * SORTVISION_HUGEPAGES=thp (or hugetlb) moves every sort's scratch memory
+ * onto huge pages without code changes.
+ *
+ * Requests below one huge page always use operator new. Off Linux every
+ * mode is Off. Memory is uninitialized in all modes; mmap'ed memory is
+ * zero-filled by the kernel on first touch.
+ */
+#ifndef SORTVISION_HUGE_PAGES_HPP
+#define SORTVISION_HUGE_PAGES_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace sv::huge {
+
+enum class Mode
+{
+    Off,
+    Transparent,
+    Explicit
+};
+
+constexpr size_t kPageSize = size_t(2) << 20; // x86-64 and arm64 (4K granule)
+
+/** Frees a Buffer the way it was allocated. */
+class Deleter
+{
+public:
+    Deleter() = default;
+    explicit Deleter(size_t mappedBytes) : mapped(mappedBytes) {}
+
+    void operator()(void *p) const
+    {
+#ifdef __linux__
+        if (mapped != 0)
+        {
+            ::munmap(p, mapped);
+            return;
+        }
+#endif
+        ::operator delete(p);
+    }
+
+    /** Bytes mapped with mmap (0 = operator new). */
+    size_t mappedBytes() const { return mapped; }
+
+private:
+    size_t mapped = 0;
+};
+
+using Buffer = std::unique_ptr<void, Deleter>;
+
+/**
+ * madvise(MADV_HUGEPAGE) over the 2 MiB aligned pages inside [p, p + bytes).
+ * Works on any existing buffer, e.g. a large std::vector (which glibc
+ * mmaps); the unaligned head and tail keep small pages.
+ * @return false when nothing was advised or the kernel refused
+ */
+inline bool advise(void *p, size_t bytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(p) + kPageSize - 1) & ~(uintptr_t(kPageSize) - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(p) + bytes) & ~(uintptr_t(kPageSize) - 1);
+    return begin < end && ::madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE) == 0;
+#else
+    (void)p;
+    (void)bytes;
+    return false;
+#endif
+}
+
+/**
+ * At least `bytes` of uninitialized memory, backed by huge pages when the
+ * mode and the system allow it. Throws std::bad_alloc like operator new.
+ */
+inline Buffer allocate(size_t bytes, Mode mode)
+{
+#ifdef __linux__
+    if (mode != Mode::Off && bytes >= kPageSize)
+    {
+        size_t rounded = (bytes + kPageSize - 1) & ~(kPageSize - 1);
+#ifdef MAP_HUGETLB
+        if (mode == Mode::Explicit)
+        {
+            void *p = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                             -1, 0);
+            if (p != MAP_FAILED)
+                return Buffer(p, Deleter(rounded));
+        }
+#endif
+        // Over-map by one huge page and trim so the region starts 2 MiB aligned
+        size_t span = rounded + kPageSize;
+        void *raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            throw std::bad_alloc();
+        uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (base + kPageSize - 1) & ~(uintptr_t(kPageSize) - 1);
+        if (aligned > base)
+            ::munmap(raw, aligned - base);
+        if (base + span > aligned + rounded)
+            ::munmap(reinterpret_cast<void *>(aligned + rounded), base + span - aligned - rounded);
+        void *p = reinterpret_cast<void *>(aligned);
+        advise(p, rounded);
+        return Buffer(p, Deleter(rounded));
+    }
+#else
+    (void)mode;
+#endif
+    return Buffer(::operator new(bytes), Deleter());
+}
+
+/** Parses "off", "thp" or "hugetlb". @return false for anything else */
+inline bool parseMode(const char *name, Mode &mode)
+{
+    if (std::strcmp(name, "off") == 0)
+        mode = Mode::Off;
+    else if (std::strcmp(name, "thp") == 0)
+        mode = Mode::Transparent;
+    else if (std::strcmp(name, "hugetlb") == 0)
+        mode = Mode::Explicit;
+    else
+        return false;
+    return true;
+}
+
+namespace detail {
+inline std::atomic<Mode> &defaultMode()
+{
+    static std::atomic<Mode> mode([] {
+        Mode m = Mode::Off;
+        const char *v = std::getenv("SORTVISION_HUGEPAGES");
+        return v != nullptr && parseMode(v, m) ? m : Mode::Off;
+    }());
+    return mode;
+}
+} // namespace detail
+
+/**
+ * Process-wide mode for new SortWorkspaces (including every thread's
+ * thisThread() workspace). Starts as SORTVISION_HUGEPAGES, or Off.
+ */
+inline Mode defaultMode() { return detail::defaultMode().load(std::memory_order_relaxed); }
+inline void setDefaultMode(Mode mode) { detail::defaultMode().store(mode, std::memory_order_relaxed); }
+
+} // namespace sv::huge
+
+#endif // SORTVISION_HUGE_PAGES_HPP
@@ -0,0 +1,181 @@
+/**
+ * opCounters.hpp
+ *
+ * Operation-counting policies for the C++ sorts.
+ *
+ * Every sort takes an `Ops` template parameter (default: NoCounting) and
+ * reports what it does through static hooks:
+ *
+ *     Ops::compare(i, j)    two elements compared (positions in the array)
+ *     Ops::swap(i, j)       arr[i] and arr[j] exchanged
+ *     Ops::write(i, value)  value stored into arr[i]
+ *     Ops::scratch(count)   count elements copied into temporary storage
+ *     Ops::advance(units, total)
+ *                           `units` more units of work finished, out of
+ *                           `total` (0 = unchanged); false asks the sort to
+ *                           stop. Called at coarse points only (per
+ *                           partition, merge, pass or 1024 elements); see
+ *                           sortControl.hpp
+ *     typename Ops::Depth   RAII guard placed at the top of each recursive call
+ *
+ * NoCounting has empty inline hooks and an empty Depth type, so the
+ * default instantiation compiles to exactly the uninstrumented code.
+ *
+ * Counting keeps plain (non-atomic) counters in a thread_local block, so
+ * the hot path is a TLS increment. Each block registers itself once per
+ * thread; when the thread exits its counts are folded into a global total
+ * under a mutex. Counting::total() sums the folded totals and the blocks
+ * of live threads, so call it once the sorting threads are finished.
+ *
+ * Usage:
+ *     quickSort<sv::ops::Counting>(vec);
+ *     sv::ops::OpCounts c = sv::ops::Counting::thisThread();
+ */
+#ifndef SORTVISION_OP_COUNTERS_HPP
+#define SORTVISION_OP_COUNTERS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace sv::ops {
+
+struct OpCounts
+{
+    uint64_t comparisons = 0;
+    uint64_t swaps = 0;
+    uint64_t moves = 0;    // element writes into the array or scratch space
+    uint64_t maxDepth = 0; // deepest recursion reached
+
+    OpCounts &operator+=(const OpCounts &other)
+    {
+        comparisons += other.comparisons;
+        swaps += other.swaps;
+        moves += other.moves;
+        maxDepth = std::max(maxDepth, other.maxDepth);
+        return *this;
+    }
+};
+
+/**
+ * Default policy: every hook is a no-op.
+ */
+struct NoCounting
+{
+    static constexpr bool enabled = false;
+
+    static void compare(size_t, size_t) {}
+    static void swap(size_t, size_t) {}
+    template <typename T>
+    static void write(size_t, const T &) {}
+    static void scratch(size_t) {}
+    static constexpr bool advance(size_t, size_t) { return true; }
+
+    struct Depth
+    {
+        Depth() {} // user-provided so unused guards do not trigger warnings
+    };
+};
+
+/**
+ * Counting policy: per-thread counters, aggregated on demand.
+ */
+class Counting
+{
+public:
+    static constexpr bool enabled = true;
+
+    static void compare(size_t, size_t) { ++local().counts.comparisons; }
+    static void swap(size_t, size_t) { ++local().counts.swaps; }
+    template <typename T>
+    static void write(size_t, const T &) { ++local().counts.moves; }
+    static void scratch(size_t count) { local().counts.moves += count; }
+    static constexpr bool advance(size_t, size_t) { return true; }
+
+    class Depth
+    {
+    public:
+        Depth()
+        {
+            ThreadState &s = local();
+            if (++s.depth > s.counts.maxDepth)
+                s.counts.maxDepth = s.depth;
+        }
+        ~Depth() { --local().depth; }
+        Depth(const Depth &) = delete;
+        Depth &operator=(const Depth &) = delete;
+    };
+
+    /** Counts recorded by the calling thread since the last reset(). */
+    static OpCounts thisThread() { return local().counts; }
+
+    /** Counts of all threads, live and exited, since the last reset(). */
+    static OpCounts total()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        OpCounts sum = r.retired;
+        for (const ThreadState *s : r.live)
+            sum += s->counts;
+        return sum;
+    }
+
+    /** Clears every thread's counts. Call while no sort is running. */
+    static void reset()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        r.retired = OpCounts();
+        for (ThreadState *s : r.live)
+            s->counts = OpCounts();
+    }
+
+private:
+    struct ThreadState;
+
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<ThreadState *> live;
+        OpCounts retired;
+    };
+
+    static Registry &registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    struct ThreadState
+    {
+        OpCounts counts;
+        uint64_t depth = 0;
+
+        ThreadState()
+        {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+            r.live.push_back(this);
+        }
+
+        ~ThreadState()
+        {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+            r.retired += counts;
+            r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+        }
+    };
+
+    static ThreadState &local()
+    {
+        static thread_local ThreadState state;
+        return state;
+    }
+};
+
+} // namespace sv::ops
+
+#endif // SORTVISION_OP_COUNTERS_HPP
@@ -0,0 +1,320 @@
+/**
+ * perfCounters.hpp
+ *
+ * Hardware performance-counter instrumentation for named sort phases.
+ *
+ * Usage inside an implementation:
+ *
+ *     SV_PERF_PHASE("partition", high - low + 1);   // RAII: measures to end of scope
+ *
+ * Build with -DSORTVISION_PERF on Linux to enable it; otherwise every
+ * SV_PERF_PHASE expands to nothing and the helpers below are empty
+ * inline functions, so instrumented code compiles to the same binary.
+ *
+ * When enabled, each thread opens one perf_event_open group counting
+ * user-space cycles, instructions, branch misses, last-level cache misses
+ * and dTLB load misses. A phase scope reads the group on entry and exit
+ * (one read() each) and adds the difference to the phase totals.
+ *
+ * Scopes covering fewer than SORTVISION_PERF_MIN_ELEMENTS elements are
+ * only tallied, not measured: two syscalls per 10-element partition would
+ * dwarf the work being measured. The report shows how many elements were
+ * actually covered so the numbers can be read in context.
+ *
+ * If the kernel refuses the events (perf_event_paranoid, containers, VMs
+ * without a PMU), counters read as unavailable and scopes cost one branch.
+ */
+#ifndef SORTVISION_PERF_COUNTERS_HPP
+#define SORTVISION_PERF_COUNTERS_HPP
+
+#include <iosfwd>
+
+#if defined(SORTVISION_PERF) && defined(__linux__)
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SORTVISION_PERF_MIN_ELEMENTS
+#define SORTVISION_PERF_MIN_ELEMENTS 1024
+#endif
+
+namespace sv::perf {
+
+enum Counter
+{
+    Cycles,
+    Instructions,
+    BranchMisses,
+    LlcMisses,
+    DtlbMisses,
+    CounterCount
+};
+
+inline const char *counterName(int c)
+{
+    static const char *const names[CounterCount] = {"cycles", "instructions", "branch-misses", "llc-misses",
+                                                    "dtlb-misses"};
+    return names[c];
+}
+
+/**
+ * Totals for one named phase, shared by all threads.
+ */
+struct Phase
+{
+    explicit Phase(std::string phaseName) : name(std::move(phaseName)) {}
+
+    std::string name;
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> elements{0};
+    std::atomic<uint64_t> measuredCalls{0};
+    std::atomic<uint64_t> measuredElements{0};
+    std::atomic<uint64_t> counts[CounterCount] = {};
+};
+
+struct Registry
+{
+    std::mutex lock;
+    std::vector<std::unique_ptr<Phase>> phases;
+};
+
+inline Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * Returns the phase with the given name, creating it on first use.
+ * Called once per instrumented site (the result is cached in a static).
+ */
+inline Phase &registerPhase(const char *name)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for (auto &p : r.phases)
+        if (p->name == name)
+            return *p;
+    r.phases.push_back(std::make_unique<Phase>(name));
+    return *r.phases.back();
+}
+
+/**
+ * One perf_event_open group per thread, opened on first use.
+ */
+class CounterGroup
+{
+public:
+    CounterGroup()
+    {
+        const struct
+        {
+            uint32_t type;
+            uint64_t config;
+        } events[CounterCount] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        };
+
+        for (int c = 0; c < CounterCount; ++c)
+        {
+            slot[c] = -1;
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[c].type;
+            attr.config = events[c].config;
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.disabled = leader < 0 ? 1 : 0;
+
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0)
+                continue; // this event is not available here; keep the others
+            if (leader < 0)
+                leader = fd;
+            fds.push_back(fd);
+            slot[c] = static_cast<int>(fds.size()) - 1;
+        }
+
+        if (leader >= 0)
+        {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    ~CounterGroup()
+    {
+        for (int fd : fds)
+            close(fd);
+    }
+
+    CounterGroup(const CounterGroup &) = delete;
+    CounterGroup &operator=(const CounterGroup &) = delete;
+
+    bool available() const { return leader >= 0; }
+    bool has(int c) const { return slot[c] >= 0; }
+
+    /**
+     * Reads all counters in one syscall.
+     * @return false if the group is unavailable or the read failed
+     */
+    bool read(uint64_t (&out)[CounterCount]) const
+    {
+        if (leader < 0)
+            return false;
+        uint64_t buffer[1 + CounterCount];
+        ssize_t expected = static_cast<ssize_t>((1 + fds.size()) * sizeof(uint64_t));
+        if (::read(leader, buffer, sizeof(buffer)) < expected)
+            return false;
+        for (int c = 0; c < CounterCount; ++c)
+            out[c] = slot[c] >= 0 ? buffer[1 + slot[c]] : 0;
+        return true;
+    }
+
+    static CounterGroup &forThisThread()
+    {
+        static thread_local CounterGroup group;
+        return group;
+    }
+
+private:
+    int leader = -1;
+    int slot[CounterCount];
+    std::vector<int> fds;
+};
+
+/**
+ * RAII scope that charges the counter deltas to a phase.
+ */
+class Scope
+{
+public:
+    Scope(Phase &p, uint64_t elementCount) : phase(p), elements(elementCount)
+    {
+        measuring = elements >= SORTVISION_PERF_MIN_ELEMENTS && CounterGroup::forThisThread().read(start);
+    }
+
+    ~Scope()
+    {
+        phase.calls.fetch_add(1, std::memory_order_relaxed);
+        phase.elements.fetch_add(elements, std::memory_order_relaxed);
+
+        uint64_t end[CounterCount];
+        if (!measuring || !CounterGroup::forThisThread().read(end))
+            return;
+        phase.measuredCalls.fetch_add(1, std::memory_order_relaxed);
+        phase.measuredElements.fetch_add(elements, std::memory_order_relaxed);
+        for (int c = 0; c < CounterCount; ++c)
+            phase.counts[c].fetch_add(end[c] - start[c], std::memory_order_relaxed);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    Phase &phase;
+    uint64_t elements;
+    uint64_t start[CounterCount];
+    bool measuring;
+};
+
+inline bool enabled() { return CounterGroup::forThisThread().available(); }
+
+/**
+ * Clears the totals of every phase (phases stay registered).
+ */
+inline void reset()
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for (auto &p : r.phases)
+    {
+        p->calls = 0;
+        p->elements = 0;
+        p->measuredCalls = 0;
+        p->measuredElements = 0;
+        for (auto &c : p->counts)
+            c = 0;
+    }
+}
+
+/**
+ * Prints one line per phase that ran since the last reset(): call and
+ * element totals, raw counter totals and counters per measured element.
+ */
+inline void report(std::ostream &out)
+{
+    const CounterGroup &group = CounterGroup::forThisThread();
+    if (!group.available())
+    {
+        out << "perf: hardware counters unavailable (check /proc/sys/kernel/perf_event_paranoid)\n";
+        return;
+    }
+
+    Registry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for (auto &p : r.phases)
+    {
+        uint64_t calls = p->calls.load();
+        if (calls == 0)
+            continue;
+        uint64_t measured = p->measuredElements.load();
+        out << "perf: " << std::left << std::setw(16) << p->name << std::right << " calls=" << calls
+            << " elements=" << p->elements.load() << " measured=" << measured;
+        for (int c = 0; c < CounterCount; ++c)
+        {
+            if (!group.has(c))
+                continue;
+            uint64_t total = p->counts[c].load();
+            out << ' ' << counterName(c) << '=' << total;
+            if (measured > 0)
+                out << " (" << std::fixed << std::setprecision(3) << static_cast<double>(total) / measured
+                    << "/elem)" << std::defaultfloat;
+        }
+        out << '\n';
+    }
+}
+
+} // namespace sv::perf
+
+#define SV_PERF_CONCAT_INNER(a, b) a##b
+#define SV_PERF_CONCAT(a, b) SV_PERF_CONCAT_INNER(a, b)
+#define SV_PERF_PHASE(name, elements)                                                                 \
+    static ::sv::perf::Phase &SV_PERF_CONCAT(svPerfPhase, __LINE__) = ::sv::perf::registerPhase(name); \
+    ::sv::perf::Scope SV_PERF_CONCAT(svPerfScope, __LINE__)(SV_PERF_CONCAT(svPerfPhase, __LINE__),     \
+                                                           static_cast<uint64_t>(elements))
+
+#else // instrumentation disabled
+
+namespace sv::perf {
+
+inline bool enabled() { return false; }
+inline void reset() {}
+inline void report(std::ostream &) {}
+
+} // namespace sv::perf
+
+#define SV_PERF_PHASE(name, elements) ((void)0)
+
+#endif
+
+#endif // SORTVISION_PERF_COUNTERS_HPP
@@ -0,0 +1,216 @@
+/**
+ * simdMerge.hpp
+ *
+ * Vectorized merge of two sorted int32 or float arrays, the kernel behind
+ * mergeSort's merge step.
+ *
+ *     sv::simd::merge(a, na, b, nb, out);   // out[0, na + nb) sorted
+ *
+ * The two-pointer loop takes one element per iteration behind a branch
+ * that random data mispredicts half the time. This kernel keeps eight keys
+ * of each input in AVX2 registers and merges them with a bitonic network
+ * (reverse one side, min/max, then three half-cleaner stages). The lower
+ * eight go out and the upper eight stay for the next round. The next block
+ * comes from the input whose head key is smaller, which is the only branch
+ * per eight keys.
+ *
+ * Tails need no scalar cleanup: a partial last block is padded with the
+ * largest key (INT_MAX or +inf), and the padding sorts behind every real
+ * key. The final stores are clipped to na + nb. Padding can only tie with
+ * real keys of the same value, so the output is the same.
+ *
+ * AVX2 is checked at run time, so no -mavx2 flag is needed. Without it (or
+ * with fewer than eight keys on a side), a branchless scalar merge runs
+ * instead. Float inputs must not contain NaN. The network compares floats
+ * by their bit pattern (see Float8), so -0.0 and +0.0 stay distinct keys.
+ * Keys that compare equal are then indistinguishable, so stability does
+ * not matter for these types.
+ */
+#ifndef SORTVISION_SIMD_MERGE_HPP
+#define SORTVISION_SIMD_MERGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SV_SIMD_MERGE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace sv::simd {
+
+/** Branchless two-pointer merge (cmov instead of a data-dependent branch). */
+template <typename T>
+void mergeScalar(const T *a, size_t na, const T *b, size_t nb, T *out)
+{
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb)
+    {
+        T x = a[i], y = b[j];
+        bool takeB = y < x;
+        out[k++] = takeB ? y : x;
+        i += !takeB;
+        j += takeB;
+    }
+    std::copy(a + i, a + na, out + k);
+    std::copy(b + j, b + nb, out + k + (na - i));
+}
+
+#ifdef SV_SIMD_MERGE_AVX2
+
+#define SV_AVX2 __attribute__((target("avx2")))
+
+namespace detail {
+
+/** Eight int32 lanes. */
+struct Int8
+{
+    using T = int;
+    using V = __m256i;
+    static constexpr T kMax = std::numeric_limits<int>::max();
+
+    SV_AVX2 static V load(const T *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    SV_AVX2 static void store(T *p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    SV_AVX2 static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    SV_AVX2 static V max(V a, V b) { return _mm256_max_epi32(a, b); }
+    SV_AVX2 static V reverse(V v) { return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+    SV_AVX2 static V swapHalves(V v) { return _mm256_permute2x128_si256(v, v, 1); }
+    SV_AVX2 static V swapPairs(V v) { return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+    SV_AVX2 static V swapNeighbours(V v) { return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)); }
+    template <int Mask>
+    SV_AVX2 static V blend(V a, V b) { return _mm256_blend_epi32(a, b, Mask); }
+};
+
+/**
+ * Eight float lanes, held as their total-order integer image: flipping the
+ * magnitude bits of negative floats makes signed int32 order match float
+ * order, with -0.0 strictly below +0.0. _mm256_min_ps/max_ps return their
+ * second operand on ties, so min and max of -0.0 and +0.0 would be the
+ * same key and the output would not be a permutation of the input.
+ */
+struct Float8 : Int8
+{
+    using T = float;
+    static constexpr T kMax = std::numeric_limits<float>::infinity();
+
+    // The image is its own inverse
+    SV_AVX2 static V flip(V v) { return _mm256_xor_si256(v, _mm256_srli_epi32(_mm256_srai_epi32(v, 31), 1)); }
+    SV_AVX2 static V load(const T *p) { return flip(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))); }
+    SV_AVX2 static void store(T *p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), flip(v)); }
+};
+
+constexpr size_t kLanes = 8;
+
+/** Sorts a bitonic register: compare-exchange at distance 4, 2, then 1. */
+template <class S>
+SV_AVX2 inline typename S::V bitonicClean(typename S::V v)
+{
+    typename S::V t = S::swapHalves(v);
+    v = S::template blend<0xF0>(S::min(v, t), S::max(v, t));
+    t = S::swapPairs(v);
+    v = S::template blend<0xCC>(S::min(v, t), S::max(v, t));
+    t = S::swapNeighbours(v);
+    return S::template blend<0xAA>(S::min(v, t), S::max(v, t));
+}
+
+/** a, b sorted; afterwards a holds the lower eight of both and b the upper eight, each sorted. */
+template <class S>
+SV_AVX2 inline void bitonicMerge(typename S::V &a, typename S::V &b)
+{
+    typename S::V r = S::reverse(b);
+    typename S::V lo = S::min(a, r), hi = S::max(a, r);
+    a = bitonicClean<S>(lo);
+    b = bitonicClean<S>(hi);
+}
+
+/** Next block of src at i, padded with S::kMax past n. */
+template <class S>
+SV_AVX2 inline typename S::V loadBlock(const typename S::T *src, size_t n, size_t &i)
+{
+    if (i + kLanes <= n)
+    {
+        typename S::V v = S::load(src + i);
+        i += kLanes;
+        return v;
+    }
+    typename S::T pad[kLanes];
+    std::fill(std::copy(src + i, src + n, pad), pad + kLanes, S::kMax);
+    i = n;
+    return S::load(pad);
+}
+
+/** Stores v at out[k], clipped to out[total). */
+template <class S>
+SV_AVX2 inline void storeBlock(typename S::T *out, size_t &k, size_t total, typename S::V v)
+{
+    if (k + kLanes <= total)
+    {
+        S::store(out + k, v);
+        k += kLanes;
+        return;
+    }
+    typename S::T tail[kLanes];
+    S::store(tail, v);
+    std::copy(tail, tail + (total - k), out + k);
+    k = total;
+}
+
+template <class S>
+SV_AVX2 void mergeAvx2(const typename S::T *a, size_t na, const typename S::T *b, size_t nb, typename S::T *out)
+{
+    size_t total = na + nb, ia = 0, ib = 0, k = 0;
+    typename S::V lo = loadBlock<S>(a, na, ia), hi = loadBlock<S>(b, nb, ib);
+    while (true)
+    {
+        bitonicMerge<S>(lo, hi);
+        storeBlock<S>(out, k, total, lo);
+        if (k == total)
+            return;
+        lo = hi;
+        if (ia < na && (ib == nb || a[ia] <= b[ib]))
+            hi = loadBlock<S>(a, na, ia);
+        else if (ib < nb)
+            hi = loadBlock<S>(b, nb, ib);
+        else
+        {
+            storeBlock<S>(out, k, total, lo);
+            return;
+        }
+    }
+}
+
+inline bool hasAvx2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+} // namespace detail
+
+#undef SV_AVX2
+
+#endif // SV_SIMD_MERGE_AVX2
+
+/** Merges sorted a[0, na) and b[0, nb) into out (which must not overlap them). */
+inline void merge(const int *a, size_t na, const int *b, size_t nb, int *out)
+{
+#ifdef SV_SIMD_MERGE_AVX2
+    if (na >= detail::kLanes && nb >= detail::kLanes && detail::hasAvx2())
+        return detail::mergeAvx2<detail::Int8>(a, na, b, nb, out);
+#endif
+    mergeScalar(a, na, b, nb, out);
+}
+
+inline void merge(const float *a, size_t na, const float *b, size_t nb, float *out)
+{
+#ifdef SV_SIMD_MERGE_AVX2
+    if (na >= detail::kLanes && nb >= detail::kLanes && detail::hasAvx2())
+        return detail::mergeAvx2<detail::Float8>(a, na, b, nb, out);
+#endif
+    mergeScalar(a, na, b, nb, out);
+}
+
+} // namespace sv::simd
+
+#endif // SORTVISION_SIMD_MERGE_HPP
@@ -0,0 +1,436 @@
+/**
+ * simdScan.hpp
+ *
+ * Vectorized linear scans used by the sorts and their checks: the largest
+ * magnitude (radix sort's digit count), min and max (bucket sort, the
+ * counting path of sortGroup.hpp), the index of the minimum or maximum
+ * (selection sort) and the sorted prefix (is-sorted checks).
+ *
+ *     int m = sv::simd::maxAbs(keys, n);
+ *     auto [lo, hi] = sv::simd::minMax(keys, n);
+ *     size_t i = sv::simd::minIndex(keys, n);          // first occurrence
+ *     bool ok = sv::simd::isSorted(keys, n);
+ *
+ * One binary serves SSE4.2, AVX2 and AVX-512 hosts. Each kernel is written
+ * once with GCC vector extensions and instantiated per instruction set
+ * inside a target("...") wrapper that inlines it whole (flatten), so the
+ * same loop compiles to 128-, 256- and 512-bit code. The first call reads
+ * cpuid (__builtin_cpu_supports) and picks the widest supported table of
+ * kernels; every later call is one indirect call through it. Other
+ * compilers and architectures get the plain loops.
+ *
+ * SORTVISION_SIMD=scalar|sse4.2|avx2|avx512 (or setIsa()) forces a
+ * narrower set, to compare them on one machine. A level the CPU lacks is
+ * refused.
+ *
+ * Results equal the scalar loops', including which index wins ties (the
+ * first). Float inputs must not contain NaN; maxAbs of INT_MIN is
+ * undefined, as std::abs is.
+ */
+#ifndef SORTVISION_SIMD_SCAN_HPP
+#define SORTVISION_SIMD_SCAN_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SV_SIMD_SCAN_X86 1
+#endif
+
+namespace sv::simd {
+
+enum class Isa
+{
+    Scalar,
+    Sse42,
+    Avx2,
+    Avx512
+};
+
+namespace scalar {
+
+inline int maxAbs(const int *a, size_t n)
+{
+    int m = 0;
+    for (size_t i = 0; i < n; ++i)
+        m = std::max(m, std::abs(a[i]));
+    return m;
+}
+
+template <typename T>
+std::pair<T, T> minMax(const T *a, size_t n)
+{
+    T lo = a[0], hi = a[0];
+    for (size_t i = 1; i < n; ++i)
+    {
+        lo = a[i] < lo ? a[i] : lo;
+        hi = a[i] > hi ? a[i] : hi;
+    }
+    return {lo, hi};
+}
+
+template <bool Max>
+size_t extremeIndex(const int *a, size_t n)
+{
+    size_t best = 0;
+    for (size_t i = 1; i < n; ++i)
+        if (Max ? a[i] > a[best] : a[i] < a[best])
+            best = i;
+    return best;
+}
+
+inline size_t sortedUntil(const int *a, size_t n)
+{
+    for (size_t i = 1; i < n; ++i)
+        if (a[i] < a[i - 1])
+            return i;
+    return n;
+}
+
+} // namespace scalar
+
+namespace detail {
+
+/** The kernels of one instruction set. */
+struct Kernels
+{
+    Isa isa;
+    int (*maxAbs)(const int *, size_t);
+    std::pair<int, int> (*minMax)(const int *, size_t);
+    std::pair<float, float> (*minMaxFloat)(const float *, size_t);
+    size_t (*minIndex)(const int *, size_t);
+    size_t (*maxIndex)(const int *, size_t);
+    size_t (*sortedUntil)(const int *, size_t);
+};
+
+} // namespace detail
+
+#ifdef SV_SIMD_SCAN_X86
+
+// The generic kernels pass vectors by value only between always-inlined
+// functions, so the ABI note about wide vectors without AVX does not apply
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace detail {
+
+template <typename T, size_t Bytes>
+struct Vec
+{
+    typedef T V __attribute__((vector_size(Bytes)));
+    static constexpr size_t kLanes = Bytes / sizeof(T);
+};
+
+#define SV_INLINE __attribute__((always_inline)) inline
+
+template <typename V>
+SV_INLINE V load(const void *p)
+{
+    V v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+template <size_t Bytes>
+SV_INLINE int maxAbs(const int *a, size_t n)
+{
+    using V = typename Vec<int, Bytes>::V;
+    constexpr size_t L = Vec<int, Bytes>::kLanes;
+    V m0 = {}, m1 = {};
+    size_t i = 0;
+    for (; i + 2 * L <= n; i += 2 * L)
+    {
+        V v0 = load<V>(a + i), v1 = load<V>(a + i + L);
+        v0 = v0 < 0 ? -v0 : v0;
+        v1 = v1 < 0 ? -v1 : v1;
+        m0 = m0 > v0 ? m0 : v0;
+        m1 = m1 > v1 ? m1 : v1;
+    }
+    m0 = m0 > m1 ? m0 : m1;
+    int m = scalar::maxAbs(a + i, n - i);
+    for (size_t l = 0; l < L; ++l)
+        m = std::max(m, int(m0[l]));
+    return m;
+}
+
+template <typename T, size_t Bytes>
+SV_INLINE std::pair<T, T> minMax(const T *a, size_t n)
+{
+    using V = typename Vec<T, Bytes>::V;
+    constexpr size_t L = Vec<T, Bytes>::kLanes;
+    if (n < 2 * L)
+        return scalar::minMax(a, n);
+    V lo0 = load<V>(a), hi0 = lo0, lo1 = load<V>(a + L), hi1 = lo1;
+    size_t i = 2 * L;
+    for (; i + 2 * L <= n; i += 2 * L)
+    {
+        V v0 = load<V>(a + i), v1 = load<V>(a + i + L);
+        lo0 = v0 < lo0 ? v0 : lo0;
+        hi0 = v0 > hi0 ? v0 : hi0;
+        lo1 = v1 < lo1 ? v1 : lo1;
+        hi1 = v1 > hi1 ? v1 : hi1;
+    }
+    lo0 = lo1 < lo0 ? lo1 : lo0;
+    hi0 = hi1 > hi0 ? hi1 : hi0;
+    T lo = lo0[0], hi = hi0[0];
+    for (size_t l = 1; l < L; ++l)
+    {
+        lo = lo0[l] < lo ? lo0[l] : lo;
+        hi = hi0[l] > hi ? hi0[l] : hi;
+    }
+    for (; i < n; ++i)
+    {
+        lo = a[i] < lo ? a[i] : lo;
+        hi = a[i] > hi ? a[i] : hi;
+    }
+    return {lo, hi};
+}
+
+/**
+ * Index of the first minimum (or maximum). Each lane keeps its best key
+ * and where it was seen, replacing them only on a strict improvement. Two
+ * sets of lanes take alternate vectors, so the blends do not form one
+ * dependency chain. Lane indices are int32, so the array is scanned in
+ * blocks of 2^30.
+ */
+template <bool Max, size_t Bytes>
+SV_INLINE size_t extremeIndex(const int *a, size_t n)
+{
+    using V = typename Vec<int, Bytes>::V;
+    constexpr size_t L = Vec<int, Bytes>::kLanes;
+    constexpr size_t kBlock = size_t(1) << 30;
+    size_t full = n / (2 * L) * (2 * L), best = 0;
+    int bestKey = a[0];
+    auto better = [](int x, int y) { return Max ? x > y : x < y; };
+    auto consider = [&](int key, size_t i) {
+        if (better(key, bestKey) || (key == bestKey && i < best))
+        {
+            bestKey = key;
+            best = i;
+        }
+    };
+    for (size_t base = 0; base < full; base += kBlock)
+    {
+        size_t end = std::min(full, base + kBlock);
+        V idx0, idx1;
+        for (size_t l = 0; l < L; ++l)
+            idx0[l] = static_cast<int>(l);
+        idx1 = idx0 + static_cast<int>(L);
+        V key0 = load<V>(a + base), key1 = load<V>(a + base + L), at0 = idx0, at1 = idx1;
+        for (size_t i = base + 2 * L; i < end; i += 2 * L)
+        {
+            V v0 = load<V>(a + i), v1 = load<V>(a + i + L);
+            idx0 += static_cast<int>(2 * L);
+            idx1 += static_cast<int>(2 * L);
+            V take0 = Max ? v0 > key0 : v0 < key0;
+            V take1 = Max ? v1 > key1 : v1 < key1;
+            key0 = take0 ? v0 : key0;
+            at0 = take0 ? idx0 : at0;
+            key1 = take1 ? v1 : key1;
+            at1 = take1 ? idx1 : at1;
+        }
+        for (size_t l = 0; l < L; ++l)
+        {
+            consider(key0[l], base + static_cast<size_t>(at0[l]));
+            consider(key1[l], base + static_cast<size_t>(at1[l]));
+        }
+    }
+    for (size_t i = full; i < n; ++i)
+        if (better(a[i], bestKey))
+        {
+            bestKey = a[i];
+            best = i;
+        }
+    return best;
+}
+
+/** Like std::is_sorted_until, as an offset: four vectors are checked per branch. */
+template <size_t Bytes>
+SV_INLINE size_t sortedUntil(const int *a, size_t n)
+{
+    using V = typename Vec<int, Bytes>::V;
+    using W = typename Vec<long long, Bytes>::V;
+    constexpr size_t L = Vec<int, Bytes>::kLanes;
+    size_t i = 0;
+    for (; i + 4 * L + 1 <= n; i += 4 * L)
+    {
+        V bad = {};
+        for (size_t k = 0; k < 4; ++k)
+            bad |= load<V>(a + i + k * L) > load<V>(a + i + k * L + 1);
+        W wide = load<W>(&bad);
+        long long any = 0;
+        for (size_t l = 0; l < L / 2; ++l)
+            any |= wide[l];
+        if (any != 0)
+            break;
+    }
+    size_t rest = scalar::sortedUntil(a + i, n - i);
+    return i + rest;
+}
+
+#undef SV_INLINE
+
+#define SV_SCAN_KERNELS(Name, Target, Bytes)                                                                        \
+    namespace Name {                                                                                                \
+    __attribute__((target(Target), flatten)) inline int maxAbs(const int *a, size_t n)                             \
+    {                                                                                                               \
+        return detail::maxAbs<Bytes>(a, n);                                                                         \
+    }                                                                                                               \
+    __attribute__((target(Target), flatten)) inline std::pair<int, int> minMax(const int *a, size_t n)             \
+    {                                                                                                               \
+        return detail::minMax<int, Bytes>(a, n);                                                                    \
+    }                                                                                                               \
+    __attribute__((target(Target), flatten)) inline std::pair<float, float> minMaxFloat(const float *a, size_t n)  \
+    {                                                                                                               \
+        return detail::minMax<float, Bytes>(a, n);                                                                  \
+    }                                                                                                               \
+    __attribute__((target(Target), flatten)) inline size_t minIndex(const int *a, size_t n)                        \
+    {                                                                                                               \
+        return detail::extremeIndex<false, Bytes>(a, n);                                                            \
+    }                                                                                                               \
+    __attribute__((target(Target), flatten)) inline size_t maxIndex(const int *a, size_t n)                        \
+    {                                                                                                               \
+        return detail::extremeIndex<true, Bytes>(a, n);                                                             \
+    }                                                                                                               \
+    __attribute__((target(Target), flatten)) inline size_t sortedUntil(const int *a, size_t n)                     \
+    {                                                                                                               \
+        return detail::sortedUntil<Bytes>(a, n);                                                                    \
+    }                                                                                                               \
+    }
+
+SV_SCAN_KERNELS(sse42, "sse4.2", 16)
+SV_SCAN_KERNELS(avx2, "avx2", 32)
+SV_SCAN_KERNELS(avx512, "avx512f", 64)
+
+#undef SV_SCAN_KERNELS
+
+} // namespace detail
+
+#pragma GCC diagnostic pop
+
+#endif // SV_SIMD_SCAN_X86
+
+namespace detail {
+
+inline const Kernels &kernelsFor(Isa isa)
+{
+    static const Kernels table[] = {
+        {Isa::Scalar, scalar::maxAbs, scalar::minMax<int>, scalar::minMax<float>, scalar::extremeIndex<false>,
+         scalar::extremeIndex<true>, scalar::sortedUntil},
+#ifdef SV_SIMD_SCAN_X86
+        {Isa::Sse42, sse42::maxAbs, sse42::minMax, sse42::minMaxFloat, sse42::minIndex, sse42::maxIndex,
+         sse42::sortedUntil},
+        {Isa::Avx2, avx2::maxAbs, avx2::minMax, avx2::minMaxFloat, avx2::minIndex, avx2::maxIndex,
+         avx2::sortedUntil},
+        {Isa::Avx512, avx512::maxAbs, avx512::minMax, avx512::minMaxFloat, avx512::minIndex, avx512::maxIndex,
+         avx512::sortedUntil},
+#endif
+    };
+    return table[static_cast<int>(isa)];
+}
+
+} // namespace detail
+
+/** The widest instruction set this CPU runs (cpuid, read once). */
+inline Isa detectedIsa()
+{
+    static const Isa isa = [] {
+#ifdef SV_SIMD_SCAN_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return Isa::Avx512;
+        if (__builtin_cpu_supports("avx2"))
+            return Isa::Avx2;
+        if (__builtin_cpu_supports("sse4.2"))
+            return Isa::Sse42;
+#endif
+        return Isa::Scalar;
+    }();
+    return isa;
+}
+
+inline const char *isaName(Isa isa)
+{
+    static const char *const names[] = {"scalar", "sse4.2", "avx2", "avx512"};
+    return names[static_cast<int>(isa)];
+}
+
+/** Parses "scalar", "sse4.2", "avx2" or "avx512". @return false for anything else */
+inline bool parseIsa(const char *name, Isa &isa)
+{
+    for (Isa candidate : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512})
+        if (std::strcmp(name, isaName(candidate)) == 0)
+        {
+            isa = candidate;
+            return true;
+        }
+    return false;
+}
+
+namespace detail {
+inline std::atomic<const Kernels *> &active()
+{
+    static std::atomic<const Kernels *> kernels([] {
+        Isa isa = detectedIsa(), wanted;
+        const char *v = std::getenv("SORTVISION_SIMD");
+        if (v != nullptr && parseIsa(v, wanted) && wanted < isa)
+            isa = wanted;
+        return &kernelsFor(isa);
+    }());
+    return kernels;
+}
+} // namespace detail
+
+/** Instruction set the kernels currently run on. */
+inline Isa activeIsa() { return detail::active().load(std::memory_order_relaxed)->isa; }
+
+/** Switches every scan to `isa`. @return false (and no change) when the CPU lacks it */
+inline bool setIsa(Isa isa)
+{
+    if (isa > detectedIsa())
+        return false;
+    detail::active().store(&detail::kernelsFor(isa), std::memory_order_relaxed);
+    return true;
+}
+
+/** Largest |a[i]|, 0 for an empty array. */
+inline int maxAbs(const int *a, size_t n) { return detail::active().load(std::memory_order_relaxed)->maxAbs(a, n); }
+
+/** Smallest and largest key of a[0, n), n >= 1. */
+inline std::pair<int, int> minMax(const int *a, size_t n)
+{
+    return detail::active().load(std::memory_order_relaxed)->minMax(a, n);
+}
+
+inline std::pair<float, float> minMax(const float *a, size_t n)
+{
+    return detail::active().load(std::memory_order_relaxed)->minMaxFloat(a, n);
+}
+
+/** Index of the first smallest key of a[0, n), n >= 1. */
+inline size_t minIndex(const int *a, size_t n)
+{
+    return detail::active().load(std::memory_order_relaxed)->minIndex(a, n);
+}
+
+/** Index of the first largest key of a[0, n), n >= 1. */
+inline size_t maxIndex(const int *a, size_t n)
+{
+    return detail::active().load(std::memory_order_relaxed)->maxIndex(a, n);
+}
+
+/** Length of the ascending prefix of a[0, n) (n when sorted), like std::is_sorted_until. */
+inline size_t sortedUntil(const int *a, size_t n)
+{
+    return detail::active().load(std::memory_order_relaxed)->sortedUntil(a, n);
+}
+
+inline bool isSorted(const int *a, size_t n) { return sortedUntil(a, n) == n; }
+
+} // namespace sv::simd
+
+#endif // SORTVISION_SIMD_SCAN_HPP
@@ -0,0 +1,118 @@
+/**
+ * sortControl.hpp
+ *
+ * Progress reporting and cooperative cancellation for the C++ sorts, the
+ * native counterpart of the visualizer's shouldStopRef.
+ *
+ *     sv::SortControl control;
+ *     std::thread worker([&] {
+ *         sv::ops::Controlled::Bind bind(control);
+ *         quickSort<sv::ops::Controlled>(vec);
+ *     });
+ *     control.progress();   // 0..1, from any thread
+ *     control.cancel();     // the sort returns at its next check
+ *
+ * The sorts call Ops::advance(units, total) at coarse points: per
+ * partition (quick), per merge (merge), per digit pass (radix), per outer
+ * pass (bubble, selection) or every 1024 elements (insertion, heap,
+ * bucket). Units follow each algorithm's structure: elements placed for
+ * quick sort, elements merged over all levels for merge sort, elements
+ * moved per pass for radix sort, and so on. progress() is their ratio.
+ *
+ * With the other policies advance() is a constexpr `true`, so the checks
+ * compile away. A cancelled sort stops between steps: the array always
+ * holds every key, partly sorted.
+ */
+#ifndef SORTVISION_SORT_CONTROL_HPP
+#define SORTVISION_SORT_CONTROL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "opCounters.hpp"
+
+namespace sv {
+
+namespace ops {
+struct Controlled;
+}
+
+/** Shared between the sorting thread and observers. */
+class SortControl
+{
+public:
+    /** Asks the sort to stop at its next check. Safe from any thread or a signal handler. */
+    void cancel() { stop.store(true, std::memory_order_relaxed); }
+    bool cancelRequested() const { return stop.load(std::memory_order_relaxed); }
+
+    /** Estimated fraction done, 0..1 (0 until the sort reports a total). */
+    double progress() const
+    {
+        uint64_t t = total.load(std::memory_order_relaxed);
+        return t == 0 ? 0.0 : std::min(1.0, static_cast<double>(done.load(std::memory_order_relaxed)) / t);
+    }
+
+    /** Clears progress and cancellation so the control can be reused. */
+    void reset()
+    {
+        stop.store(false, std::memory_order_relaxed);
+        done.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    friend struct sv::ops::Controlled;
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> done{0};
+    std::atomic<uint64_t> total{0};
+};
+
+namespace ops {
+
+/**
+ * Policy that reports to the SortControl bound to the calling thread
+ * (no-op when none is bound). Counting hooks are inherited as no-ops.
+ */
+struct Controlled : NoCounting
+{
+    static bool advance(size_t units, size_t total)
+    {
+        SortControl *c = current();
+        if (c == nullptr)
+            return true;
+        if (total != 0)
+            c->total.store(total, std::memory_order_relaxed);
+        // Only the sorting thread writes `done`
+        c->done.store(c->done.load(std::memory_order_relaxed) + units, std::memory_order_relaxed);
+        return !c->stop.load(std::memory_order_relaxed);
+    }
+
+    /** Binds a control to the calling thread for the lifetime of the guard. */
+    class Bind
+    {
+    public:
+        explicit Bind(SortControl &control) : previous(current()) { current() = &control; }
+        ~Bind() { current() = previous; }
+        Bind(const Bind &) = delete;
+        Bind &operator=(const Bind &) = delete;
+
+    private:
+        SortControl *previous;
+    };
+
+private:
+    static SortControl *&current()
+    {
+        thread_local SortControl *control = nullptr;
+        return control;
+    }
+};
+
+} // namespace ops
+
+} // namespace sv
+
+#endif // SORTVISION_SORT_CONTROL_HPP
@@ -0,0 +1,143 @@
+/**
+ * sortGroup.hpp
+ *
+ * Shared pieces of the fused sort-unique and sort-count modes
+ * (radixSortUnique / radixSortCounts, mergeSortUnique / mergeSortCounts).
+ *
+ *     std::vector<size_t> counts = mergeSortCounts(vec);   // vec = distinct keys
+ *     // vec[i] occurs counts[i] times in the input
+ *
+ * A sort followed by std::unique or a count-per-key loop reads the whole
+ * array once more. The fused modes hand the keys to an Emitter instead,
+ * while the last radix pass or the last merge produces them in order. The
+ * Emitter folds runs of equal keys as they arrive, so only distinct keys
+ * and their counts are ever written back.
+ *
+ * Inputs whose key range is small compared to n skip sorting altogether:
+ * countingGroup() builds a histogram over [min, max] and emits its
+ * non-empty slots, which is one read of the input.
+ */
+#ifndef SORTVISION_SORT_GROUP_HPP
+#define SORTVISION_SORT_GROUP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "simdScan.hpp"
+#include "sortWorkspace.hpp"
+
+namespace sv::group {
+
+/** Largest key range (max - min + 1) the counting path takes: 8 MiB of counters. */
+constexpr size_t kCountingMaxRange = size_t(1) << 20;
+
+/**
+ * Receives sorted keys and writes each distinct key once to keys[], and
+ * its multiplicity to *counts when counts is given. keys may be the
+ * array being sorted: the write position never passes the number of keys
+ * emitted so far, so the input can be read from scratch buffers or from
+ * the same array (add(keys.data(), n) dedups in place).
+ */
+class Emitter
+{
+public:
+    explicit Emitter(int *keys, std::vector<size_t> *counts = nullptr) : out(keys), counts(counts) {}
+
+    /** One key, not smaller than the previous one. */
+    void add(int key) { add(key, 1); }
+
+    /** `count` copies of one key. */
+    void add(int key, size_t count)
+    {
+        if (distinct != 0 && out[distinct - 1] == key)
+        {
+            if (counts)
+                counts->back() += count;
+            return;
+        }
+        out[distinct++] = key;
+        if (counts)
+            counts->push_back(count);
+    }
+
+    /** A sorted chunk that continues the keys emitted so far. */
+    void add(const int *keys, size_t n)
+    {
+        if (n == 0)
+            return;
+        size_t i = 0;
+        if (distinct == 0)
+            add(keys[i++]);
+        if (counts)
+        {
+            for (; i < n; ++i)
+            {
+                if (keys[i] == out[distinct - 1])
+                    ++counts->back();
+                else
+                {
+                    out[distinct++] = keys[i];
+                    counts->push_back(1);
+                }
+            }
+            return;
+        }
+        // Branchless: always store, advance only past a new key
+        int last = out[distinct - 1];
+        for (; i < n; ++i)
+        {
+            int v = keys[i];
+            out[distinct] = v;
+            distinct += v != last;
+            last = v;
+        }
+    }
+
+    /** Distinct keys emitted so far. */
+    size_t size() const { return distinct; }
+
+private:
+    int *out;
+    std::vector<size_t> *counts;
+    size_t distinct = 0;
+};
+
+/** Smallest and largest of keys[0, n), n >= 1 (a SIMD scan, see simdScan.hpp). */
+inline std::pair<int, int> minMax(const int *keys, size_t n) { return simd::minMax(keys, n); }
+
+/** Whether countingGroup() takes n keys spanning [lo, hi]: the histogram must not outgrow the input. */
+inline bool useCounting(size_t n, int lo, int hi)
+{
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo) + 1;
+    return range <= kCountingMaxRange && range <= n;
+}
+
+/**
+ * Counting-sort fast path: histograms keys[0, n) over [lo, hi] and emits
+ * the distinct keys in order. keys may alias the emitter's output, since
+ * nothing is emitted before the histogram is complete.
+ * @return false (doing nothing) when the range is too wide, see useCounting()
+ */
+inline bool countingGroup(const int *keys, size_t n, int lo, int hi, Emitter &out,
+                          SortWorkspace &ws = SortWorkspace::thisThread())
+{
+    if (n == 0 || !useCounting(n, lo, hi))
+        return false;
+    size_t range = static_cast<size_t>(static_cast<int64_t>(hi) - lo) + 1;
+    SortWorkspace::Scope scope(ws);
+    size_t *hist = ws.take<size_t>(range);
+    std::fill(hist, hist + range, 0);
+    for (size_t i = 0; i < n; ++i)
+        ++hist[static_cast<size_t>(static_cast<int64_t>(keys[i]) - lo)];
+    for (size_t r = 0; r < range; ++r)
+        if (hist[r] != 0)
+            out.add(static_cast<int>(lo + static_cast<int64_t>(r)), hist[r]);
+    return true;
+}
+
+} // namespace sv::group
+
+#endif // SORTVISION_SORT_GROUP_HPP
@@ -0,0 +1,172 @@
+/**
+ * sortWorkspace.hpp
+ *
+ * Reusable scratch memory for the out-of-place sorts.
+ *
+ * A SortWorkspace is a bump arena: take<T>(n) hands out the next n
+ * elements of a block, and a Scope gives everything taken inside it back
+ * when it ends. The blocks are kept between calls, so once a workspace
+ * has grown to the largest request it sees, sorting allocates nothing.
+ *
+ *     sv::SortWorkspace ws;                 // one per thread
+ *     mergeSort(vec, 0, n - 1, ws);         // merge L/R come from ws
+ *     radixSort(vec, 10, ws);               // countSort output/count too
+ *
+ * The sorts default to SortWorkspace::thisThread(), a thread_local
+ * instance, so existing call sites reuse memory without changes.
+ *
+ * When a request does not fit, a new block of at least twice the current
+ * capacity is added; earlier pointers stay valid. When the outermost Scope
+ * ends with several blocks, they are replaced by one block of the combined
+ * size, so the next call of the same size is served from a single block.
+ *
+ * Blocks of 2 MiB and more can be backed by huge pages (hugePages.hpp):
+ * pass a mode to the constructor or setHugePages(). The default is
+ * huge::defaultMode(), which follows SORTVISION_HUGEPAGES ("thp" or
+ * "hugetlb"; off when unset).
+ *
+ * Memory handed out is uninitialized and only suitable for trivially
+ * copyable types. A workspace must not be shared between threads.
+ */
+#ifndef SORTVISION_SORT_WORKSPACE_HPP
+#define SORTVISION_SORT_WORKSPACE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "hugePages.hpp"
+
+namespace sv {
+
+class SortWorkspace
+{
+public:
+    explicit SortWorkspace(size_t initialBytes = 0, huge::Mode hugePages = huge::defaultMode())
+        : hugeMode(hugePages)
+    {
+        if (initialBytes > 0)
+            addBlock(initialBytes);
+    }
+
+    SortWorkspace(const SortWorkspace &) = delete;
+    SortWorkspace &operator=(const SortWorkspace &) = delete;
+
+    /** Uninitialized room for n elements of T, valid until the enclosing Scope ends. */
+    template <typename T>
+    T *take(size_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "workspace memory is not constructed");
+        return static_cast<T *>(takeBytes(n * sizeof(T), alignof(T)));
+    }
+
+    /** Gives back everything taken after it was opened when it goes out of scope. */
+    class Scope
+    {
+    public:
+        explicit Scope(SortWorkspace &ws) : ws(ws), block(ws.current), offset(ws.offset) { ++ws.depth; }
+        ~Scope() { ws.release(block, offset); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        SortWorkspace &ws;
+        size_t block, offset;
+    };
+
+    /** Bytes reserved across all blocks. */
+    size_t capacity() const
+    {
+        size_t total = 0;
+        for (const Block &b : blocks)
+            total += b.size;
+        return total;
+    }
+
+    /** Largest number of bytes in use at once. */
+    size_t highWater() const { return peak; }
+
+    /** Backing for blocks allocated from now on. */
+    void setHugePages(huge::Mode mode) { hugeMode = mode; }
+    huge::Mode hugePages() const { return hugeMode; }
+
+    /** Heap allocations made so far; constant once the workspace is warm. */
+    size_t allocations() const { return allocationCount; }
+
+    /** The calling thread's workspace, used when a sort is not given one. */
+    static SortWorkspace &thisThread()
+    {
+        thread_local SortWorkspace instance;
+        return instance;
+    }
+
+private:
+    struct Block
+    {
+        huge::Buffer memory;
+        size_t size;
+
+        std::byte *data() const { return static_cast<std::byte *>(memory.get()); }
+    };
+
+    static constexpr size_t kMinBlock = size_t(1) << 16;
+
+    std::vector<Block> blocks;
+    size_t current = 0; // block serving requests
+    size_t offset = 0;  // bytes used in blocks[current]
+    size_t used = 0;    // bytes in use across all blocks
+    size_t peak = 0;
+    size_t depth = 0;   // open scopes
+    size_t allocationCount = 0;
+    huge::Mode hugeMode;
+
+    void addBlock(size_t bytes)
+    {
+        blocks.push_back({huge::allocate(bytes, hugeMode), bytes});
+        ++allocationCount;
+    }
+
+    void *takeBytes(size_t bytes, size_t align)
+    {
+        for (;; ++current, offset = 0)
+        {
+            if (current == blocks.size())
+                addBlock(std::max({kMinBlock, 2 * capacity(), bytes + align}));
+            Block &b = blocks[current];
+            uintptr_t base = reinterpret_cast<uintptr_t>(b.data());
+            size_t start = ((base + offset + align - 1) & ~(uintptr_t(align) - 1)) - base;
+            if (start + bytes <= b.size)
+            {
+                used += start + bytes - offset;
+                peak = std::max(peak, used);
+                offset = start + bytes;
+                return b.data() + start;
+            }
+            used += b.size - offset; // the rest of this block is skipped
+        }
+    }
+
+    void release(size_t block, size_t markOffset)
+    {
+        current = block;
+        offset = markOffset;
+        used = markOffset;
+        for (size_t i = 0; i < block; ++i)
+            used += blocks[i].size;
+        if (--depth == 0 && blocks.size() > 1)
+        {
+            // Fold the blocks into one so the next call fits without spilling
+            size_t total = capacity();
+            blocks.clear();
+            addBlock(total);
+            current = offset = used = 0;
+        }
+    }
+};
+
+} // namespace sv
+
+#endif // SORTVISION_SORT_WORKSPACE_HPP
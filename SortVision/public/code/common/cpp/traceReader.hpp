@@ -0,0 +1,273 @@
+/**
+ * traceReader.hpp
+ *
+ * Reads operation traces written by TraceRecorder (traceRecorder.hpp) and
+ * replays them at any granularity.
+ *
+ *     sv::trace::TraceReader reader;
+ *     if (!reader.open("quick.svtr")) ...
+ *     reader.decimate(reader.eventCount() / 600, [](uint64_t event, const std::vector<int64_t> &state) {
+ *         // draw one frame
+ *     });
+ *     std::vector<int64_t> middle = reader.stateAt(reader.eventCount() / 2);
+ *
+ * open() scans the trace once, recording a decoder keyframe every 4096
+ * events, and keeps at most kMaxSnapshots full array snapshots, fewer when
+ * they would take more than kSnapshotBytes (a 10^6-key trace keeps 8).
+ * seek() and stateAt() therefore decode at most one keyframe interval or
+ * one snapshot interval instead of the whole trace.
+ */
+#ifndef SORTVISION_TRACE_READER_HPP
+#define SORTVISION_TRACE_READER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "traceRecorder.hpp"
+
+namespace sv::trace {
+
+struct TraceEvent
+{
+    TraceOp op;
+    uint64_t i;
+    uint64_t j;    // second position of a compare or swap
+    int64_t value; // value stored by a write
+};
+
+/**
+ * Applies one event to an array state (compares leave it unchanged).
+ */
+inline void applyEvent(std::vector<int64_t> &state, const TraceEvent &e)
+{
+    if (e.op == TraceOp::Swap)
+        std::swap(state[e.i], state[e.j]);
+    else if (e.op == TraceOp::Write)
+        state[e.i] = e.value;
+}
+
+class TraceReader
+{
+public:
+    static constexpr uint64_t kKeyframeInterval = 4096;
+    static constexpr size_t kMaxSnapshots = 64;
+    static constexpr size_t kSnapshotBytes = size_t(64) << 20;
+
+    /**
+     * Loads and indexes a trace file.
+     * @return false if the file is missing, truncated or not a trace
+     */
+    bool open(const char *path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return false;
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        if (bytes.size() < 6 || std::memcmp(bytes.data(), kMagic, 4) != 0 || bytes[4] != kVersion)
+            return false;
+        kind = static_cast<ValueKind>(bytes[5]);
+
+        cursor = 6;
+        uint64_t n;
+        if (!getVarint(n) || n > bytes.size())
+            return false;
+        initialState.resize(n);
+        int64_t previous = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            uint64_t zz;
+            if (!getVarint(zz))
+                return false;
+            previous += unzigzag(zz);
+            initialState[k] = previous;
+        }
+        eventsStart = cursor;
+
+        // Pass 1: count events, remember decoder keyframes
+        keyframes.clear();
+        resetDecoder();
+        TraceEvent e;
+        while (true)
+        {
+            if (eventIndex % kKeyframeInterval == 0)
+                keyframes.push_back({cursor, lastIndex, lastValue});
+            if (!decode(e))
+                break;
+        }
+        if (cursor != bytes.size())
+            return false; // trailing garbage or a truncated event
+        events = eventIndex;
+
+        // Pass 2: full snapshots at evenly spaced keyframes
+        size_t snapshotBytes = std::max<size_t>(1, n) * sizeof(int64_t);
+        size_t maxSnapshots = std::clamp<size_t>(kSnapshotBytes / snapshotBytes, 1, kMaxSnapshots);
+        uint64_t perSnapshot = (events / kKeyframeInterval) / maxSnapshots + 1;
+        snapshotInterval = perSnapshot * kKeyframeInterval;
+        snapshots.clear();
+        std::vector<int64_t> state = initialState;
+        resetDecoder();
+        while (true)
+        {
+            if (eventIndex % snapshotInterval == 0)
+                snapshots.push_back(state);
+            if (!decode(e))
+                break;
+            if (e.i >= state.size() || (e.op == TraceOp::Swap && e.j >= state.size()))
+                return false;
+            applyEvent(state, e);
+        }
+        finalState = std::move(state);
+        resetDecoder();
+        return true;
+    }
+
+    uint64_t eventCount() const { return events; }
+    ValueKind valueKind() const { return kind; }
+    const std::vector<int64_t> &initial() const { return initialState; }
+    const std::vector<int64_t> &finalArray() const { return finalState; }
+
+    /**
+     * Decodes the next event in sequence.
+     * @return false at the end of the trace
+     */
+    bool next(TraceEvent &e) { return decode(e); }
+
+    /** Index of the event next() will return. */
+    uint64_t position() const { return eventIndex; }
+
+    /**
+     * Positions the reader so next() returns event `target`
+     * (decodes fewer than kKeyframeInterval events).
+     */
+    void seek(uint64_t target)
+    {
+        target = std::min(target, events);
+        const Keyframe &k = keyframes[target / kKeyframeInterval];
+        cursor = k.offset;
+        lastIndex = k.lastIndex;
+        lastValue = k.lastValue;
+        eventIndex = (target / kKeyframeInterval) * kKeyframeInterval;
+        TraceEvent skipped;
+        while (eventIndex < target)
+            decode(skipped);
+    }
+
+    /**
+     * Array contents after the first `target` events have been applied.
+     */
+    std::vector<int64_t> stateAt(uint64_t target)
+    {
+        target = std::min(target, events);
+        uint64_t s = target / snapshotInterval;
+        std::vector<int64_t> state = snapshots[s];
+        seek(s * snapshotInterval);
+        TraceEvent e;
+        while (eventIndex < target && decode(e))
+            applyEvent(state, e);
+        return state;
+    }
+
+    /**
+     * Replays the whole trace and calls frame(eventIndex, state) after
+     * every `step` events, plus once for the initial and final state.
+     * A step of 1 visits every event; larger steps play back faster.
+     */
+    template <typename Frame>
+    void decimate(uint64_t step, Frame &&frame)
+    {
+        step = std::max<uint64_t>(1, step);
+        std::vector<int64_t> state = initialState;
+        seek(0);
+        frame(uint64_t(0), static_cast<const std::vector<int64_t> &>(state));
+        TraceEvent e;
+        while (decode(e))
+        {
+            applyEvent(state, e);
+            if (eventIndex % step == 0 || eventIndex == events)
+                frame(eventIndex, static_cast<const std::vector<int64_t> &>(state));
+        }
+    }
+
+private:
+    struct Keyframe
+    {
+        size_t offset;
+        uint64_t lastIndex;
+        int64_t lastValue;
+    };
+
+    void resetDecoder()
+    {
+        cursor = eventsStart;
+        eventIndex = 0;
+        lastIndex = 0;
+        lastValue = 0;
+    }
+
+    bool getVarint(uint64_t &v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64 && cursor < bytes.size(); shift += 7)
+        {
+            uint8_t b = bytes[cursor++];
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool decode(TraceEvent &e)
+    {
+        size_t start = cursor;
+        uint64_t tag, second;
+        if (cursor >= bytes.size() || !getVarint(tag) || !getVarint(second) || (tag & 3) == 3)
+        {
+            cursor = start;
+            return false;
+        }
+        e.op = static_cast<TraceOp>(tag & 3);
+        e.i = static_cast<uint64_t>(static_cast<int64_t>(lastIndex) + unzigzag(tag >> 2));
+        lastIndex = e.i;
+        if (e.op == TraceOp::Write)
+        {
+            lastValue += unzigzag(second);
+            e.value = lastValue;
+            e.j = e.i;
+        }
+        else
+        {
+            e.j = static_cast<uint64_t>(static_cast<int64_t>(e.i) + unzigzag(second));
+            e.value = 0;
+        }
+        ++eventIndex;
+        return true;
+    }
+
+    std::vector<uint8_t> bytes;
+    ValueKind kind = ValueKind::Integer;
+    std::vector<int64_t> initialState;
+    std::vector<int64_t> finalState;
+    size_t eventsStart = 0;
+    uint64_t events = 0;
+
+    std::vector<Keyframe> keyframes;
+    std::vector<std::vector<int64_t>> snapshots;
+    uint64_t snapshotInterval = kKeyframeInterval;
+
+    // Decoder state
+    size_t cursor = 0;
+    uint64_t eventIndex = 0;
+    uint64_t lastIndex = 0;
+    int64_t lastValue = 0;
+};
+
+} // namespace sv::trace
+
+#endif // SORTVISION_TRACE_READER_HPP
@@ -0,0 +1,417 @@
+/**
+ * traceRecorder.hpp
+ *
+ * Compact binary operation traces for visualizer playback.
+ *
+ * A sort instantiated with the Tracing policy (same hooks as the policies
+ * in opCounters.hpp) reports every compare, swap and array write to the
+ * TraceRecorder bound to the calling thread:
+ *
+ *     sv::trace::TraceRecorder recorder;
+ *     recorder.start("quick.svtr", vec.data(), vec.size());
+ *     {
+ *         sv::trace::Tracing::Bind bind(recorder);
+ *         quickSort<sv::trace::Tracing>(vec);
+ *     }
+ *     recorder.finish();
+ *
+ * File format (all integers are LEB128 varints, zz() is zigzag encoding):
+ *
+ *     "SVTR" | version (1 byte) | value kind (1 byte: 0 = integer, 1 = float32 bits)
+ *     n | zz(a[0]) | zz(a[1] - a[0]) | ... | zz(a[n-1] - a[n-2])      initial array
+ *     events...
+ *
+ * Each event starts with tag = zz(i - previous i) << 2 | op, followed by
+ *     compare, swap: zz(j - i)
+ *     write:         zz(value - previous written value)
+ * Consecutive events tend to touch nearby positions, so most events take
+ * 2-3 bytes.
+ *
+ * The sorting thread encodes events into a private 4 KiB block and hands
+ * full blocks to a preallocated single-producer/single-consumer ring
+ * buffer (one release store per block, no locks). A drain thread empties
+ * the ring into the file. If the disk falls behind, the producer waits
+ * for space instead of dropping events. Either side waits by yielding a
+ * few times and then sleeping for up to 1 ms, so an idle drain thread
+ * does not keep a core busy.
+ *
+ * Traces are read back with TraceReader (traceReader.hpp).
+ */
+#ifndef SORTVISION_TRACE_RECORDER_HPP
+#define SORTVISION_TRACE_RECORDER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "opCounters.hpp"
+
+namespace sv::trace {
+
+enum class TraceOp : uint8_t
+{
+    Compare = 0,
+    Swap = 1,
+    Write = 2
+};
+
+enum class ValueKind : uint8_t
+{
+    Integer = 0,
+    Float32 = 1 // values are the IEEE-754 bit patterns of floats
+};
+
+constexpr char kMagic[4] = {'S', 'V', 'T', 'R'};
+constexpr uint8_t kVersion = 1;
+
+inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+inline int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+/**
+ * Appends v as an LEB128 varint to out.
+ * @return number of bytes written (at most 10)
+ */
+inline size_t putVarint(uint8_t *out, uint64_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80)
+    {
+        out[n++] = static_cast<uint8_t>(v) | 0x80;
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+/**
+ * Converts an element to the 64-bit value stored in the trace.
+ */
+template <typename T>
+int64_t traceValue(const T &value)
+{
+    static_assert(std::is_arithmetic_v<T>, "traces store integer or float elements");
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        float f = static_cast<float>(value);
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return static_cast<int64_t>(bits);
+    }
+    else
+    {
+        return static_cast<int64_t>(value);
+    }
+}
+
+/**
+ * Lock-free single-producer/single-consumer byte ring.
+ * Capacity is rounded up to a power of two.
+ */
+class TraceRing
+{
+public:
+    explicit TraceRing(size_t capacity)
+    {
+        size_t cap = 1;
+        while (cap < capacity)
+            cap <<= 1;
+        buffer.resize(cap);
+        mask = cap - 1;
+    }
+
+    /** Producer: appends all n bytes, or nothing if there is not enough room. */
+    bool tryPush(const uint8_t *data, size_t n)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        uint64_t t = tail.load(std::memory_order_acquire);
+        if (buffer.size() - (h - t) < n)
+            return false;
+        size_t at = h & mask;
+        size_t first = std::min(n, buffer.size() - at);
+        std::memcpy(&buffer[at], data, first);
+        std::memcpy(&buffer[0], data + first, n - first);
+        head.store(h + n, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: moves up to max bytes into out, returns the count. */
+    size_t pop(uint8_t *out, size_t max)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        size_t n = static_cast<size_t>(std::min<uint64_t>(h - t, max));
+        size_t at = t & mask;
+        size_t first = std::min(n, buffer.size() - at);
+        std::memcpy(out, &buffer[at], first);
+        std::memcpy(out + first, &buffer[0], n - first);
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t capacity() const { return buffer.size(); }
+
+private:
+    std::vector<uint8_t> buffer;
+    size_t mask = 0;
+    alignas(64) std::atomic<uint64_t> head{0}; // advanced by the producer
+    alignas(64) std::atomic<uint64_t> tail{0}; // advanced by the consumer
+};
+
+/**
+ * Wait strategy for an empty or full ring: yields for the first rounds,
+ * then sleeps with a doubling interval capped at kMaxSleep.
+ */
+class Backoff
+{
+public:
+    static constexpr unsigned kYieldRounds = 64;
+    static constexpr std::chrono::microseconds kMaxSleep{1000};
+
+    void wait()
+    {
+        if (rounds < kYieldRounds)
+        {
+            ++rounds;
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(sleep);
+        sleep = std::min(sleep * 2, kMaxSleep);
+    }
+
+    void reset()
+    {
+        rounds = 0;
+        sleep = std::chrono::microseconds(16);
+    }
+
+private:
+    unsigned rounds = 0;
+    std::chrono::microseconds sleep{16};
+};
+
+/**
+ * Records one trace: encodes events on the sorting thread and streams
+ * them to a file through a TraceRing drained by a background thread.
+ * A recorder serves one sorting thread at a time.
+ */
+class TraceRecorder
+{
+public:
+    static constexpr size_t kBlockBytes = 4096;
+
+    /**
+     * @throws std::invalid_argument if ringBytes is below kBlockBytes (a
+     *         full block could then never be pushed)
+     */
+    explicit TraceRecorder(size_t ringBytes = size_t(1) << 22) : ring(ringBytes)
+    {
+        if (ringBytes < kBlockBytes)
+            throw std::invalid_argument("trace ring smaller than one block");
+    }
+
+    ~TraceRecorder() { finish(); }
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    /**
+     * Opens path, writes the header and the initial array, and starts the
+     * drain thread.
+     * @return false if the file cannot be written
+     */
+    template <typename T>
+    bool start(const char *path, const T *data, size_t n)
+    {
+        finish();
+        file = std::fopen(path, "wb");
+        if (file == nullptr)
+            return false;
+
+        ioError = false;
+        events = 0;
+        lastIndex = 0;
+        lastValue = 0;
+        used = 0;
+
+        uint8_t header[6] = {kMagic[0], kMagic[1], kMagic[2], kMagic[3], kVersion,
+                             static_cast<uint8_t>(std::is_floating_point_v<T> ? ValueKind::Float32
+                                                                              : ValueKind::Integer)};
+        std::fwrite(header, 1, sizeof(header), file);
+        uint8_t tmp[10];
+        std::fwrite(tmp, 1, putVarint(tmp, n), file);
+        int64_t previous = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            int64_t v = traceValue(data[i]);
+            std::fwrite(tmp, 1, putVarint(tmp, zigzag(v - previous)), file);
+            previous = v;
+        }
+
+        closing.store(false, std::memory_order_relaxed);
+        drainer = std::thread([this] { drain(); });
+        return !std::ferror(file);
+    }
+
+    /**
+     * Flushes pending events, stops the drain thread and closes the file.
+     * @return false if any write failed
+     */
+    bool finish()
+    {
+        if (file == nullptr)
+            return true;
+        flushBlock();
+        closing.store(true, std::memory_order_release);
+        drainer.join();
+        bool ok = !ioError && !std::ferror(file);
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+    uint64_t eventCount() const { return events; }
+
+    void compare(size_t i, size_t j) { pair(TraceOp::Compare, i, j); }
+    void swap(size_t i, size_t j) { pair(TraceOp::Swap, i, j); }
+
+    void write(size_t i, int64_t value)
+    {
+        reserve();
+        used += putVarint(block + used, tag(TraceOp::Write, i));
+        used += putVarint(block + used, zigzag(value - lastValue));
+        lastValue = value;
+        ++events;
+    }
+
+private:
+    uint64_t tag(TraceOp op, size_t i)
+    {
+        uint64_t t = zigzag(static_cast<int64_t>(i) - static_cast<int64_t>(lastIndex)) << 2 |
+                     static_cast<uint64_t>(op);
+        lastIndex = i;
+        return t;
+    }
+
+    void pair(TraceOp op, size_t i, size_t j)
+    {
+        reserve();
+        used += putVarint(block + used, tag(op, i));
+        used += putVarint(block + used, zigzag(static_cast<int64_t>(j) - static_cast<int64_t>(i)));
+        ++events;
+    }
+
+    // Makes room for one more event (at most two 10-byte varints)
+    void reserve()
+    {
+        if (used + 20 > kBlockBytes)
+            flushBlock();
+    }
+
+    void flushBlock()
+    {
+        Backoff backoff;
+        while (used > 0 && !ring.tryPush(block, used))
+            backoff.wait();
+        used = 0;
+    }
+
+    void drain()
+    {
+        std::vector<uint8_t> chunk(ring.capacity());
+        Backoff backoff;
+        for (;;)
+        {
+            bool done = closing.load(std::memory_order_acquire);
+            size_t n = ring.pop(chunk.data(), chunk.size());
+            if (n > 0)
+            {
+                if (std::fwrite(chunk.data(), 1, n, file) != n)
+                    ioError = true;
+                backoff.reset();
+            }
+            else
+            {
+                if (done)
+                    return;
+                backoff.wait();
+            }
+        }
+    }
+
+    TraceRing ring;
+    std::thread drainer;
+    std::atomic<bool> closing{false};
+    std::FILE *file = nullptr;
+    bool ioError = false;
+
+    // Producer-side encoder state
+    uint8_t block[kBlockBytes];
+    size_t used = 0;
+    uint64_t events = 0;
+    size_t lastIndex = 0;
+    int64_t lastValue = 0;
+};
+
+/**
+ * Sort policy that forwards compare/swap/write events to the recorder
+ * bound to the calling thread (no-op when none is bound).
+ */
+struct Tracing
+{
+    static constexpr bool enabled = true;
+
+    static TraceRecorder *&current()
+    {
+        static thread_local TraceRecorder *recorder = nullptr;
+        return recorder;
+    }
+
+    static void compare(size_t i, size_t j)
+    {
+        if (TraceRecorder *r = current())
+            r->compare(i, j);
+    }
+
+    static void swap(size_t i, size_t j)
+    {
+        if (TraceRecorder *r = current())
+            r->swap(i, j);
+    }
+
+    template <typename T>
+    static void write(size_t i, const T &value)
+    {
+        if (TraceRecorder *r = current())
+            r->write(i, traceValue(value));
+    }
+
+    static void scratch(size_t) {}
+    static constexpr bool advance(size_t, size_t) { return true; }
+
+    using Depth = sv::ops::NoCounting::Depth;
+
+    /** Binds a recorder to the calling thread for the lifetime of the guard. */
+    class Bind
+    {
+    public:
+        explicit Bind(TraceRecorder &recorder) : previous(current()) { current() = &recorder; }
+        ~Bind() { current() = previous; }
+        Bind(const Bind &) = delete;
+        Bind &operator=(const Bind &) = delete;
+
+    private:
+        TraceRecorder *previous;
+    };
+};
+
+} // namespace sv::trace
+
+#endif // SORTVISION_TRACE_RECORDER_HPP
@@ -1,3 +1,4 @@
+#include <stddef.h>
 #include <stdio.h>
 
 // Utility function to swap two elements
@@ -8,10 +9,10 @@ void swap(int* a, int* b) {
 }
 
 // Heapify a subtree rooted with node i in array of size n
-void heapify(int arr[], int n, int i) {
-    int largest = i;          // Initialize largest as root
-    int left = 2 * i + 1;     // Left child index
-    int right = 2 * i + 2;    // Right child index
+void heapify(int arr[], size_t n, size_t i) {
+    size_t largest = i;          // Initialize largest as root
+    size_t left = 2 * i + 1;     // Left child index
+    size_t right = 2 * i + 2;    // Right child index
 
     // If left child is larger than root
     if (left < n && arr[left] > arr[largest])
@@ -29,20 +30,22 @@ void heapify(int arr[], int n, int i) {
 }
 
 // Build max heap from an unordered array
-void buildMaxHeap(int arr[], int n) {
+void buildMaxHeap(int arr[], size_t n) {
     // Start from last non-leaf node and heapify each node
-    for (int i = n / 2 - 1; i >= 0; i--) {
+    for (size_t i = n / 2; i-- > 0;) {
         heapify(arr, n, i);
     }
 }
 
 // Main function to perform Heap Sort
-void heapSort(int arr[], int n) {
+void heapSort(int arr[], size_t n) {
+    if (n < 2) return;
+
     // Step 1: Build max heap
     buildMaxHeap(arr, n);
 
     // Step 2: One by one extract elements from heap
-    for (int i = n - 1; i > 0; i--) {
+    for (size_t i = n - 1; i > 0; i--) {
         // Move current root to end
         swap(&arr[0], &arr[i]);
 
@@ -52,8 +55,8 @@ void heapSort(int arr[], int n) {
 }
 
 // Utility function to print an array
-void printArray(int arr[], int n) {
-    for (int i = 0; i < n; i++)
+void printArray(int arr[], size_t n) {
+    for (size_t i = 0; i < n; i++)
         printf("%d ", arr[i]);
     printf("\n");
 }
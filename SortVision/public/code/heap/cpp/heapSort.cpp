@@ -5,6 +5,10 @@
 #include <vector>
 #include <algorithm> // For swap
 
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/perfCounters.hpp"
+#include "../../common/cpp/sortControl.hpp"
+
 using namespace std;
 
 /**
@@ -16,29 +20,34 @@ using namespace std;
  * @param arr[] - the array representing the heap
  * @param n - total number of elements in heap
  * @param i - index of the root of subtree to heapify
+ * @tparam Ops - operation-counting policy (see opCounters.hpp)
  * 
  * Time Complexity: O(log n)
  * Space Complexity: O(1)
  */
-void heapify(int arr[], int n, int i) {
-    int largest = i;         // Initialize largest as root
-    int left = 2 * i + 1;    // left child index
-    int right = 2 * i + 2;   // right child index
+template <class Ops = sv::ops::NoCounting>
+void heapify(int arr[], size_t n, size_t i) {
+    typename Ops::Depth depth;
+
+    size_t largest = i;         // Initialize largest as root
+    size_t left = 2 * i + 1;    // left child index
+    size_t right = 2 * i + 2;   // right child index
 
     // If left child is larger than root
-    if (left < n && arr[left] > arr[largest])
+    if (left < n && (Ops::compare(left, largest), arr[left] > arr[largest]))
         largest = left;
 
     // If right child is larger than the largest so far
-    if (right < n && arr[right] > arr[largest])
+    if (right < n && (Ops::compare(right, largest), arr[right] > arr[largest]))
         largest = right;
 
     // If largest is not root
     if (largest != i) {
+        Ops::swap(i, largest);
         swap(arr[i], arr[largest]);
 
         // Recursively heapify the affected sub-tree
-        heapify(arr, n, largest);
+        heapify<Ops>(arr, n, largest);
     }
 }
 
@@ -52,20 +61,42 @@ void heapify(int arr[], int n, int i) {
  * 
  * Time Complexity: O(n log n)
  * Space Complexity: O(1) — In-place sorting
+ *
+ * Progress is reported every 1024 heapify calls (n/2 + n - 1 in total).
  */
-void heapSort(int arr[], int n) {
+template <class Ops = sv::ops::NoCounting>
+void heapSort(int arr[], size_t n) {
+    if (n < 2) return;
+    size_t total = n / 2 + n - 1, reported = 0;
+    if (!Ops::advance(0, total)) return;
+    auto report = [&](size_t calls) {
+        if ((calls & 1023) != 0) return true;
+        size_t units = calls - reported;
+        reported = calls;
+        return Ops::advance(units, 0);
+    };
+
     // Step 1: Build a max heap from the array (bottom-up heapify)
-    for (int i = n / 2 - 1; i >= 0; i--)
-        heapify(arr, n, i);
+    {
+        SV_PERF_PHASE("heapify", n);
+        for (size_t i = n / 2; i-- > 0;) {
+            heapify<Ops>(arr, n, i);
+            if (!report(n / 2 - i)) return;
+        }
+    }
 
     // Step 2: Extract elements from the heap one by one
-    for (int i = n - 1; i > 0; i--) {
+    SV_PERF_PHASE("heapExtract", n);
+    for (size_t i = n - 1; i > 0; i--) {
         // Move current root (max) to the end
+        Ops::swap(0, i);
         swap(arr[0], arr[i]);
 
         // Heapify the reduced heap
-        heapify(arr, i, 0);
+        heapify<Ops>(arr, i, 0);
+        if (!report(n / 2 + n - i)) return;
     }
+    Ops::advance(total - reported, 0);
 }
 
 /**
@@ -73,8 +104,8 @@ void heapSort(int arr[], int n) {
  * --------------------
  * Helper function to print array elements
  */
-void printArray(int arr[], int n) {
-    for (int i = 0; i < n; ++i)
+void printArray(int arr[], size_t n) {
+    for (size_t i = 0; i < n; ++i)
         cout << arr[i] << " ";
     cout << "\n";
 }
@@ -89,35 +120,35 @@ void runTests() {
 
     // Test Case 1: Normal unsorted array
     int arr1[] = {12, 11, 13, 5, 6, 7};
-    int n1 = sizeof(arr1)/sizeof(arr1[0]);
+    size_t n1 = sizeof(arr1)/sizeof(arr1[0]);
     heapSort(arr1, n1);
     cout << "Sorted Array 1: ";
     printArray(arr1, n1);
 
     // Test Case 2: Already sorted array
     int arr2[] = {1, 2, 3, 4, 5};
-    int n2 = sizeof(arr2)/sizeof(arr2[0]);
+    size_t n2 = sizeof(arr2)/sizeof(arr2[0]);
     heapSort(arr2, n2);
     cout << "Sorted Array 2: ";
     printArray(arr2, n2);
 
     // Test Case 3: Array with duplicates
     int arr3[] = {4, 10, 4, 3, 4};
-    int n3 = sizeof(arr3)/sizeof(arr3[0]);
+    size_t n3 = sizeof(arr3)/sizeof(arr3[0]);
     heapSort(arr3, n3);
     cout << "Sorted Array 3: ";
     printArray(arr3, n3);
 
     // Test Case 4: Single element
     int arr4[] = {42};
-    int n4 = sizeof(arr4)/sizeof(arr4[0]);
+    size_t n4 = sizeof(arr4)/sizeof(arr4[0]);
     heapSort(arr4, n4);
     cout << "Sorted Array 4: ";
     printArray(arr4, n4);
 
     // Test Case 5: Empty array
     int arr5[] = {};
-    int n5 = sizeof(arr5)/sizeof(arr5[0]);
+    size_t n5 = sizeof(arr5)/sizeof(arr5[0]);
     heapSort(arr5, n5);
     cout << "Sorted Array 5 (Empty): ";
     printArray(arr5, n5);
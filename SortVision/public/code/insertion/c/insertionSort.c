@@ -1,12 +1,15 @@
+#include <stddef.h>
 #include <stdio.h>
 
 // Function to perform insertion sort on an array
-void insertionSort(int arr[], int n) {
-    int i, key, j;
+void insertionSort(int arr[], size_t n) {
+    size_t i;
+    ptrdiff_t j; // signed: reaches -1 when the key goes to the front
+    int key;
     // Traverse from the second element to the end of the array
     for (i = 1; i < n; i++) {
         key = arr[i]; // Store the current element as key
-        j = i - 1;
+        j = (ptrdiff_t)i - 1;
         // Move elements of arr[0..i-1], that are greater than key,
         // to one position ahead of their current position
         while (j >= 0 && arr[j] > key) {
@@ -18,8 +21,8 @@ void insertionSort(int arr[], int n) {
 }
 
 // Utility function to print an array
-void printArray(int arr[], int n) {
-    for (int i = 0; i < n; i++) {
+void printArray(int arr[], size_t n) {
+    for (size_t i = 0; i < n; i++) {
         printf("%d ", arr[i]);
     }
     printf("\n");
@@ -1,25 +1,46 @@
 
+#include <cstddef>
+#include <vector>
+
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/sortControl.hpp"
+
+// Ops: operation-counting policy (see opCounters.hpp)
+// Progress is reported every 1024 insertions, in elements inserted
+template <class Ops = sv::ops::NoCounting>
 void insertionSort(std::vector<int>& arr) {
     // Get the size of the array
-    int n = arr.size();
+    size_t n = arr.size();
+    if (!Ops::advance(0, n)) return;
+    size_t reported = 0;
     
     // Start from the second element (index 1)
     // First element (index 0) is considered as sorted
-    for (int i = 1; i < n; i++) {
+    for (size_t i = 1; i < n; i++) {
         // Store the current element to be inserted
         int key = arr[i];
         
         // Initialize j as the position before current element
-        int j = i - 1;
+        // (signed: it steps to -1 when the key goes to the front)
+        ptrdiff_t j = static_cast<ptrdiff_t>(i) - 1;
         
         // Move elements of arr[0..i-1] that are greater than key
         // to one position ahead of their current position
-        while (j >= 0 && arr[j] > key) {
+        // (the key conceptually sits in the hole at j + 1)
+        while (j >= 0 && (Ops::compare(j, j + 1), arr[j] > key)) {
+            Ops::write(j + 1, arr[j]);
             arr[j + 1] = arr[j];  // Shift element to the right
             j = j - 1;            // Move to previous position
         }
         
         // Place the key in its correct position
+        Ops::write(j + 1, key);
         arr[j + 1] = key;
+
+        if ((i & 1023) == 0) {
+            if (!Ops::advance(i - reported, 0)) return;
+            reported = i;
+        }
     }
+    Ops::advance(n - reported, 0);
 }
\ No newline at end of file
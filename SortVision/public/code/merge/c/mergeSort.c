@@ -1,22 +1,21 @@
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../common/c/sortWorkspace.h"
+
 // Utility function to merge two sorted subarrays
 // First subarray is arr[left..mid]
 // Second subarray is arr[mid+1..right]
-void merge(int arr[], int left, int mid, int right) {
-    int i, j, k;
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
-
-    // Create temporary arrays
-    int* L = (int*)malloc(n1 * sizeof(int));
-    int* R = (int*)malloc(n2 * sizeof(int));
+void merge(int arr[], ptrdiff_t left, ptrdiff_t mid, ptrdiff_t right) {
+    ptrdiff_t i, j, k;
+    ptrdiff_t n1 = mid - left + 1;
+    ptrdiff_t n2 = right - mid;
 
-    if (L == NULL || R == NULL) {
-        printf("Memory allocation failed.\n");
-        return;
-    }
+    // Temporary arrays come from the thread's workspace, which is kept
+    // between merges instead of being allocated for each one
+    int* L = (int*)sortWorkspaceReserve(sortWorkspaceThisThread(), (n1 + n2) * sizeof(int));
+    int* R = L + n1;
 
     // Copy data to temp arrays L[] and R[]
     for (i = 0; i < n1; i++)
@@ -42,16 +41,12 @@ void merge(int arr[], int left, int mid, int right) {
     // Copy remaining elements of R[], if any
     while (j < n2)
         arr[k++] = R[j++];
-
-    // Free dynamically allocated memory
-    free(L);
-    free(R);
 }
 
 // Recursive merge sort function
-void mergeSort(int arr[], int left, int right) {
+void mergeSort(int arr[], ptrdiff_t left, ptrdiff_t right) {
     if (left < right) {
-        int mid = left + (right - left) / 2;
+        ptrdiff_t mid = left + (right - left) / 2;
 
         // Sort first and second halves
         mergeSort(arr, left, mid);
@@ -63,8 +58,8 @@ void mergeSort(int arr[], int left, int right) {
 }
 
 // Utility function to print the array
-void printArray(int arr[], int size) {
-    for (int i = 0; i < size; i++)
+void printArray(int arr[], size_t size) {
+    for (size_t i = 0; i < size; i++)
         printf("%d ", arr[i]);
     printf("\n");
 }
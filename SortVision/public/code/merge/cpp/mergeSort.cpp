@@ -6,6 +6,17 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/perfCounters.hpp"
+#include "../../common/cpp/simdMerge.hpp"
+#include "../../common/cpp/simdScan.hpp"
+#include "../../common/cpp/sortControl.hpp"
+#include "../../common/cpp/sortGroup.hpp"
+#include "../../common/cpp/sortWorkspace.hpp"
 using namespace std;
 
 /**
@@ -16,34 +27,82 @@ using namespace std;
  * @param left Starting index
  * @param mid Mid index
  * @param right Ending index
+ * @param ws Workspace the temp arrays are taken from (see sortWorkspace.hpp)
+ * @tparam Ops Operation-counting policy (see opCounters.hpp)
+ *
+ * Without instrumentation the merge runs on the SIMD bitonic kernel
+ * (simdMerge.hpp); the counting and tracing policies keep the element-wise
+ * loop so every comparison and write is reported.
  */
-void merge(vector<int>& arr, int left, int mid, int right) {
+template <class Ops = sv::ops::NoCounting>
+void merge(vector<int>& arr, ptrdiff_t left, ptrdiff_t mid, ptrdiff_t right,
+           sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    SV_PERF_PHASE("merge", right - left + 1);
     // Sizes of the subarrays
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
+    ptrdiff_t n1 = mid - left + 1;
+    ptrdiff_t n2 = right - mid;
 
-    // Create temp arrays
-    vector<int> L(n1), R(n2);
+    // Temp arrays, returned to the workspace when this merge ends
+    sv::SortWorkspace::Scope scope(ws);
+    int* L = ws.take<int>(n1);
+    int* R = ws.take<int>(n2);
 
     // Copy data to temp arrays L[] and R[]
-    for (int i = 0; i < n1; ++i)
+    for (ptrdiff_t i = 0; i < n1; ++i)
         L[i] = arr[left + i];
-    for (int j = 0; j < n2; ++j)
+    for (ptrdiff_t j = 0; j < n2; ++j)
         R[j] = arr[mid + 1 + j];
+    Ops::scratch(n1 + n2);
+
+    if constexpr (!Ops::enabled) {
+        sv::simd::merge(L, n1, R, n2, arr.data() + left);
+        return;
+    }
 
     // Merge the temp arrays back into arr[left..right]
-    int i = 0;  // Initial index of first subarray
-    int j = 0;  // Initial index of second subarray
-    int k = left;  // Initial index of merged subarray
+    ptrdiff_t i = 0;  // Initial index of first subarray
+    ptrdiff_t j = 0;  // Initial index of second subarray
+    ptrdiff_t k = left;  // Initial index of merged subarray
 
+    // Comparisons are reported at the elements' original positions
     while (i < n1 && j < n2) {
-        if (L[i] <= R[j]) arr[k++] = L[i++];
-        else arr[k++] = R[j++];
+        Ops::compare(left + i, mid + 1 + j);
+        if (L[i] <= R[j]) {
+            Ops::write(k, L[i]);
+            arr[k++] = L[i++];
+        } else {
+            Ops::write(k, R[j]);
+            arr[k++] = R[j++];
+        }
     }
 
     // Copy remaining elements, if any
-    while (i < n1) arr[k++] = L[i++];
-    while (j < n2) arr[k++] = R[j++];
+    for (; i < n1; ++i, ++k) {
+        Ops::write(k, L[i]);
+        arr[k] = L[i];
+    }
+    for (; j < n2; ++j, ++k) {
+        Ops::write(k, R[j]);
+        arr[k] = R[j];
+    }
+}
+
+/**
+ * Elements written by all the merges of a top-down merge sort of n
+ * elements (the progress total). Each recursion level holds segments of
+ * two adjacent sizes, so this takes O(log n) steps.
+ */
+inline size_t mergeWork(size_t n) {
+    size_t total = 0, t = n, a = 1, b = 0; // a segments of size t, b of size t + 1
+    while (t >= 2 || (t == 1 && b != 0)) {
+        total += (t >= 2 ? a * t : 0) + b * (t + 1);
+        size_t na = t % 2 == 0 ? 2 * a + b : a;
+        size_t nb = t % 2 == 0 ? b : a + 2 * b;
+        t /= 2;
+        a = na;
+        b = nb;
+    }
+    return total;
 }
 
 /**
@@ -51,19 +110,146 @@ void merge(vector<int>& arr, int left, int mid, int right) {
  * @param arr Array to sort
  * @param left Left index
  * @param right Right index
+ * @param ws Workspace for the merge buffers
+ * @return false when Ops::advance asked the sort to stop
+ *
+ * Progress is reported after each merge, in elements merged.
  */
-void mergeSort(vector<int>& arr, int left, int right) {
+template <class Ops = sv::ops::NoCounting>
+bool mergeSort(vector<int>& arr, ptrdiff_t left, ptrdiff_t right,
+               sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    typename Ops::Depth depth;
     if (left < right) {
+        if (left == 0 && right + 1 == static_cast<ptrdiff_t>(arr.size()) &&
+            !Ops::advance(0, mergeWork(arr.size())))
+            return false;
+
         // Find the middle point
-        int mid = left + (right - left) / 2;
+        ptrdiff_t mid = left + (right - left) / 2;
 
         // Recursively sort first and second halves
-        mergeSort(arr, left, mid);
-        mergeSort(arr, mid + 1, right);
+        if (!mergeSort<Ops>(arr, left, mid, ws) || !mergeSort<Ops>(arr, mid + 1, right, ws))
+            return false;
 
         // Merge sorted halves
-        merge(arr, left, mid, right);
+        merge<Ops>(arr, left, mid, right, ws);
+        return Ops::advance(right - left + 1, 0);
+    }
+    return true;
+}
+
+/**
+ * Merges sorted L[0, n1) and R[0, n2) into `out`, which folds equal keys.
+ *
+ * Without instrumentation the output is produced in chunks of 2048 keys:
+ * a merge-path binary search finds how many of the next chunk come from
+ * L, the SIMD kernel merges them into a small buffer that stays in L1,
+ * and the emitter folds the buffer. The merged array is never written
+ * out in full.
+ */
+template <class Ops = sv::ops::NoCounting>
+void mergeInto(const int* L, ptrdiff_t n1, const int* R, ptrdiff_t n2, ptrdiff_t mid,
+               sv::group::Emitter& out) {
+    ptrdiff_t i = 0, j = 0;
+    if constexpr (!Ops::enabled) {
+        constexpr ptrdiff_t kChunk = 2048;
+        int buffer[kChunk];
+        while (i < n1 || j < n2) {
+            ptrdiff_t c = min(kChunk, (n1 - i) + (n2 - j));
+            // a = keys of the chunk taken from L (ties go to L first)
+            ptrdiff_t lo = max<ptrdiff_t>(0, c - (n2 - j)), hi = min(c, n1 - i);
+            while (lo < hi) {
+                ptrdiff_t a = lo + (hi - lo) / 2;
+                if (L[i + a] <= R[j + c - a - 1])
+                    lo = a + 1;
+                else
+                    hi = a;
+            }
+            sv::simd::merge(L + i, lo, R + j, c - lo, buffer);
+            out.add(buffer, c);
+            i += lo;
+            j += c - lo;
+        }
+        return;
     }
+
+    while (i < n1 && j < n2) {
+        Ops::compare(i, mid + 1 + j);
+        out.add(L[i] <= R[j] ? L[i++] : R[j++]);
+    }
+    for (; i < n1; ++i)
+        out.add(L[i]);
+    for (; j < n2; ++j)
+        out.add(R[j]);
+}
+
+/**
+ * Merge sort that hands the sorted keys to `out` instead of arr.
+ *
+ * Keys spanning a range no larger than their count are histogrammed
+ * instead (sv::group::countingGroup). Otherwise both halves are sorted
+ * with mergeSort and the last merge feeds the emitter (mergeInto), so
+ * the fully sorted array is never materialized. arr is left with its
+ * halves sorted, then overwritten by the emitter from the front.
+ * @return false when Ops::advance asked the sort to stop
+ */
+template <class Ops = sv::ops::NoCounting>
+bool mergeGroup(vector<int>& arr, sv::group::Emitter& out,
+                sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    ptrdiff_t n = static_cast<ptrdiff_t>(arr.size());
+    if (n == 0) return true;
+    auto [lo, hi] = sv::group::minMax(arr.data(), n);
+    if (sv::group::countingGroup(arr.data(), n, lo, hi, out, ws)) {
+        Ops::scratch(n);
+        return Ops::advance(0, 0);
+    }
+
+    if (!Ops::advance(0, mergeWork(n)))
+        return false;
+    ptrdiff_t mid = (n - 1) / 2;
+    if (!mergeSort<Ops>(arr, 0, mid, ws) || !mergeSort<Ops>(arr, mid + 1, n - 1, ws))
+        return false;
+
+    sv::SortWorkspace::Scope scope(ws);
+    int* L = ws.take<int>(mid + 1);
+    int* R = ws.take<int>(n - mid - 1);
+    copy(arr.begin(), arr.begin() + mid + 1, L);
+    copy(arr.begin() + mid + 1, arr.end(), R);
+    Ops::scratch(n);
+    mergeInto<Ops>(L, mid + 1, R, n - mid - 1, mid, out);
+    return Ops::advance(n, 0);
+}
+
+/**
+ * Sorts arr and removes duplicate keys in the same pass.
+ * @return Number of distinct keys; arr is resized to hold exactly them
+ *         (cancelled: arr.size(), with arr partly sorted)
+ */
+template <class Ops = sv::ops::NoCounting>
+size_t mergeSortUnique(vector<int>& arr, sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    sv::group::Emitter out(arr.data());
+    if (!mergeGroup<Ops>(arr, out, ws)) return arr.size();
+    arr.resize(out.size());
+    for (size_t k = 0; k < arr.size(); ++k)
+        Ops::write(k, arr[k]);
+    return arr.size();
+}
+
+/**
+ * Sorts arr and counts every key (group by key).
+ * @return counts[i] is the number of times arr[i] occurred; arr is
+ *         resized to its distinct keys in ascending order (cancelled:
+ *         empty, with arr partly sorted)
+ */
+template <class Ops = sv::ops::NoCounting>
+vector<size_t> mergeSortCounts(vector<int>& arr, sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    vector<size_t> counts;
+    sv::group::Emitter out(arr.data(), &counts);
+    if (!mergeGroup<Ops>(arr, out, ws)) return {};
+    arr.resize(out.size());
+    for (size_t k = 0; k < arr.size(); ++k)
+        Ops::write(k, arr[k]);
+    return counts;
 }
 
 /**
@@ -104,6 +290,56 @@ void runTests() {
     mergeSort(arr5, 0, arr5.size() - 1);
     assert((arr5 == vector<int>{}));
 
+    // Test 6: Operation counts on a reversed array of 8
+    // Every right-hand element wins at once: 4*1 + 2*2 + 1*4 comparisons
+    vector<int> arr6 = {8, 7, 6, 5, 4, 3, 2, 1};
+    sv::ops::Counting::reset();
+    mergeSort<sv::ops::Counting>(arr6, 0, arr6.size() - 1);
+    sv::ops::OpCounts ops = sv::ops::Counting::thisThread();
+    assert((arr6 == vector<int>{1, 2, 3, 4, 5, 6, 7, 8}));
+    assert(ops.comparisons == 12);
+    assert(ops.moves == 2 * 8 * 3); // 3 levels, each copies out and writes back 8
+    assert(ops.maxDepth == 4);
+
+    // Test 7: Repeated sorts reuse the workspace without allocating
+    sv::SortWorkspace ws;
+    vector<int> arr7(1000);
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 1000; ++i)
+            arr7[i] = (i * 7919) % 1000;
+        mergeSort(arr7, 0, arr7.size() - 1, ws);
+        assert(sv::simd::isSorted(arr7.data(), arr7.size()));
+    }
+    size_t warm = ws.allocations();
+    mergeSort(arr7, 0, arr7.size() - 1, ws);
+    assert(ws.allocations() == warm);
+
+    // Test 8: Fused unique and counts, through the merge (wide range) and
+    // through the counting path (narrow range)
+    vector<int> arr8 = {5, -1000000, 3, 5, 2000000, 3, 3, -1000000};
+    vector<int> arr9 = arr8;
+    assert(mergeSortUnique(arr8) == 4);
+    assert((arr8 == vector<int>{-1000000, 3, 5, 2000000}));
+    assert((mergeSortCounts(arr9) == vector<size_t>{2, 3, 2, 1}));
+    assert((arr9 == vector<int>{-1000000, 3, 5, 2000000}));
+    vector<int> arr10(5000);
+    for (int i = 0; i < 5000; ++i)
+        arr10[i] = (i * 7919) % 4999 - 2000;  // 4999 distinct keys, -2000 twice
+    vector<size_t> counts10 = mergeSortCounts(arr10);
+    assert(arr10.size() == 4999 && counts10.size() == 4999);
+    assert(arr10.front() == -2000 && arr10.back() == 2998 && counts10[0] == 2 && counts10[1] == 1);
+    vector<int> arr11(10000);
+    for (int i = 0; i < 10000; ++i)
+        arr11[i] = (i * 7919) % 10007 * 1000;  // wide range, all distinct
+    assert(mergeSortUnique(arr11) == 10000 && sv::simd::isSorted(arr11.data(), arr11.size()));
+
+    // Test 9: The float merge keeps signed zeros apart, so the output is
+    // still a permutation of the input
+    vector<float> negZeros(16, -0.0f), posZeros(16, 0.0f), zeros(32);
+    sv::simd::merge(negZeros.data(), 16, posZeros.data(), 16, zeros.data());
+    assert(count_if(zeros.begin(), zeros.end(), [](float z) { return signbit(z); }) == 16);
+    assert(all_of(zeros.begin(), zeros.end(), [](float z) { return z == 0.0f; }));
+
     cout << "✅ All test cases passed!\n";
 }
 
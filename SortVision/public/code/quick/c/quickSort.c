@@ -1,3 +1,4 @@
+#include <stddef.h>
 #include <stdio.h>
 
 // Function to swap two integers
@@ -8,11 +9,11 @@ void swap(int* a, int* b) {
 }
 
 // Lomuto partition function: selects the last element as pivot
-int partition(int arr[], int low, int high) {
+ptrdiff_t partition(int arr[], ptrdiff_t low, ptrdiff_t high) {
     int pivot = arr[high]; // Pivot element
-    int i = low - 1;        // Index of smaller element
+    ptrdiff_t i = low - 1;  // Index of smaller element
 
-    for (int j = low; j < high; j++) {
+    for (ptrdiff_t j = low; j < high; j++) {
         // If current element is smaller than or equal to pivot
         if (arr[j] <= pivot) {
             i++;
@@ -26,10 +27,10 @@ int partition(int arr[], int low, int high) {
 }
 
 // Recursive Quick Sort function using divide and conquer
-void quickSort(int arr[], int low, int high) {
+void quickSort(int arr[], ptrdiff_t low, ptrdiff_t high) {
     if (low < high) {
         // pi is partitioning index
-        int pi = partition(arr, low, high);
+        ptrdiff_t pi = partition(arr, low, high);
 
         // Recursively sort elements before and after partition
         quickSort(arr, low, pi - 1);
@@ -38,8 +39,8 @@ void quickSort(int arr[], int low, int high) {
 }
 
 // Utility function to print an array
-void printArray(int arr[], int size) {
-    for (int i = 0; i < size; i++)
+void printArray(int arr[], size_t size) {
+    for (size_t i = 0; i < size; i++)
         printf("%d ", arr[i]);
     printf("\n");
 }
@@ -6,6 +6,10 @@
  * This file includes:
  *  - partition: Lomuto partition scheme (with comments on alternate strategies)
  *  - quickSort: recursive sorting function with tail-call optimization
+ *  - quickSelect / multiSelect / nthElement: selection of one or many ranks
+ *    from the same partition kernel (introselect)
+ *  - introSort: three-way quick sort with a median-of-medians fallback, for
+ *    callers that cannot rule out duplicate-heavy or adversarial input
  *  - Input validation and edge-case handling
  *  - Time and space complexity analysis
  *  - Example usage and test cases in main()
@@ -15,8 +19,16 @@
 #include <iostream>
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <vector>
 #include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/perfCounters.hpp"
+#include "../../common/cpp/sortControl.hpp"
 
 /**
  * Partition the array using Lomuto's scheme.
@@ -26,24 +38,38 @@
  * @param arr  Array to partition
  * @param low  Starting index
  * @param high Ending index (pivot index)
+ * @tparam Ops Operation-counting policy (see opCounters.hpp)
  * @return Index of pivot after partition
  */
-int partition(int arr[], int low, int high) {
+template <class Ops = sv::ops::NoCounting>
+ptrdiff_t partition(int arr[], ptrdiff_t low, ptrdiff_t high) {
     if (low >= high) return low; // or throw, but safe default
+    SV_PERF_PHASE("partition", high - low + 1);
     // Median-of-three pivot selection to avoid worst-case O(n^2)
-    int mid = low + (high - low) / 2;
-    if (arr[low] > arr[mid]) std::swap(arr[low], arr[mid]);
-    if (arr[low] > arr[high]) std::swap(arr[low], arr[high]);
-    if (arr[mid] > arr[high]) std::swap(arr[mid], arr[high]);
+    ptrdiff_t mid = low + (high - low) / 2;
+    auto order = [&](ptrdiff_t a, ptrdiff_t b) {
+        Ops::compare(a, b);
+        if (arr[a] > arr[b]) {
+            Ops::swap(a, b);
+            std::swap(arr[a], arr[b]);
+        }
+    };
+    order(low, mid);
+    order(low, high);
+    order(mid, high);
+    Ops::swap(mid, high);
     std::swap(arr[mid], arr[high]); // Place median at end as pivot
     int pivot = arr[high];
-    int i = low - 1;
-    for (int j = low; j < high; ++j) {
+    ptrdiff_t i = low - 1;
+    for (ptrdiff_t j = low; j < high; ++j) {
+        Ops::compare(j, high);
         if (arr[j] <= pivot) {
             ++i;
+            Ops::swap(i, j);
             std::swap(arr[i], arr[j]);
         }
     }
+    Ops::swap(i + 1, high);
     std::swap(arr[i + 1], arr[high]);
     return i + 1;
 }
@@ -55,19 +81,29 @@ int partition(int arr[], int low, int high) {
  * @param arr  Array to sort
  * @param low  Starting index
  * @param high Ending index
+ *
+ * @return false when Ops::advance asked the sort to stop
+ *
+ * Progress is one unit per element that reaches its final position
+ * (pivots and one-element sides), reported after each partition.
  */
-void quickSort(int arr[], int low, int high) {
+template <class Ops = sv::ops::NoCounting>
+bool quickSort(int arr[], ptrdiff_t low, ptrdiff_t high) {
+    typename Ops::Depth depth;
     while (low < high) {
-        int pivotIndex = partition(arr, low, high);
+        ptrdiff_t pivotIndex = partition<Ops>(arr, low, high);
+        size_t placed = 1 + (pivotIndex - low == 1) + (high - pivotIndex == 1);
+        if (!Ops::advance(placed, 0)) return false;
         // Recurse into smaller partition first to limit stack depth
         if (pivotIndex - low < high - pivotIndex) {
-            quickSort(arr, low, pivotIndex - 1);
+            if (!quickSort<Ops>(arr, low, pivotIndex - 1)) return false;
             low = pivotIndex + 1;
         } else {
-            quickSort(arr, pivotIndex + 1, high);
+            if (!quickSort<Ops>(arr, pivotIndex + 1, high)) return false;
             high = pivotIndex - 1;
         }
     }
+    return true;
 }
 
 /**
@@ -75,24 +111,239 @@ void quickSort(int arr[], int low, int high) {
  *
  * @param arr Vector of integers to sort
  */
+template <class Ops = sv::ops::NoCounting>
 void quickSort(std::vector<int>& vec) {
     if (vec.empty()) return; // handle empty array
-    quickSort(vec.data(), 0, static_cast<int>(vec.size()) - 1);
+    if (!Ops::advance(vec.size() == 1, vec.size())) return;
+    quickSort<Ops>(vec.data(), 0, static_cast<ptrdiff_t>(vec.size()) - 1);
+}
+
+/**
+ * Three-way partition around arr[pivotIndex] (Dutch national flag).
+ * Unlike partition(), runs of keys equal to the pivot end up in the
+ * middle, so many duplicates cannot make it degrade.
+ *
+ * @return {first, last} index of the keys equal to the pivot
+ */
+template <class Ops = sv::ops::NoCounting>
+std::pair<ptrdiff_t, ptrdiff_t> partition3(int arr[], ptrdiff_t low, ptrdiff_t high, ptrdiff_t pivotIndex) {
+    Ops::swap(low, pivotIndex);
+    std::swap(arr[low], arr[pivotIndex]);
+    int pivot = arr[low];
+    // arr[low, lt) < pivot, arr[lt, i) == pivot, arr(gt, high] > pivot
+    ptrdiff_t lt = low, i = low + 1, gt = high;
+    while (i <= gt) {
+        Ops::compare(i, lt);
+        if (arr[i] < pivot) {
+            Ops::swap(lt, i);
+            std::swap(arr[lt++], arr[i++]);
+        } else {
+            Ops::compare(i, lt);
+            if (arr[i] > pivot) {
+                Ops::swap(i, gt);
+                std::swap(arr[i], arr[gt--]);
+            } else {
+                ++i;
+            }
+        }
+    }
+    return {lt, gt};
+}
+
+template <class Ops>
+void selectRanks(int arr[], ptrdiff_t low, ptrdiff_t high, const ptrdiff_t* ranks, size_t count, int budget);
+
+/**
+ * Median of medians of groups of five: a pivot with at least 30% of
+ * arr[low, high] on each side, found in linear time. Moves the group
+ * medians to the front of the range.
+ *
+ * @return Index of the pivot
+ */
+template <class Ops = sv::ops::NoCounting>
+ptrdiff_t medianOfMedians(int arr[], ptrdiff_t low, ptrdiff_t high) {
+    ptrdiff_t medians = low;
+    for (ptrdiff_t g = low; g <= high; g += 5) {
+        ptrdiff_t gHigh = std::min(g + 4, high);
+        for (ptrdiff_t i = g + 1; i <= gHigh; ++i) { // insertion sort of the group
+            for (ptrdiff_t j = i; j > g; --j) {
+                Ops::compare(j - 1, j);
+                if (arr[j - 1] <= arr[j]) break;
+                Ops::swap(j - 1, j);
+                std::swap(arr[j - 1], arr[j]);
+            }
+        }
+        Ops::swap(medians, g + (gHigh - g) / 2);
+        std::swap(arr[medians++], arr[g + (gHigh - g) / 2]);
+    }
+    ptrdiff_t mid = low + (medians - 1 - low) / 2;
+    selectRanks<Ops>(arr, low, medians - 1, &mid, 1, 0);
+    return mid;
+}
+
+/**
+ * Places every rank in ranks[0, count) (sorted, inside [low, high]):
+ * afterwards arr[r] holds the key a full sort would put there, with no
+ * larger key before it and no smaller key after it.
+ *
+ * Partitions like quickSort() but only recurses into the sides that hold
+ * requested ranks. After `budget` levels on a path, or as soon as a
+ * partition leaves less than 1/8 of the range on one side, it switches to
+ * three-way partitions around the median of medians. That keeps the worst
+ * case at O(n log n) on adversarial input (introselect). Lomuto puts every
+ * key equal to the pivot on one side, so runs of duplicates show up as a
+ * lopsided split, and the three-way partition finishes them in one pass.
+ */
+template <class Ops>
+void selectRanks(int arr[], ptrdiff_t low, ptrdiff_t high, const ptrdiff_t* ranks, size_t count, int budget) {
+    typename Ops::Depth depth;
+    while (count > 0 && low < high) {
+        ptrdiff_t first, last;
+        if (budget-- > 0) {
+            first = last = partition<Ops>(arr, low, high);
+            if (std::min(first - low, high - first) < (high - low + 1) / 8) budget = 0;
+        } else {
+            std::tie(first, last) = partition3<Ops>(arr, low, high, medianOfMedians<Ops>(arr, low, high));
+        }
+        // Ranks in [first, last] are in place; the others lie left or right
+        const ptrdiff_t* left = std::lower_bound(ranks, ranks + count, first);
+        const ptrdiff_t* right = std::upper_bound(left, ranks + count, last);
+        if (left != ranks)
+            selectRanks<Ops>(arr, low, first - 1, ranks, static_cast<size_t>(left - ranks), budget);
+        count -= static_cast<size_t>(right - ranks);
+        ranks = right;
+        low = last + 1;
+    }
+}
+
+/** 2 * floor(log2(n)): partition levels before falling back to median of medians. */
+inline int selectBudget(size_t n) {
+    int budget = 0;
+    for (; n > 1; n >>= 1) budget += 2;
+    return budget;
+}
+
+/**
+ * Selection: places the k-th smallest key (0-based) at arr[k], smaller or
+ * equal keys before it and greater or equal keys after it, like
+ * std::nth_element. Expected O(n), worst case O(n log n).
+ */
+template <class Ops = sv::ops::NoCounting>
+void quickSelect(int arr[], ptrdiff_t low, ptrdiff_t high, ptrdiff_t k) {
+    selectRanks<Ops>(arr, low, high, &k, 1, selectBudget(static_cast<size_t>(high - low + 1)));
+}
+
+/**
+ * Selects several ranks in one pass; ranks may be in any order and repeat.
+ * Each partition is shared by all ranks on its side, so q quantiles cost
+ * about O(n log q) instead of q separate selections.
+ */
+template <class Ops = sv::ops::NoCounting>
+void multiSelect(int arr[], size_t n, std::vector<ptrdiff_t> ranks) {
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    selectRanks<Ops>(arr, 0, static_cast<ptrdiff_t>(n) - 1, ranks.data(), ranks.size(), selectBudget(n));
+}
+
+/**
+ * Three-way introsort: median-of-three pivots, partition3() and insertion
+ * sort below 16 keys. All keys equal to the pivot are finished by one
+ * partition, so duplicates make it faster instead of quadratic. After
+ * `budget` levels on a path the pivot is the median of medians, which
+ * bounds the worst case at O(n log n).
+ *
+ * @return false when Ops::advance asked the sort to stop
+ *
+ * Progress is one unit per element that reaches its final position (the
+ * keys equal to each pivot, and each range finished by insertion sort).
+ */
+template <class Ops = sv::ops::NoCounting>
+bool introSort(int arr[], ptrdiff_t low, ptrdiff_t high, int budget) {
+    typename Ops::Depth depth;
+    while (high - low >= 16) {
+        ptrdiff_t pivotIndex;
+        if (budget-- > 0) {
+            auto median3 = [&](ptrdiff_t a, ptrdiff_t b, ptrdiff_t c) {
+                auto less = [&](ptrdiff_t x, ptrdiff_t y) { Ops::compare(x, y); return arr[x] < arr[y]; };
+                if (less(b, a)) std::swap(a, b);
+                if (less(c, b)) b = less(c, a) ? a : c;
+                return b;
+            };
+            // Tukey's ninther on large ranges: partition3() leaves sorted
+            // input in patterns that fool a single median of three
+            ptrdiff_t mid = low + (high - low) / 2;
+            if (high - low >= 128) {
+                ptrdiff_t step = (high - low) / 8;
+                pivotIndex = median3(median3(low, low + step, low + 2 * step), median3(mid - step, mid, mid + step),
+                                     median3(high - 2 * step, high - step, high));
+            } else {
+                pivotIndex = median3(low, mid, high);
+            }
+        } else {
+            pivotIndex = medianOfMedians<Ops>(arr, low, high);
+        }
+        auto [first, last] = partition3<Ops>(arr, low, high, pivotIndex);
+        if (!Ops::advance(static_cast<size_t>(last - first + 1), 0)) return false;
+        // Recurse into the smaller side first to limit stack depth
+        if (first - low < high - last) {
+            if (!introSort<Ops>(arr, low, first - 1, budget)) return false;
+            low = last + 1;
+        } else {
+            if (!introSort<Ops>(arr, last + 1, high, budget)) return false;
+            high = first - 1;
+        }
+    }
+    for (ptrdiff_t i = low + 1; i <= high; ++i) {
+        int key = arr[i];
+        ptrdiff_t j = i - 1;
+        while (j >= low && (Ops::compare(j, i), arr[j] > key)) {
+            Ops::write(j + 1, arr[j]);
+            arr[j + 1] = arr[j];
+            --j;
+        }
+        Ops::write(j + 1, key);
+        arr[j + 1] = key;
+    }
+    return high < low || Ops::advance(static_cast<size_t>(high - low + 1), 0);
+}
+
+/**
+ * Wrapper for introSort.
+ *
+ * @param vec Vector of integers to sort
+ */
+template <class Ops = sv::ops::NoCounting>
+void introSort(std::vector<int>& vec) {
+    if (!Ops::advance(0, vec.size())) return;
+    introSort<Ops>(vec.data(), 0, static_cast<ptrdiff_t>(vec.size()) - 1, selectBudget(vec.size()));
+}
+
+/**
+ * Wrapper for quickSelect with validation.
+ *
+ * @return The k-th smallest key
+ * @throws std::out_of_range when k >= vec.size()
+ */
+template <class Ops = sv::ops::NoCounting>
+int nthElement(std::vector<int>& vec, size_t k) {
+    if (k >= vec.size()) throw std::out_of_range("nthElement: k out of range");
+    quickSelect<Ops>(vec.data(), 0, static_cast<ptrdiff_t>(vec.size()) - 1, static_cast<ptrdiff_t>(k));
+    return vec[k];
 }
 
 /**
  * Prints an array or vector to stdout.
  */
-void printArray(const int arr[], int n) {
+void printArray(const int arr[], size_t n) {
     std::cout << '[';
-    for (int i = 0; i < n; ++i) {
+    for (size_t i = 0; i < n; ++i) {
         std::cout << arr[i] << (i + 1 < n ? ", " : "");
     }
     std::cout << "]\n";
 }
 
 void printVector(const std::vector<int>& vec) {
-    printArray(vec.data(), static_cast<int>(vec.size()));
+    printArray(vec.data(), vec.size());
 }
 
 int main() {
@@ -118,6 +369,62 @@ int main() {
         std::cout << std::string(30, '-') << '\n';
     }
 
+    // Operation counts: a sorted input still pays n log n comparisons,
+    // and smaller-side-first recursion keeps the depth logarithmic
+    std::vector<int> counted(1024);
+    for (size_t i = 0; i < counted.size(); ++i) counted[i] = static_cast<int>(i);
+    sv::ops::Counting::reset();
+    quickSort<sv::ops::Counting>(counted);
+    sv::ops::OpCounts ops = sv::ops::Counting::thisThread();
+    std::cout << "Sorted 1024 elements: " << ops.comparisons << " comparisons, "
+              << ops.swaps << " swaps, max depth " << ops.maxDepth << '\n';
+    assert(ops.comparisons < 1024 * 11);
+    assert(ops.maxDepth <= 11);
+
+    // Selection: every rank of a shuffled array with duplicates, and many
+    // quantiles at once, must match the fully sorted order
+    std::mt19937 rng(7);
+    std::vector<int> keys(500);
+    for (int& k : keys) k = static_cast<int>(rng() % 50);
+    std::vector<int> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t k = 0; k < keys.size(); k += 7) {
+        std::vector<int> v = keys;
+        assert(nthElement(v, k) == sorted[k]);
+        for (size_t i = 0; i < v.size(); ++i) assert(i < k ? v[i] <= v[k] : v[i] >= v[k]);
+    }
+    std::vector<int> v = keys;
+    std::vector<ptrdiff_t> ranks = {499, 0, 250, 125, 375, 250, 490};
+    multiSelect(v.data(), v.size(), ranks);
+    for (ptrdiff_t r : ranks) assert(v[r] == sorted[r]);
+    std::cout << "Median of 500: " << v[250] << ", 98th percentile: " << v[490] << '\n';
+
+    // A sorted input with one repeated key defeats the Lomuto partition:
+    // the first lopsided split switches to three-way partitions around the
+    // median of medians, which finish all the equal keys at once
+    std::vector<int> flat(4096, 3);
+    sv::ops::Counting::reset();
+    quickSelect<sv::ops::Counting>(flat.data(), 0, 4095, 2048);
+    ops = sv::ops::Counting::thisThread();
+    std::cout << "Select in 4096 equal keys: " << ops.comparisons << " comparisons\n";
+    assert(ops.comparisons < 4096 * 8);
+
+    // Three-way introsort: equal keys are finished by the first partition,
+    // and a mix of duplicates and distinct keys still sorts correctly
+    sv::ops::Counting::reset();
+    introSort<sv::ops::Counting>(flat);
+    ops = sv::ops::Counting::thisThread();
+    std::cout << "Introsort of 4096 equal keys: " << ops.comparisons << " comparisons\n";
+    assert(ops.comparisons < 4096 * 3);
+    for (auto& tc : testCases) {
+        std::vector<int> vc = tc;
+        introSort(vc);
+        assert(std::is_sorted(vc.begin(), vc.end()));
+    }
+    std::vector<int> mixed = keys;
+    introSort(mixed);
+    assert(mixed == sorted);
+
     std::cout << "All test cases passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../common/c/sortWorkspace.h"
+
 // Radix Sort Implementation in C
 // This implementation handles edge cases such as empty arrays, single-element arrays,
 // arrays with duplicates, and already sorted arrays. It uses Counting Sort as a subroutine
@@ -17,27 +19,23 @@
 // O(n + k) for output array and digit counts.
 
 // Helper function: Find maximum value in array
-int getMax(int arr[], int n) {
+int getMax(int arr[], size_t n) {
     if (n == 0) return 0; // Handle empty array
     int max = arr[0];
-    for (int i = 1; i < n; i++)
+    for (size_t i = 1; i < n; i++)
         if (arr[i] > max)
             max = arr[i];
     return max;
 }
 
 // Counting Sort based on digit represented by exp (1, 10, 100, ...)
-void countingSort(int arr[], int n, int exp) {
-    int* output = (int*)malloc(n * sizeof(int));
-    int count[10] = {0};
-
-    if (!output) {
-        fprintf(stderr, "Memory allocation failed.\n");
-        exit(EXIT_FAILURE);
-    }
+void countingSort(int arr[], size_t n, int exp) {
+    // Reused across passes and calls (see sortWorkspace.h)
+    int* output = (int*)sortWorkspaceReserve(sortWorkspaceThisThread(), n * sizeof(int));
+    size_t count[10] = {0};
 
     // Count occurrences of each digit
-    for (int i = 0; i < n; i++)
+    for (size_t i = 0; i < n; i++)
         count[(arr[i] / exp) % 10]++;
 
     // Convert count[] to actual positions
@@ -45,33 +43,32 @@ void countingSort(int arr[], int n, int exp) {
         count[i] += count[i - 1];
 
     // Build the output array from right to left (stable sort)
-    for (int i = n - 1; i >= 0; i--) {
+    for (size_t i = n; i-- > 0;) {
         int digit = (arr[i] / exp) % 10;
         output[count[digit] - 1] = arr[i];
         count[digit]--;
     }
 
     // Copy sorted array back to original
-    for (int i = 0; i < n; i++)
+    for (size_t i = 0; i < n; i++)
         arr[i] = output[i];
-
-    free(output);
 }
 
 // Core Radix Sort Function
-void radixSort(int arr[], int n) {
+void radixSort(int arr[], size_t n) {
     if (n <= 1) return; // No sorting needed
 
     int max = getMax(arr, n);
 
     // Apply counting sort for each digit
-    for (int exp = 1; max / exp > 0; exp *= 10)
-        countingSort(arr, n, exp);
+    // exp is 64-bit so exp *= 10 cannot overflow after the last digit of a large max
+    for (long long exp = 1; max / exp > 0; exp *= 10)
+        countingSort(arr, n, (int)exp);
 }
 
 // Utility function to print array
-void printArray(int arr[], int n) {
-    for (int i = 0; i < n; i++)
+void printArray(int arr[], size_t n) {
+    for (size_t i = 0; i < n; i++)
         printf("%d ", arr[i]);
     printf("\n");
 }
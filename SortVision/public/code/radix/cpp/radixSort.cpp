@@ -6,7 +6,17 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cassert>
+#include <climits>
 #include <cmath>
+#include <cstdint>
+
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/perfCounters.hpp"
+#include "../../common/cpp/simdScan.hpp"
+#include "../../common/cpp/sortControl.hpp"
+#include "../../common/cpp/sortGroup.hpp"
+#include "../../common/cpp/sortWorkspace.hpp"
 using namespace std;
 
 /**
@@ -14,30 +24,57 @@ using namespace std;
  * Used to determine the number of digits to process
  * 
  * @param arr Input array
+ * @param n Number of elements (at least 1)
  * @return int Maximum absolute value
+ *
+ * Runs on the widest SIMD kernel the CPU supports (simdScan.hpp).
  */
+int getMax(const int* arr, size_t n) {
+    return sv::simd::maxAbs(arr, n);
+}
+
 int getMax(const vector<int>& arr) {
-    int maxVal = abs(arr[0]);
-    for (int i = 1; i < arr.size(); ++i) {
-        maxVal = max(maxVal, abs(arr[i]));
-    }
-    return maxVal;
+    return getMax(arr.data(), arr.size());
 }
 
 /**
- * @brief Performs counting sort on the array based on the digit represented by exp
- * 
- * @param arr Input/output array to sort
- * @param exp Current digit exponent (1 for units, 10 for tens, etc.)
- * @param base Number system base (default is 10)
+ * @brief |v| as an unsigned value, defined for INT_MIN (2^31 has no int form)
  */
-void countSort(vector<int>& arr, int exp, int base) {
-    vector<int> output(arr.size());
-    vector<int> count(base, 0);
+inline uint32_t magnitude(int v) {
+    return v < 0 ? 0u - static_cast<uint32_t>(v) : static_cast<uint32_t>(v);
+}
 
-    // Count occurrences based on current digit
-    for (int num : arr) {
-        int index = (abs(num) / exp) % base;
+/**
+ * @brief Number of digit passes radix sort makes for magnitudes up to maxVal
+ */
+int digitPasses(uint32_t maxVal, int base) {
+    int passes = 0;
+    for (long long exp = 1; maxVal / exp > 0; exp *= base)
+        ++passes;
+    return passes;
+}
+
+/**
+ * @brief One stable counting-sort pass of arr into output by the digit at exp
+ *
+ * @param arr Input array (not modified)
+ * @param output Receives the n keys ordered by the digit
+ * @param n Number of elements
+ * @param exp Current digit exponent (1 for units, 10 for tens, etc.), at
+ *            most the largest magnitude (2^31), so it fits 32 bits
+ * @param base Number system base
+ * @param ws Workspace the count array is taken from
+ */
+template <class Ops = sv::ops::NoCounting>
+void countSortInto(const int* arr, int* output, size_t n, uint32_t exp, int base,
+                   sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    sv::SortWorkspace::Scope scope(ws);
+    size_t* count = ws.take<size_t>(base);
+    fill(count, count + base, 0);
+
+    // Count occurrences based on current digit (of the magnitude)
+    for (size_t i = 0; i < n; ++i) {
+        size_t index = (magnitude(arr[i]) / exp) % base;
         count[index]++;
     }
 
@@ -46,50 +83,222 @@ void countSort(vector<int>& arr, int exp, int base) {
         count[i] += count[i - 1];
 
     // Build the output array (stable sort)
-    for (int i = arr.size() - 1; i >= 0; --i) {
-        int index = (abs(arr[i]) / exp) % base;
+    for (size_t i = n; i-- > 0;) {
+        size_t index = (magnitude(arr[i]) / exp) % base;
         output[--count[index]] = arr[i];
     }
+    Ops::scratch(n);
+}
+
+/**
+ * @brief Performs counting sort on the array based on the digit represented by exp
+ * 
+ * @param arr Input/output array to sort
+ * @param n Number of elements
+ * @param exp Current digit exponent (1 for units, 10 for tens, etc.)
+ * @param base Number system base (default is 10)
+ * @param ws Workspace the output and count arrays are taken from
+ * @tparam Ops Operation-counting policy (see opCounters.hpp); radix sort
+ *             makes no comparisons, each pass moves every element twice
+ */
+template <class Ops = sv::ops::NoCounting>
+void countSort(int* arr, size_t n, uint32_t exp, int base,
+               sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    SV_PERF_PHASE("countSort", n);
+    sv::SortWorkspace::Scope scope(ws);
+    int* output = ws.take<int>(n);
+    countSortInto<Ops>(arr, output, n, exp, base, ws);
 
     // Copy output back to arr
-    arr = output;
+    copy(output, output + n, arr);
+    Ops::scratch(n);
+}
+
+template <class Ops = sv::ops::NoCounting>
+void countSort(vector<int>& arr, uint32_t exp, int base,
+               sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    countSort<Ops>(arr.data(), arr.size(), exp, base, ws);
 }
 
 /**
  * @brief Main Radix Sort function
  * Sorts the array using Radix Sort with optional base
- * Handles both negative and positive integers
+ * Handles both negative and positive integers, INT_MIN included:
+ * negatives are sorted by the digits of their magnitude, then reversed
  * 
  * @param arr Input/output array to be sorted
  * @param base Base for the number system (default is 10)
+ * @param ws Workspace for the sign partitions and digit passes
+ * @tparam Ops Operation-counting policy (see opCounters.hpp)
+ *
+ * Progress is reported per digit pass, in elements moved. arr is only
+ * written after the last pass, so a cancelled sort leaves it unchanged.
  */
-void radixSort(vector<int>& arr, int base = 10) {
+template <class Ops = sv::ops::NoCounting>
+void radixSort(vector<int>& arr, int base = 10,
+               sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
     // Separate negative and positive numbers
-    vector<int> negs, poss;
+    size_t nNeg = count_if(arr.begin(), arr.end(), [](int num) { return num < 0; });
+    size_t nPos = arr.size() - nNeg;
+    sv::SortWorkspace::Scope scope(ws);
+    int* negs = ws.take<int>(nNeg);
+    int* poss = ws.take<int>(nPos);
+    size_t ni = 0, pi = 0;
     for (int num : arr) {
-        (num < 0 ? negs : poss).push_back(num);
+        if (num < 0)
+            negs[ni++] = num;
+        else
+            poss[pi++] = num;
+    }
+    Ops::scratch(arr.size());
+
+    // Largest magnitudes from the extremes; maxAbs() is undefined for INT_MIN
+    uint32_t maxPos = 0, maxNeg = 0;
+    if (!arr.empty()) {
+        auto [lo, hi] = sv::simd::minMax(arr.data(), arr.size());
+        maxNeg = lo < 0 ? magnitude(lo) : 0;
+        maxPos = hi > 0 ? magnitude(hi) : 0;
     }
+    if (!Ops::advance(0, nPos * digitPasses(maxPos, base) + nNeg * digitPasses(maxNeg, base)))
+        return;
 
     // Sort positive numbers
-    if (!poss.empty()) {
-        int maxPos = getMax(poss);
-        for (int exp = 1; maxPos / exp > 0; exp *= base)
-            countSort(poss, exp, base);
+    if (nPos > 0) {
+        // 64-bit exponent: exp *= base must not overflow past the top digit
+        for (long long exp = 1; maxPos / exp > 0; exp *= base) {
+            countSort<Ops>(poss, nPos, static_cast<uint32_t>(exp), base, ws);
+            if (!Ops::advance(nPos, 0)) return;
+        }
     }
 
-    // Sort negative numbers
-    if (!negs.empty()) {
-        for (int& num : negs) num = -num;  // Convert to positive
-        int maxNeg = getMax(negs);
-        for (int exp = 1; maxNeg / exp > 0; exp *= base)
-            countSort(negs, exp, base);
-        for (int& num : negs) num = -num;  // Restore negative sign
-        reverse(negs.begin(), negs.end()); // Reverse for correct order
+    // Sort negative numbers by magnitude, then reverse for ascending order
+    if (nNeg > 0) {
+        for (long long exp = 1; maxNeg / exp > 0; exp *= base) {
+            countSort<Ops>(negs, nNeg, static_cast<uint32_t>(exp), base, ws);
+            if (!Ops::advance(nNeg, 0)) return;
+        }
+        reverse(negs, negs + nNeg);
     }
 
     // Merge negatives and positives
-    arr = negs;
-    arr.insert(arr.end(), poss.begin(), poss.end());
+    copy(negs, negs + nNeg, arr.begin());
+    copy(poss, poss + nPos, arr.begin() + nNeg);
+    for (size_t i = 0; i < arr.size(); ++i)
+        Ops::write(i, arr[i]);
+}
+
+
+/**
+ * @brief Radix-sorts keys[0, n) (all >= 0, at most maxVal) and returns the
+ * sorted keys: keys itself when there is no digit to sort by, otherwise
+ * the scratch buffer `last`, filled by the final pass instead of copying
+ * it back.
+ * @return nullptr when Ops::advance asked the sort to stop
+ */
+template <class Ops>
+const int* radixPasses(int* keys, int* last, size_t n, uint32_t maxVal, int base, sv::SortWorkspace& ws) {
+    int passes = digitPasses(maxVal, base);
+    long long exp = 1;
+    for (int pass = 0; pass + 1 < passes; ++pass, exp *= base) {
+        countSort<Ops>(keys, n, static_cast<uint32_t>(exp), base, ws);
+        if (!Ops::advance(n, 0)) return nullptr;
+    }
+    if (passes == 0)
+        return keys;
+    countSortInto<Ops>(keys, last, n, static_cast<uint32_t>(exp), base, ws);
+    return Ops::advance(n, 0) ? last : nullptr;
+}
+
+/**
+ * @brief Radix sort that hands the sorted keys to `out` instead of arr
+ *
+ * Keys spanning a range no larger than their count are histogrammed
+ * instead (sv::group::countingGroup). Otherwise the negatives and the
+ * positives are sorted as in radixSort; the last digit pass of each
+ * leaves its keys in a scratch buffer, and they go from there straight
+ * to the emitter: negatives from the back, then positives. Nothing is written to arr except through the emitter.
+ *
+ * @return false when Ops::advance asked the sort to stop (arr unchanged)
+ */
+template <class Ops = sv::ops::NoCounting>
+bool radixGroup(vector<int>& arr, int base, sv::group::Emitter& out,
+                sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    size_t n = arr.size();
+    if (n == 0) return true;
+    auto [lo, hi] = sv::group::minMax(arr.data(), n);
+    if (sv::group::countingGroup(arr.data(), n, lo, hi, out, ws)) {
+        Ops::scratch(n);
+        return Ops::advance(0, 0);
+    }
+
+    size_t nNeg = count_if(arr.begin(), arr.end(), [](int num) { return num < 0; });
+    size_t nPos = n - nNeg;
+    sv::SortWorkspace::Scope scope(ws);
+    int* negs = ws.take<int>(nNeg);
+    int* poss = ws.take<int>(nPos);
+    int* last = ws.take<int>(max(nNeg, nPos));
+    size_t ni = 0, pi = 0;
+    for (int num : arr) {
+        if (num < 0)
+            negs[ni++] = num;  // Sorted by magnitude, INT_MIN included
+        else
+            poss[pi++] = num;
+    }
+    Ops::scratch(n);
+
+    uint32_t maxNeg = lo < 0 ? magnitude(lo) : 0;
+    uint32_t maxPos = hi > 0 ? magnitude(hi) : 0;
+    if (!Ops::advance(0, nPos * digitPasses(maxPos, base) + nNeg * digitPasses(maxNeg, base)))
+        return false;
+
+    // Largest magnitude first, i.e. ascending
+    if (nNeg > 0) {
+        const int* sorted = radixPasses<Ops>(negs, last, nNeg, maxNeg, base, ws);
+        if (!sorted) return false;
+        for (size_t i = nNeg; i-- > 0;)
+            out.add(sorted[i]);
+    }
+    if (nPos > 0) {
+        const int* sorted = radixPasses<Ops>(poss, last, nPos, maxPos, base, ws);
+        if (!sorted) return false;
+        out.add(sorted, nPos);
+    }
+    return true;
+}
+
+/**
+ * @brief Sorts arr and removes duplicate keys in the same pass
+ *
+ * @return Number of distinct keys; arr is resized to hold exactly them
+ */
+template <class Ops = sv::ops::NoCounting>
+size_t radixSortUnique(vector<int>& arr, int base = 10,
+                       sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    sv::group::Emitter out(arr.data());
+    if (!radixGroup<Ops>(arr, base, out, ws)) return arr.size();
+    arr.resize(out.size());
+    for (size_t i = 0; i < arr.size(); ++i)
+        Ops::write(i, arr[i]);
+    return arr.size();
+}
+
+/**
+ * @brief Sorts arr and counts every key (group by key)
+ *
+ * @return counts[i] is the number of times arr[i] occurred; arr is resized
+ *         to its distinct keys in ascending order. Cancelled: empty, and
+ *         arr is unchanged
+ */
+template <class Ops = sv::ops::NoCounting>
+vector<size_t> radixSortCounts(vector<int>& arr, int base = 10,
+                               sv::SortWorkspace& ws = sv::SortWorkspace::thisThread()) {
+    vector<size_t> counts;
+    sv::group::Emitter out(arr.data(), &counts);
+    if (!radixGroup<Ops>(arr, base, out, ws)) return {};
+    arr.resize(out.size());
+    for (size_t i = 0; i < arr.size(); ++i)
+        Ops::write(i, arr[i]);
+    return counts;
 }
 
 
@@ -109,5 +318,33 @@ int main() {
     for (int num : arr) cout << num << " ";
     cout << "\n";
 
+    // INT_MIN has no positive counterpart; it must sort without negation
+    for (int base : {10, 2, 256}) {
+        vector<int> extremes = {0, INT_MAX, -1, INT_MIN, 7, INT_MIN + 1, -7, INT_MIN};
+        radixSort(extremes, base);
+        assert(extremes == vector<int>({INT_MIN, INT_MIN, INT_MIN + 1, -7, -1, 0, 7, INT_MAX}));
+
+        // The range is too wide for the counting path, so these take the digit passes
+        vector<int> distinct = {0, INT_MAX, -1, INT_MIN, 7, INT_MIN + 1, -7, INT_MIN, -1};
+        vector<int> grouped = distinct;
+        assert(radixSortUnique(distinct, base) == 7);
+        assert(distinct == vector<int>({INT_MIN, INT_MIN + 1, -7, -1, 0, 7, INT_MAX}));
+        assert(radixSortCounts(grouped, base) == vector<size_t>({2, 1, 1, 2, 1, 1, 1}));
+        assert(grouped == distinct);
+    }
+
+    // Fused modes: distinct keys, and each key with its count
+    vector<int> keys = {170, -45, 75, -45, 802, 75, 2, 75, 170, -90};
+    vector<int> unique = keys;
+    radixSortUnique(unique);
+    cout << "\nDistinct keys:\n";
+    for (int num : unique) cout << num << " ";
+    cout << "\n";
+
+    vector<size_t> counts = radixSortCounts(keys);
+    cout << "\nKey counts:\n";
+    for (size_t i = 0; i < keys.size(); ++i) cout << keys[i] << "x" << counts[i] << " ";
+    cout << "\n";
+
     return 0;
 }
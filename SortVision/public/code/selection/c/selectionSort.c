@@ -1,9 +1,10 @@
+#include <stddef.h>
 #include <stdio.h>
 
 // Function to find the index of the minimum element in the array from start to end
-int findMinIndex(int arr[], int start, int end) {
-    int minIndex = start;
-    for (int i = start + 1; i <= end; i++) {
+size_t findMinIndex(int arr[], size_t start, size_t end) {
+    size_t minIndex = start;
+    for (size_t i = start + 1; i <= end; i++) {
         if (arr[i] < arr[minIndex]) {
             minIndex = i;
         }
@@ -12,10 +13,10 @@ int findMinIndex(int arr[], int start, int end) {
 }
 
 // Function to perform Selection Sort
-void selectionSort(int arr[], int n) {
-    for (int i = 0; i < n - 1; i++) {
+void selectionSort(int arr[], size_t n) {
+    for (size_t i = 0; i + 1 < n; i++) {
         // Find the index of the minimum element in the unsorted part
-        int minIndex = findMinIndex(arr, i, n - 1);
+        size_t minIndex = findMinIndex(arr, i, n - 1);
 
         // Swap the found minimum element with the current element
         if (minIndex != i) {
@@ -27,8 +28,8 @@ void selectionSort(int arr[], int n) {
 }
 
 // Function to print the array
-void printArray(int arr[], int n) {
-    for (int i = 0; i < n; i++)
+void printArray(int arr[], size_t n) {
+    for (size_t i = 0; i < n; i++)
         printf("%d ", arr[i]);
     printf("\n");
 }
@@ -1,17 +1,38 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../common/cpp/opCounters.hpp"
+#include "../../common/cpp/simdScan.hpp"
+#include "../../common/cpp/sortControl.hpp"
+
 using namespace std;
 
 /*
  * Find the index of the minimum element in arr[start ... end-1]
  * Time complexity: O(n)
+ * Ops: operation-counting policy (see opCounters.hpp)
+ * Without instrumentation this is a SIMD scan (simdScan.hpp) for the
+ * widest instruction set the CPU has; ties keep the first index either way
  */
-int findMinIndex(const vector<int> &arr, int start, int end)
+template <class Ops = sv::ops::NoCounting>
+size_t findMinIndex(const vector<int> &arr, size_t start, size_t end)
 {
-    int minIdx = start;
-    for (int i = start + 1; i < end; ++i)
+    if constexpr (!Ops::enabled)
+        return start + sv::simd::minIndex(arr.data() + start, end - start);
+    size_t minIdx = start;
+    for (size_t i = start + 1; i < end; ++i)
     {
+        Ops::compare(i, minIdx);
         if (arr[i] < arr[minIdx])
         {
             minIdx = i;
@@ -24,11 +45,15 @@ int findMinIndex(const vector<int> &arr, int start, int end)
  * Find the index of the maximum element in arr[start ... end-1]
  * Used in bidirectional selection sort
  */
-int findMaxIndex(const vector<int> &arr, int start, int end)
+template <class Ops = sv::ops::NoCounting>
+size_t findMaxIndex(const vector<int> &arr, size_t start, size_t end)
 {
-    int maxIdx = start;
-    for (int i = start + 1; i < end; ++i)
+    if constexpr (!Ops::enabled)
+        return start + sv::simd::maxIndex(arr.data() + start, end - start);
+    size_t maxIdx = start;
+    for (size_t i = start + 1; i < end; ++i)
     {
+        Ops::compare(i, maxIdx);
         if (arr[i] > arr[maxIdx])
         {
             maxIdx = i;
@@ -41,14 +66,21 @@ int findMaxIndex(const vector<int> &arr, int start, int end)
  * Classic Selection Sort
  * Time complexity: O(n^2)
  * Space complexity: O(1)
+ * Progress is reported per pass, in elements scanned (n(n-1)/2 in total)
  */
+template <class Ops = sv::ops::NoCounting>
 void selectionSort(vector<int> &arr)
 {
-    int n = arr.size();
-    for (int i = 0; i < n - 1; ++i)
+    size_t n = arr.size();
+    if (!Ops::advance(0, n < 2 ? 0 : n * (n - 1) / 2))
+        return;
+    for (size_t i = 0; i + 1 < n; ++i)
     {
-        int minIdx = findMinIndex(arr, i, n);
+        size_t minIdx = findMinIndex<Ops>(arr, i, n);
+        Ops::swap(i, minIdx);
         swap(arr[i], arr[minIdx]);
+        if (!Ops::advance(n - i - 1, 0))
+            return;
     }
 }
 
@@ -57,23 +89,37 @@ void selectionSort(vector<int> &arr)
  * Time complexity: O(n^2)
  * Slightly reduces the number of iterations by sorting from both ends
  */
+template <class Ops = sv::ops::NoCounting>
 void bidirectionalSelectionSort(vector<int> &arr)
 {
-    int left = 0, right = arr.size() - 1;
+    // Signed: right starts at -1 for an empty array
+    ptrdiff_t left = 0, right = static_cast<ptrdiff_t>(arr.size()) - 1;
 
     while (left < right)
     {
-        int minIdx = left, maxIdx = left;
+        ptrdiff_t minIdx = left, maxIdx = left;
 
-        for (int i = left; i <= right; ++i)
+        if constexpr (!Ops::enabled)
+        {
+            // Two SIMD scans beat one scalar pass
+            minIdx = static_cast<ptrdiff_t>(findMinIndex(arr, left, right + 1));
+            maxIdx = static_cast<ptrdiff_t>(findMaxIndex(arr, left, right + 1));
+        }
+        else
         {
-            if (arr[i] < arr[minIdx])
-                minIdx = i;
-            if (arr[i] > arr[maxIdx])
-                maxIdx = i;
+            for (ptrdiff_t i = left; i <= right; ++i)
+            {
+                Ops::compare(i, minIdx);
+                if (arr[i] < arr[minIdx])
+                    minIdx = i;
+                Ops::compare(i, maxIdx);
+                if (arr[i] > arr[maxIdx])
+                    maxIdx = i;
+            }
         }
 
         // Swap minimum with leftmost
+        Ops::swap(left, minIdx);
         swap(arr[left], arr[minIdx]);
 
         // If the max was at the left position, it is now at minIdx
@@ -81,6 +127,7 @@ void bidirectionalSelectionSort(vector<int> &arr)
             maxIdx = minIdx;
 
         // Swap maximum with rightmost
+        Ops::swap(right, maxIdx);
         swap(arr[right], arr[maxIdx]);
 
         ++left;
@@ -88,6 +135,277 @@ void bidirectionalSelectionSort(vector<int> &arr)
     }
 }
 
+/*
+ * Tournament Tree (loser tree) for repeated minimum selection
+ * Build: O(n) with n - 1 comparisons
+ * Each extraction: O(log n), replays a single leaf-to-root path
+ *
+ * Internal node i stores the loser of the match played there, node 0
+ * stores the overall winner. Leaves are the input positions; an
+ * extracted leaf is marked exhausted and loses every later match.
+ * Ties are broken by position, so extraction order is stable.
+ * Ops: every match between two live leaves counts as one comparison of
+ * their input positions; copying the keys counts as n scratch moves.
+ */
+template <class Ops = sv::ops::NoCounting>
+class TournamentTree
+{
+public:
+    explicit TournamentTree(const vector<int> &arr)
+        : keys(arr), exhausted(arr.size(), false), tree(arr.size() == 0 ? 1 : arr.size()),
+          leaves(arr.size()), left(arr.size())
+    {
+        if (leaves == 0)
+            return;
+        Ops::scratch(leaves);
+
+        // Play all matches bottom-up; winners[] is only needed while building
+        vector<size_t> winners(2 * leaves);
+        for (size_t i = 0; i < leaves; ++i)
+            winners[leaves + i] = i;
+        for (size_t node = leaves - 1; node >= 1; --node)
+        {
+            size_t a = winners[2 * node], b = winners[2 * node + 1];
+            bool aWins = beats(a, b);
+            winners[node] = aWins ? a : b;
+            tree[node] = aWins ? b : a;
+        }
+        tree[0] = winners[1];
+    }
+
+    bool empty() const { return left == 0; }
+    size_t remaining() const { return left; }
+
+    /*
+     * Remove and return the smallest remaining element
+     * Precondition: !empty()
+     */
+    int next()
+    {
+        size_t winner = tree[0];
+        int value = keys[winner];
+        exhausted[winner] = true;
+        --left;
+
+        // Replay the matches on the path from the winner's leaf to the root
+        size_t current = winner;
+        for (size_t node = (winner + leaves) / 2; node >= 1; node /= 2)
+        {
+            if (beats(tree[node], current))
+                swap(tree[node], current);
+        }
+        tree[0] = current;
+        return value;
+    }
+
+    /*
+     * Copy the keys not extracted yet to out[], in input order
+     */
+    void copyRemaining(int *out) const
+    {
+        for (size_t i = 0; i < leaves; ++i)
+            if (!exhausted[i])
+                *out++ = keys[i];
+    }
+
+private:
+    bool beats(size_t a, size_t b) const
+    {
+        if (exhausted[a] || exhausted[b])
+            return !exhausted[a];
+        Ops::compare(a, b);
+        if (keys[a] != keys[b])
+            return keys[a] < keys[b];
+        return a < b;
+    }
+
+    vector<int> keys;
+    vector<bool> exhausted;
+    vector<size_t> tree;
+    size_t leaves;
+    size_t left;
+};
+
+/*
+ * Tournament Sort
+ * Time complexity: O(n log n) comparisons
+ * Space complexity: O(n)
+ * Progress is reported every 1024 extractions (n in total)
+ */
+template <class Ops = sv::ops::NoCounting>
+void tournamentSort(vector<int> &arr)
+{
+    size_t n = arr.size();
+    if (!Ops::advance(0, n))
+        return;
+    TournamentTree<Ops> tournament(arr);
+    size_t reported = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        int value = tournament.next();
+        Ops::write(i, value);
+        arr[i] = value;
+        if (((i + 1) & 1023) == 0)
+        {
+            if (!Ops::advance(i + 1 - reported, 0))
+            {
+                // Keep every key: the unextracted ones go after the prefix
+                tournament.copyRemaining(arr.data() + i + 1);
+                return;
+            }
+            reported = i + 1;
+        }
+    }
+    Ops::advance(n - reported, 0);
+}
+
+/*
+ * Return the k smallest elements in ascending order
+ * Stops the tournament early: O(n + k log n) comparisons
+ */
+template <class Ops = sv::ops::NoCounting>
+vector<int> smallestK(const vector<int> &arr, size_t k)
+{
+    TournamentTree<Ops> tournament(arr);
+    vector<int> result;
+    result.reserve(min(k, arr.size()));
+    while (result.size() < k && !tournament.empty())
+        result.push_back(tournament.next());
+    return result;
+}
+
+/*
+ * Cycle Sort (write-minimizing selection)
+ * Time complexity: O(n^2) reads/comparisons
+ * Space complexity: O(1)
+ *
+ * Each element is written at most once, straight into its final slot, so
+ * the number of writes equals the number of misplaced elements (<= n).
+ * A classic selection sort swap costs two writes per misplaced element.
+ * Use this when writes are far more expensive than reads, e.g. records on
+ * persistent memory or a flash-backed memory mapping.
+ *
+ * Returns the number of element writes performed on data[].
+ * Ops: the item in hand is compared as position `start`, the slot it is
+ * taken from; each store into data[] is one write. Progress is reported
+ * per cycle start (n - 1 in total); a cancelled sort stops between two
+ * cycles, so data[] still holds every key.
+ */
+template <class Ops = sv::ops::NoCounting, typename T>
+size_t cycleSort(T *data, size_t n)
+{
+    size_t writes = 0;
+    if (!Ops::advance(0, n < 2 ? 0 : n - 1))
+        return writes;
+
+    for (size_t start = 0; start + 1 < n; ++start)
+    {
+        T item = data[start];
+
+        // Final position of item = start + number of smaller elements after it
+        size_t pos = start;
+        for (size_t i = start + 1; i < n; ++i)
+        {
+            Ops::compare(i, start);
+            if (data[i] < item)
+                ++pos;
+        }
+
+        // Already in place: no write at all
+        if (pos == start)
+        {
+            if (!Ops::advance(1, 0))
+                return writes;
+            continue;
+        }
+
+        // Skip over equal keys that are already placed
+        while ((Ops::compare(pos, start), item == data[pos]))
+            ++pos;
+        Ops::write(pos, item);
+        swap(item, data[pos]);
+        ++writes;
+
+        // Rotate the rest of the cycle until we return to start
+        while (pos != start)
+        {
+            pos = start;
+            for (size_t i = start + 1; i < n; ++i)
+            {
+                Ops::compare(i, start);
+                if (data[i] < item)
+                    ++pos;
+            }
+
+            while ((Ops::compare(pos, start), item == data[pos]))
+                ++pos;
+            Ops::write(pos, item);
+            swap(item, data[pos]);
+            ++writes;
+        }
+        if (!Ops::advance(1, 0))
+            return writes;
+    }
+    return writes;
+}
+
+/*
+ * Cycle sort wrapper for vectors
+ * Returns the number of element writes performed
+ */
+template <class Ops = sv::ops::NoCounting>
+size_t cycleSort(vector<int> &arr)
+{
+    return cycleSort<Ops>(arr.data(), arr.size());
+}
+
+/*
+ * Sort a file of native-endian int32 records in place through a shared
+ * memory mapping. Elements are written directly into the mapped region
+ * (at most one store per record) and flushed with msync().
+ *
+ * Returns the number of element writes, or -1 on error (errno is set).
+ */
+long long cycleSortMappedFile(const char *path)
+{
+    int fd = open(path, O_RDWR);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    int err = 0;
+    if (fstat(fd, &st) < 0)
+        err = errno;
+    else if (st.st_size % sizeof(int32_t) != 0)
+        err = EINVAL;  // not a whole number of records
+    if (err != 0)
+    {
+        close(fd);
+        errno = err;
+        return -1;
+    }
+
+    size_t n = st.st_size / sizeof(int32_t);
+    if (n == 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    void *region = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED)
+        return -1;
+
+    size_t writes = cycleSort(static_cast<int32_t *>(region), n);
+
+    int rc = msync(region, st.st_size, MS_SYNC);
+    err = errno;
+    munmap(region, st.st_size);
+    errno = err;
+    return rc == 0 ? static_cast<long long>(writes) : -1;
+}
+
 /*
  * Utility function to print array
  */
@@ -118,6 +436,16 @@ void runTests()
         selectionSort(arr);
         assert(arr == vector<int>({1, 2, 4, 5, 8}));
     }
+    {
+        // n(n-1)/2 comparisons and n-1 swaps regardless of input order
+        vector<int> arr = {5, 1, 4, 2, 8};
+        sv::ops::Counting::reset();
+        selectionSort<sv::ops::Counting>(arr);
+        sv::ops::OpCounts ops = sv::ops::Counting::thisThread();
+        assert(arr == vector<int>({1, 2, 4, 5, 8}));
+        assert(ops.comparisons == 10);
+        assert(ops.swaps == 4);
+    }
     {
         vector<int> arr = {9, 7, 5, 3, 1};
         bidirectionalSelectionSort(arr);
@@ -128,6 +456,87 @@ void runTests()
         bidirectionalSelectionSort(arr);
         assert(arr == vector<int>({1, 2, 3, 4, 5}));
     }
+    {
+        vector<int> arr = {7, -2, 9, 7, 0, 3, -2, 11, 5};
+        tournamentSort(arr);
+        assert(arr == vector<int>({-2, -2, 0, 3, 5, 7, 7, 9, 11}));
+    }
+    {
+        vector<int> arr = {};
+        tournamentSort(arr);
+        assert(arr.empty());
+    }
+    {
+        vector<int> arr = {8, 3, 6, 1, 9, 2};
+        assert(smallestK(arr, 3) == vector<int>({1, 2, 3}));
+        assert(smallestK(arr, 10) == vector<int>({1, 2, 3, 6, 8, 9}));
+        assert(smallestK(arr, 0).empty());
+    }
+    {
+        // Only the misplaced elements (5, 1, 2) are written
+        vector<int> arr = {5, 1, 4, 2, 8};
+        assert(cycleSort(arr) == 3);
+        assert(arr == vector<int>({1, 2, 4, 5, 8}));
+    }
+    {
+        vector<int> arr = {3, 1, 3, 2, 1, 3};
+        size_t writes = cycleSort(arr);
+        assert(arr == vector<int>({1, 1, 2, 3, 3, 3}));
+        assert(writes <= arr.size());
+    }
+    {
+        vector<int> arr = {1, 2, 3, 4, 5};
+        assert(cycleSort(arr) == 0);
+    }
+    {
+        // One write per misplaced element, reported through the policy too
+        vector<int> arr = {5, 1, 4, 2, 8};
+        sv::ops::Counting::reset();
+        assert(cycleSort<sv::ops::Counting>(arr) == 3);
+        sv::ops::OpCounts ops = sv::ops::Counting::thisThread();
+        assert(arr == vector<int>({1, 2, 4, 5, 8}));
+        assert(ops.moves == 3);
+        assert(ops.swaps == 0);
+    }
+    {
+        // Building a loser tree over n leaves plays n - 1 matches
+        vector<int> arr = {4, 3, 2, 1};
+        sv::ops::Counting::reset();
+        TournamentTree<sv::ops::Counting> tournament(arr);
+        assert(sv::ops::Counting::thisThread().comparisons == 3);
+        tournamentSort<sv::ops::Counting>(arr);
+        assert(arr == vector<int>({1, 2, 3, 4}));
+    }
+    {
+        // Sort records in place through a memory-mapped file
+        char path[] = "/tmp/selectionSortXXXXXX";
+        int fd = mkstemp(path);
+        assert(fd >= 0);
+        int32_t records[] = {9, -4, 7, 0, 7, 3};
+        assert(write(fd, records, sizeof(records)) == (ssize_t)sizeof(records));
+        close(fd);
+
+        assert(cycleSortMappedFile(path) == 5);
+
+        FILE *f = fopen(path, "rb");
+        assert(f != nullptr);
+        int32_t sorted[6];
+        assert(fread(sorted, sizeof(int32_t), 6, f) == 6);
+        fclose(f);
+        unlink(path);
+        assert(vector<int32_t>(sorted, sorted + 6) == vector<int32_t>({-4, 0, 3, 7, 7, 9}));
+    }
+    {
+        // A file that is not a whole number of records is rejected with EINVAL
+        char path[] = "/tmp/selectionSortXXXXXX";
+        int fd = mkstemp(path);
+        assert(fd >= 0);
+        assert(write(fd, "abcdef", 6) == 6);
+        close(fd);
+        errno = 0;
+        assert(cycleSortMappedFile(path) == -1 && errno == EINVAL);
+        unlink(path);
+    }
 
     cout << "✅ All test cases passed.\n";
 }
@@ -162,13 +571,20 @@ int main()
 
     if (!arr.empty())
     {
-        int minIdx = findMinIndex(arr, 0, arr.size());
-        int maxIdx = findMaxIndex(arr, 0, arr.size());
+        size_t minIdx = findMinIndex(arr, 0, arr.size());
+        size_t maxIdx = findMaxIndex(arr, 0, arr.size());
 
         cout << "\nIndex of Minimum Element: " << minIdx << " (Value: " << arr[minIdx] << ")\n";
         cout << "Index of Maximum Element: " << maxIdx << " (Value: " << arr[maxIdx] << ")\n";
     }
 
+    cout << "\nThree smallest elements (tournament tree):\n";
+    printArray(smallestK(arr, 3));
+
+    vector<int> cycleSorted = arr;
+    size_t writes = cycleSort(cycleSorted);
+    cout << "\nCycle Sort wrote " << writes << " of " << cycleSorted.size() << " elements\n";
+
     cout << "\nSorted array using Bidirectional Selection Sort:\n";
     bidirectionalSelectionSort(arr);
     printArray(arr);
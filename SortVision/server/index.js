@@ -5,6 +5,7 @@ import dotenv from 'dotenv';
 import fetch from 'node-fetch'; // For backend API call
 import { fileURLToPath } from 'url';
 import { dirname, join } from 'path';
+import { SortDaemonClient, SORT_OPS } from './sortDaemonClient.js';
 
 // Get the directory path of the current module
 const __filename = fileURLToPath(import.meta.url);
@@ -57,6 +58,50 @@ app.post('/api/gemini', async (req, res) => {
   }
 });
 
+// Optional native sorting backend: SORT_DAEMON is the sortDaemon socket path or localhost TCP port
+const sortDaemonAddress = process.env.SORT_DAEMON;
+let sortDaemon = null;
+
+function getSortDaemon() {
+  if (!sortDaemon) {
+    sortDaemon = new SortDaemonClient(/^\d+$/.test(sortDaemonAddress) ? Number(sortDaemonAddress) : sortDaemonAddress);
+    sortDaemon.socket.on('close', () => { sortDaemon = null; });
+  }
+  return sortDaemon;
+}
+
+app.post('/api/sort', async (req, res) => {
+  if (!sortDaemonAddress) {
+    return res.status(503).json({ error: 'SORT_DAEMON is not configured' });
+  }
+  const { array, algorithm = 'auto' } = req.body;
+  if (!Array.isArray(array) || !array.every((v) => Number.isInteger(v) && v >= -2147483648 && v <= 2147483647)) {
+    return res.status(400).json({ error: 'Expected array to be an array of 32-bit integers' });
+  }
+  if (!(algorithm in SORT_OPS)) {
+    return res.status(400).json({ error: `Unknown algorithm ${algorithm}` });
+  }
+
+  try {
+    const sorted = await getSortDaemon().sort(array, algorithm);
+    res.status(200).json({ array: Array.from(sorted) });
+  } catch (error) {
+    console.error('❌ Sort daemon error:', error);
+    res.status(502).json({ error: error.message });
+  }
+});
+
+app.get('/api/sort/stats', async (req, res) => {
+  if (!sortDaemonAddress) {
+    return res.status(503).json({ error: 'SORT_DAEMON is not configured' });
+  }
+  try {
+    res.type('text/plain').send(await getSortDaemon().stats());
+  } catch (error) {
+    res.status(502).json({ error: error.message });
+  }
+});
+
 const PORT = process.env.PORT || 3001;
 app.listen(PORT, () => {
   console.log(`✅ Gemini proxy server running on port ${PORT}`);
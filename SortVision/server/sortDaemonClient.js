@@ -0,0 +1,106 @@
+// server/sortDaemonClient.js
+// Client for the native sort daemon (native/daemon/sortDaemon.cpp).
+// Wire format: see native/daemon/protocol.hpp.
+import net from 'net';
+
+const REQUEST_MAGIC = 0x51535653; // "SVSQ"
+const RESPONSE_MAGIC = 0x52535653; // "SVSR"
+const HEADER_BYTES = 16;
+
+export const SORT_OPS = {
+  auto: 0,
+  quick: 1,
+  merge: 2,
+  heap: 3,
+  radix: 4,
+  insertion: 5,
+  selection: 6,
+  bubble: 7,
+};
+const STATS_OP = 0x80;
+
+const STATUS_TEXT = ['ok', 'bad magic', 'unknown algorithm', 'array too large'];
+
+/**
+ * One persistent connection to the daemon. Requests are pipelined and
+ * answered in order.
+ *
+ * @param {string|number} address Unix socket path, or localhost TCP port
+ */
+export class SortDaemonClient {
+  constructor(address) {
+    this.socket = typeof address === 'number'
+      ? net.connect({ host: '127.0.0.1', port: address })
+      : net.connect({ path: address });
+    this.socket.setNoDelay(true);
+    this.pending = [];
+    this.chunks = [];
+    this.buffered = 0;
+    this.socket.on('data', (chunk) => this.#onData(chunk));
+    this.socket.on('error', (error) => this.#failAll(error));
+    this.socket.on('close', () => this.#failAll(new Error('sort daemon connection closed')));
+  }
+
+  /**
+   * Sorts 32-bit integers.
+   * @param {Int32Array|number[]} values
+   * @param {string} algorithm key of SORT_OPS
+   * @returns {Promise<Int32Array>}
+   */
+  sort(values, algorithm = 'auto') {
+    const op = SORT_OPS[algorithm];
+    if (op === undefined) return Promise.reject(new Error(`unknown algorithm ${algorithm}`));
+    const keys = values instanceof Int32Array ? values : Int32Array.from(values);
+    return this.#request(op, keys).then((body) => new Int32Array(body.buffer, body.byteOffset, body.length / 4));
+  }
+
+  /** @returns {Promise<string>} latency histograms as text */
+  stats() {
+    return this.#request(STATS_OP, new Int32Array(0)).then((body) => body.toString('utf8'));
+  }
+
+  close() {
+    this.socket.end();
+  }
+
+  #request(op, keys) {
+    const header = Buffer.alloc(HEADER_BYTES);
+    header.writeUInt32LE(REQUEST_MAGIC, 0);
+    header.writeUInt8(op, 4);
+    header.writeBigUInt64LE(BigInt(keys.length), 8);
+    return new Promise((resolve, reject) => {
+      this.pending.push({ op, resolve, reject });
+      this.socket.write(header);
+      this.socket.write(Buffer.from(keys.buffer, keys.byteOffset, keys.byteLength));
+    });
+  }
+
+  #onData(chunk) {
+    this.chunks.push(chunk);
+    this.buffered += chunk.length;
+    while (this.buffered >= HEADER_BYTES) {
+      const data = this.chunks.length === 1 ? this.chunks[0] : Buffer.concat(this.chunks);
+      this.chunks = [data];
+      const status = data.readUInt32LE(4);
+      const count = Number(data.readBigUInt64LE(8));
+      const request = this.pending[0];
+      const bodyBytes = status === 0 && request && request.op !== STATS_OP ? count * 4 : count;
+      if (data.length < HEADER_BYTES + bodyBytes) return;
+
+      this.pending.shift();
+      // Copy so the Int32Array is 4-byte aligned and independent of the stream buffer
+      const body = Buffer.from(data.subarray(HEADER_BYTES, HEADER_BYTES + bodyBytes));
+      const rest = data.subarray(HEADER_BYTES + bodyBytes);
+      this.chunks = rest.length ? [rest] : [];
+      this.buffered = rest.length;
+
+      if (data.readUInt32LE(0) !== RESPONSE_MAGIC) request?.reject(new Error('bad reply from sort daemon'));
+      else if (status !== 0) request?.reject(new Error(`sort daemon: ${STATUS_TEXT[status] ?? status}`));
+      else request?.resolve(body);
+    }
+  }
+
+  #failAll(error) {
+    for (const request of this.pending.splice(0)) request.reject(error);
+  }
+}